@@ -0,0 +1,67 @@
+# 빌드 시점에 리소스 파일(셰이더, 작은 텍스처)을 constexpr 바이트 배열로 변환해서 실행 파일에 포함시킨다
+# 이 파일은 CMakeLists.txt 에서 include 해서 embed_resources 함수를 쓰고,
+# 빌드 중에는 cmake -P 로 다시 실행되어 실제 변환을 한다
+
+if (CMAKE_SCRIPT_MODE_FILE)
+	# 스크립트 모드: RESOURCE_LIST_FILE 에 한 줄에 하나씩 적힌 ROOT 기준 상대 경로들을 OUTPUT 소스 파일로 변환
+	file(STRINGS ${RESOURCE_LIST_FILE} RESOURCES)
+	set(CONTENT "// embed_resources 가 자동으로 생성한 파일, 직접 수정하지 말 것\n#include \"EmbeddedResources.h\"\n\nnamespace\n{\n")
+	set(TABLE "")
+	set(INDEX 0)
+	foreach(RESOURCE ${RESOURCES})
+		file(READ ${ROOT}/${RESOURCE} HEX HEX)
+		string(LENGTH "${HEX}" HEX_LENGTH)
+		math(EXPR SIZE "${HEX_LENGTH} / 2")
+		string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," BYTES "${HEX}")
+		# 한 줄에 16 바이트씩 끊어서 생성된 파일을 읽을 수 있게 한다
+		string(REPEAT "0x[0-9a-f][0-9a-f]," 16 LINE_PATTERN)
+		string(REGEX REPLACE "(${LINE_PATTERN})" "\\1\n\t\t" BYTES "${BYTES}")
+		# 텍스트 리소스를 그대로 문자열로 쓸 수 있도록 끝에 0 을 하나 더 넣는다 (size 에는 포함하지 않음)
+		string(APPEND CONTENT "\t// ${RESOURCE}\n\tconstexpr unsigned char resource${INDEX}[] = {\n\t\t${BYTES}0x00\n\t};\n\n")
+		string(APPEND TABLE "\t{\"${RESOURCE}\", resource${INDEX}, ${SIZE}},\n")
+		math(EXPR INDEX "${INDEX} + 1")
+	endforeach()
+	string(APPEND CONTENT "}\n\nconst EmbeddedResource EMBEDDED_RESOURCES[] = {\n${TABLE}};\nconst size_t EMBEDDED_RESOURCE_COUNT = ${INDEX};\n")
+
+	# 내용이 같으면 다시 쓰지 않아서 불필요한 재컴파일을 막는다
+	set(PREVIOUS "")
+	if (EXISTS ${OUTPUT})
+		file(READ ${OUTPUT} PREVIOUS)
+	endif()
+	if (NOT "${PREVIOUS}" STREQUAL "${CONTENT}")
+		file(WRITE ${OUTPUT} "${CONTENT}")
+	endif()
+	return()
+endif()
+
+set(EMBED_RESOURCES_SCRIPT ${CMAKE_CURRENT_LIST_FILE})
+
+# embed_resources(<target> <파일>...) : 소스 디렉터리 기준 상대 경로의 파일들을 target 에 포함시킨다
+function(embed_resources TARGET)
+	set(OUTPUT ${CMAKE_CURRENT_BINARY_DIR}/embedded/EmbeddedResourceData.cpp)
+	set(INPUTS "")
+	foreach(RESOURCE ${ARGN})
+		list(APPEND INPUTS ${CMAKE_CURRENT_SOURCE_DIR}/${RESOURCE})
+	endforeach()
+	# 목록은 명령 인자로 넘기지 않고 파일로 넘긴다, 구분자가 셸이나 generator 에서 해석되지 않게 한다
+	# 목록이 같으면 다시 쓰지 않아서 설정할 때마다 리소스를 다시 생성하지 않게 한다
+	set(RESOURCE_LIST_FILE ${CMAKE_CURRENT_BINARY_DIR}/embedded/EmbeddedResourceList.txt)
+	string(REPLACE ";" "\n" RESOURCE_LIST "${ARGN}")
+	set(PREVIOUS_LIST "")
+	if (EXISTS ${RESOURCE_LIST_FILE})
+		file(READ ${RESOURCE_LIST_FILE} PREVIOUS_LIST)
+	endif()
+	if (NOT "${PREVIOUS_LIST}" STREQUAL "${RESOURCE_LIST}\n")
+		file(WRITE ${RESOURCE_LIST_FILE} "${RESOURCE_LIST}\n")
+	endif()
+
+	add_custom_command(
+		OUTPUT ${OUTPUT}
+		COMMAND ${CMAKE_COMMAND} -DOUTPUT=${OUTPUT} -DROOT=${CMAKE_CURRENT_SOURCE_DIR} -DRESOURCE_LIST_FILE=${RESOURCE_LIST_FILE} -P ${EMBED_RESOURCES_SCRIPT}
+		DEPENDS ${INPUTS} ${RESOURCE_LIST_FILE} ${EMBED_RESOURCES_SCRIPT}
+		COMMENT "Embedding resources into ${TARGET}"
+		VERBATIM
+		)
+	target_sources(${TARGET} PRIVATE ${OUTPUT})
+	target_include_directories(${TARGET} PRIVATE ${CMAKE_CURRENT_SOURCE_DIR}/src)
+endfunction()
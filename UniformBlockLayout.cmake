@@ -0,0 +1,135 @@
+# 셰이더 소스의 std140 uniform block 배치를 빌드 시점에 계산해서, 생성된 src/UniformBlocks.h 와 다르면 컴파일이 실패하게 한다
+# 셰이더만 고치고 --generate-uniform-blocks 로 헤더를 다시 만들지 않은 경우를 실행 전에 잡는다
+# 이 파일은 CMakeLists.txt 에서 include 해서 check_uniform_blocks 함수를 쓰고,
+# 빌드 중에는 cmake -P 로 다시 실행되어 실제 검사 소스를 만든다
+
+if (CMAKE_SCRIPT_MODE_FILE)
+	cmake_policy(VERSION 3.13)
+	string(REPLACE "," ";" SHADERS "${SHADER_LIST}")
+
+	# GLSL 타입의 std140 기준 정렬, 크기, 행렬 열 개수 (행렬이 아니면 0)
+	function(std140_type TYPE OUT_ALIGN OUT_SIZE OUT_COLUMNS)
+		set(COLUMNS 0)
+		if (TYPE MATCHES "^(float|int|uint|bool)$")
+			set(ALIGN 4)
+			set(SIZE 4)
+		elseif (TYPE MATCHES "^[iub]?vec([234])$")
+			set(SIZE 8)
+			set(ALIGN 8)
+			if (CMAKE_MATCH_1 EQUAL 3)
+				set(SIZE 12)
+				set(ALIGN 16)
+			elseif (CMAKE_MATCH_1 EQUAL 4)
+				set(SIZE 16)
+				set(ALIGN 16)
+			endif()
+		elseif (TYPE MATCHES "^mat([234])(x[234])?$")
+			# column_major 행렬은 열 벡터의 배열이므로 열마다 16바이트를 차지한다
+			set(COLUMNS ${CMAKE_MATCH_1})
+			math(EXPR SIZE "${COLUMNS} * 16")
+			set(ALIGN 16)
+		else()
+			message(FATAL_ERROR "${SHADER}: unsupported std140 member type '${TYPE}' in uniform block ${BLOCK}")
+		endif()
+		set(${OUT_ALIGN} ${ALIGN} PARENT_SCOPE)
+		set(${OUT_SIZE} ${SIZE} PARENT_SCOPE)
+		set(${OUT_COLUMNS} ${COLUMNS} PARENT_SCOPE)
+	endfunction()
+
+	set(CONTENT "// check_uniform_blocks 가 자동으로 생성한 파일, 직접 수정하지 말 것\n// 셰이더 소스에서 계산한 std140 배치와 UniformBlocks.h 가 다르면 컴파일이 실패한다, --generate-uniform-blocks 로 헤더를 다시 만든다\n#include \"UniformBlocks.h\"\n\n#include <cstddef>\n")
+	set(CHECKED_BLOCKS "")
+	foreach(SHADER ${SHADERS})
+		file(READ ${ROOT}/${SHADER} SOURCE)
+		# 주석 안의 선언은 무시한다
+		string(REGEX REPLACE "/\\*([^*]|\\*+[^*/])*\\*+/" " " SOURCE "${SOURCE}")
+		string(REGEX REPLACE "//[^\n]*" "" SOURCE "${SOURCE}")
+		# 찾은 선언이 CMake 목록 구분자에서 잘리지 않게 멤버 끝의 ; 를 | 로 바꿔둔다 (블록 선언 안에는 | 가 없다)
+		string(REPLACE ";" "|" SOURCE "${SOURCE}")
+		string(REGEX MATCHALL "layout[ \t\r\n]*\\([^)]*std140[^)]*\\)[ \t\r\n]*uniform[ \t\r\n]+[A-Za-z_][A-Za-z0-9_]*[ \t\r\n]*{[^}]*}" DECLARATIONS "${SOURCE}")
+		foreach(DECLARATION ${DECLARATIONS})
+			string(REGEX MATCH "uniform[ \t\r\n]+([A-Za-z_][A-Za-z0-9_]*)[ \t\r\n]*{([^}]*)}" UNUSED "${DECLARATION}")
+			set(BLOCK ${CMAKE_MATCH_1})
+			string(REGEX REPLACE "[ \t\r\n]+" " " BODY "${CMAKE_MATCH_2}")
+			# 한 블록을 여러 셰이더가 선언하면 한 번만 검사한다, GL 링크가 같은 이름 블록의 선언이 같은지 확인한다
+			if (BLOCK IN_LIST CHECKED_BLOCKS)
+				continue()
+			endif()
+			list(APPEND CHECKED_BLOCKS ${BLOCK})
+
+			set(ASSERTS "")
+			set(OFFSET 0)
+			set(INDEX 0)
+			# 본문은 ; (| 로 바꿔둔) 로 끝나는 멤버 선언들이다
+			string(REPLACE "|" ";" STATEMENTS "${BODY}")
+			foreach(STATEMENT ${STATEMENTS})
+				string(STRIP "${STATEMENT}" STATEMENT)
+				if (STATEMENT STREQUAL "")
+					continue()
+				endif()
+				if (NOT STATEMENT MATCHES "^((highp|mediump|lowp) )?([A-Za-z0-9_]+) (.+)$")
+					message(FATAL_ERROR "${SHADER}: could not parse member '${STATEMENT}' in uniform block ${BLOCK}")
+				endif()
+				set(TYPE ${CMAKE_MATCH_3})
+				string(REPLACE "," ";" DECLARATORS "${CMAKE_MATCH_4}")
+				std140_type(${TYPE} ALIGN SIZE COLUMNS)
+				foreach(DECLARATOR ${DECLARATORS})
+					string(STRIP "${DECLARATOR}" DECLARATOR)
+					if (NOT DECLARATOR MATCHES "^([A-Za-z_][A-Za-z0-9_]*) ?(\\[ ?([0-9]+) ?\\])?$")
+						message(FATAL_ERROR "${SHADER}: could not parse member '${DECLARATOR}' in uniform block ${BLOCK}")
+					endif()
+					set(NAME ${CMAKE_MATCH_1})
+					set(MEMBER_ALIGN ${ALIGN})
+					set(MEMBER_SIZE ${SIZE})
+					if (NOT CMAKE_MATCH_3 STREQUAL "")
+						# 배열 원소는 16바이트 배수로 늘어나고, 배열 자체도 16바이트로 정렬된다
+						math(EXPR MEMBER_SIZE "${CMAKE_MATCH_3} * ((${SIZE} + 15) / 16 * 16)")
+						set(MEMBER_ALIGN 16)
+					endif()
+					math(EXPR OFFSET "(${OFFSET} + ${MEMBER_ALIGN} - 1) / ${MEMBER_ALIGN} * ${MEMBER_ALIGN}")
+					string(APPEND ASSERTS "static_assert(offsetof(${BLOCK}, ${NAME}) == ${OFFSET}, \"${BLOCK}::${NAME} offset in ${SHADER} does not match UniformBlocks.h\");\n")
+					string(APPEND ASSERTS "static_assert(${BLOCK}::MEMBERS[${INDEX}].offset == ${OFFSET}, \"${BLOCK}::MEMBERS does not match ${SHADER}\");\n")
+					math(EXPR OFFSET "${OFFSET} + ${MEMBER_SIZE}")
+					math(EXPR INDEX "${INDEX} + 1")
+				endforeach()
+			endforeach()
+			# 블록 크기는 vec4 정렬(16바이트) 로 올린다
+			math(EXPR OFFSET "(${OFFSET} + 15) / 16 * 16")
+			string(APPEND CONTENT "\n// ${SHADER} : uniform block ${BLOCK} (${OFFSET} bytes)\n${ASSERTS}")
+			string(APPEND CONTENT "static_assert(sizeof(${BLOCK}::MEMBERS) / sizeof(${BLOCK}::MEMBERS[0]) == ${INDEX}, \"${BLOCK} member count in ${SHADER} does not match UniformBlocks.h\");\n")
+			string(APPEND CONTENT "static_assert(sizeof(${BLOCK}) == ${OFFSET}, \"${BLOCK} size in ${SHADER} does not match UniformBlocks.h\");\n")
+		endforeach()
+	endforeach()
+
+	# 내용이 같으면 다시 쓰지 않아서 불필요한 재컴파일을 막는다
+	set(PREVIOUS "")
+	if (EXISTS ${OUTPUT})
+		file(READ ${OUTPUT} PREVIOUS)
+	endif()
+	if (NOT "${PREVIOUS}" STREQUAL "${CONTENT}")
+		file(WRITE ${OUTPUT} "${CONTENT}")
+	endif()
+	return()
+endif()
+
+set(UNIFORM_BLOCK_LAYOUT_SCRIPT ${CMAKE_CURRENT_LIST_FILE})
+
+# check_uniform_blocks(<target> <셰이더>...) : 소스 디렉터리 기준 상대 경로의 셰이더에 선언된 std140 블록을 src/UniformBlocks.h 와 비교하는 소스를 target 에 추가한다
+function(check_uniform_blocks TARGET)
+	set(OUTPUT ${CMAKE_CURRENT_BINARY_DIR}/uniform_blocks/UniformBlockLayoutCheck.cpp)
+	set(INPUTS "")
+	foreach(SHADER ${ARGN})
+		list(APPEND INPUTS ${CMAKE_CURRENT_SOURCE_DIR}/${SHADER})
+	endforeach()
+	# 셰이더 경로에는 ; 가 없으므로 목록을 , 로 이어서 넘긴다
+	string(REPLACE ";" "," SHADER_LIST "${ARGN}")
+
+	add_custom_command(
+		OUTPUT ${OUTPUT}
+		COMMAND ${CMAKE_COMMAND} -DOUTPUT=${OUTPUT} -DROOT=${CMAKE_CURRENT_SOURCE_DIR} -DSHADER_LIST=${SHADER_LIST} -P ${UNIFORM_BLOCK_LAYOUT_SCRIPT}
+		DEPENDS ${INPUTS} ${UNIFORM_BLOCK_LAYOUT_SCRIPT}
+		COMMENT "Checking std140 uniform block layouts of ${TARGET}"
+		VERBATIM
+		)
+	target_sources(${TARGET} PRIVATE ${OUTPUT})
+	target_include_directories(${TARGET} PRIVATE ${CMAKE_CURRENT_SOURCE_DIR}/src)
+endfunction()
@@ -8,9 +8,20 @@ layout (location = 1) in vec2 aTexCoord;
 // fragment 셰이더에 전달될 색상 데이터와 텍스처 좌표 데이터
 out vec2 TexCoord;
 
+#ifdef INSTANCED_MODEL
+// GPU 컬링을 통과한 인스턴스의 모델 행렬, 인스턴스마다 하나씩(divisor 1) 읽는다 (location 2 ~ 5)
+layout (location = 2) in mat4 aModel;
+#define model aModel
+#else
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+#endif
+// 모든 셰이더가 공유하는 카메라 행렬, 프레임마다 uniform buffer 하나로 갱신한다
+// 멤버를 바꾸면 --generate-uniform-blocks 로 src/UniformBlocks.h 를 다시 만들어야 한다
+layout (std140) uniform CameraBlock
+{
+	mat4 view;
+	mat4 projection;
+};
 
 // 정점 셰이더의 메인 함수, 각 정점마다 전부 실행
 void main(void)
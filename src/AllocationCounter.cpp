@@ -0,0 +1,154 @@
+#include "AllocationCounter.h"
+
+#ifdef COUNT_ALLOCATIONS
+
+#include <cerrno>
+#include <cstdlib>
+#include <new>
+
+// glibc 에서는 malloc 계열도 바꿔서 C 라이브러리나 드라이버가 직접 부르는 malloc 까지 센다
+// 실제 할당은 glibc 가 내보내는 __libc_* 함수에 맡긴다
+#if defined(__GLIBC__)
+#define COUNT_MALLOC
+
+extern "C"
+{
+	void *__libc_malloc(size_t size);
+	void *__libc_calloc(size_t count, size_t size);
+	void *__libc_realloc(void *pointer, size_t size);
+	void *__libc_memalign(size_t alignment, size_t size);
+	void __libc_free(void *pointer);
+}
+#endif
+
+namespace
+{
+	thread_local unsigned long long threadAllocations = 0;
+
+	void *countedAllocate(std::size_t size)
+	{
+		threadAllocations++;
+		// malloc 을 바꿨으면 malloc 에서 한 번 더 세지 않도록 glibc 의 함수를 바로 부른다
+#ifdef COUNT_MALLOC
+		void *result = __libc_malloc(size != 0 ? size : 1);
+#else
+		void *result = std::malloc(size != 0 ? size : 1);
+#endif
+		if (result == NULL)
+		{
+			throw std::bad_alloc();
+		}
+		return (result);
+	}
+}
+
+#ifdef COUNT_MALLOC
+
+extern "C" void *malloc(size_t size)
+{
+	threadAllocations++;
+	return (__libc_malloc(size));
+}
+
+extern "C" void *calloc(size_t count, size_t size)
+{
+	threadAllocations++;
+	return (__libc_calloc(count, size));
+}
+
+// 크기를 바꾸는 것도 새 저장소를 잡을 수 있으므로 할당으로 센다, realloc(NULL, n) 은 malloc 과 같다
+extern "C" void *realloc(void *pointer, size_t size)
+{
+	threadAllocations++;
+	return (__libc_realloc(pointer, size));
+}
+
+extern "C" void *memalign(size_t alignment, size_t size)
+{
+	threadAllocations++;
+	return (__libc_memalign(alignment, size));
+}
+
+extern "C" void *aligned_alloc(size_t alignment, size_t size)
+{
+	threadAllocations++;
+	return (__libc_memalign(alignment, size));
+}
+
+extern "C" int posix_memalign(void **result, size_t alignment, size_t size)
+{
+	if (alignment % sizeof(void *) != 0 || (alignment & (alignment - 1)) != 0)
+	{
+		return (EINVAL);
+	}
+	threadAllocations++;
+	void *pointer = __libc_memalign(alignment, size);
+	if (pointer == NULL)
+	{
+		return (ENOMEM);
+	}
+	*result = pointer;
+	return (0);
+}
+
+extern "C" void free(void *pointer)
+{
+	__libc_free(pointer);
+}
+
+#endif
+
+// 정렬 지정(align_val_t) 버전과 nothrow 버전은 표준 라이브러리 기본 구현을 쓴다, nothrow 버전은 아래 함수를 거친다
+void *operator new(std::size_t size)
+{
+	return (countedAllocate(size));
+}
+
+void *operator new[](std::size_t size)
+{
+	return (countedAllocate(size));
+}
+
+void operator delete(void *pointer) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete[](void *pointer, std::size_t) noexcept
+{
+	std::free(pointer);
+}
+
+bool isAllocationCountingEnabled()
+{
+	return (true);
+}
+
+unsigned long long getThreadAllocationCount()
+{
+	return (threadAllocations);
+}
+
+#else
+
+bool isAllocationCountingEnabled()
+{
+	return (false);
+}
+
+unsigned long long getThreadAllocationCount()
+{
+	return (0);
+}
+
+#endif
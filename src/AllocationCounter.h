@@ -0,0 +1,10 @@
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+
+// COUNT_ALLOCATIONS 로 빌드하면 전역 operator new 를 (glibc 에서는 malloc 계열도) 바꿔서 스레드마다 힙 할당 횟수를 센다
+// 프레임 루프 구간의 횟수를 비교해서 정상 상태에서 할당이 없는지 확인하는 데 쓴다
+bool isAllocationCountingEnabled();
+// 호출한 스레드가 지금까지 operator new 나 malloc / calloc / realloc / 정렬 할당 함수를 부른 횟수, 꺼져 있으면 0
+unsigned long long getThreadAllocationCount();
+
+#endif
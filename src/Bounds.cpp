@@ -0,0 +1,145 @@
+#include "Bounds.h"
+
+#include <algorithm>
+
+void Aabb::grow(const glm::vec3 &point)
+{
+	min = glm::min(min, point);
+	max = glm::max(max, point);
+}
+
+void Aabb::grow(const Aabb &other)
+{
+	min = glm::min(min, other.min);
+	max = glm::max(max, other.max);
+}
+
+glm::vec3 Aabb::center() const
+{
+	return ((min + max) * 0.5f);
+}
+
+glm::vec3 Aabb::extent() const
+{
+	return (max - min);
+}
+
+float Aabb::surfaceArea() const
+{
+	if (empty())
+	{
+		return (0.0f);
+	}
+	glm::vec3 e = extent();
+	return (2.0f * (e.x * e.y + e.y * e.z + e.z * e.x));
+}
+
+bool Aabb::empty() const
+{
+	return (min.x > max.x || min.y > max.y || min.z > max.z);
+}
+
+Aabb sphereBounds(const glm::vec3 &center, float radius)
+{
+	Aabb box;
+	box.min = center - glm::vec3(radius);
+	box.max = center + glm::vec3(radius);
+	return (box);
+}
+
+Frustum Frustum::fromMatrix(const glm::mat4 &m)
+{
+	Frustum frustum;
+	// glm 은 열 우선(column-major) 이므로 m[column][row], 각 평면은 4번째 행과 다른 행의 합/차
+	for (int i = 0; i < 3; i++)
+	{
+		frustum.planes[i * 2] = glm::vec4(m[0][3] + m[0][i], m[1][3] + m[1][i], m[2][3] + m[2][i], m[3][3] + m[3][i]);
+		frustum.planes[i * 2 + 1] = glm::vec4(m[0][3] - m[0][i], m[1][3] - m[1][i], m[2][3] - m[2][i], m[3][3] - m[3][i]);
+	}
+	for (glm::vec4 &plane : frustum.planes)
+	{
+		float length = glm::length(glm::vec3(plane.x, plane.y, plane.z));
+		plane = plane / length;
+	}
+	return (frustum);
+}
+
+Frustum Frustum::translated(const glm::dvec3 &origin) const
+{
+	// 카메라 기준 좌표 p = x - origin 이므로 n·p + d = n·x + (d - n·origin)
+	Frustum frustum;
+	for (int i = 0; i < 6; i++)
+	{
+		const glm::vec4 &plane = planes[i];
+		double distance = (double)plane.w - ((double)plane.x * origin.x + (double)plane.y * origin.y + (double)plane.z * origin.z);
+		frustum.planes[i] = glm::vec4(plane.x, plane.y, plane.z, (float)distance);
+	}
+	return (frustum);
+}
+
+Containment Frustum::classify(const Aabb &box, unsigned int &planeMask) const
+{
+	glm::vec3 center = box.center();
+	glm::vec3 halfExtent = box.extent() * 0.5f;
+	for (int i = 0; i < 6; i++)
+	{
+		unsigned int bit = 1u << i;
+		if ((planeMask & bit) == 0)
+		{
+			continue;
+		}
+		const glm::vec4 &plane = planes[i];
+		// 박스 중심의 부호 있는 거리와, 평면 법선 방향으로 투영한 박스의 반지름을 비교한다
+		float distance = plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w;
+		float radius = std::abs(plane.x) * halfExtent.x + std::abs(plane.y) * halfExtent.y + std::abs(plane.z) * halfExtent.z;
+		if (distance < -radius)
+		{
+			return (Containment::OUTSIDE);
+		}
+		if (distance >= radius)
+		{
+			planeMask &= ~bit;
+		}
+	}
+	return (planeMask == 0 ? Containment::INSIDE : Containment::INTERSECTS);
+}
+
+bool Frustum::intersects(const Aabb &box) const
+{
+	unsigned int planeMask = FRUSTUM_ALL_PLANES;
+	return (classify(box, planeMask) != Containment::OUTSIDE);
+}
+
+bool Frustum::intersectsSphere(const glm::vec3 &center, float radius) const
+{
+	for (const glm::vec4 &plane : planes)
+	{
+		if (plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w < -radius)
+		{
+			return (false);
+		}
+	}
+	return (true);
+}
+
+Ray::Ray(const glm::vec3 &origin, const glm::vec3 &direction) : origin(origin), direction(direction)
+{
+	// 0 으로 나누면 무한대가 되고, 슬랩 검사는 무한대에서도 올바르게 동작한다
+	inverseDirection = glm::vec3(1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z);
+}
+
+bool intersectRay(const Ray &ray, const Aabb &box, float maxDistance, float &distance)
+{
+	glm::vec3 t0 = (box.min - ray.origin) * ray.inverseDirection;
+	glm::vec3 t1 = (box.max - ray.origin) * ray.inverseDirection;
+	glm::vec3 near = glm::min(t0, t1);
+	glm::vec3 far = glm::max(t0, t1);
+	float enter = std::max(std::max(near.x, near.y), std::max(near.z, 0.0f));
+	float exit = std::min(std::min(far.x, far.y), std::min(far.z, maxDistance));
+	if (enter > exit)
+	{
+		return (false);
+	}
+	distance = enter;
+	return (true);
+}
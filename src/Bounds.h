@@ -0,0 +1,65 @@
+#ifndef BOUNDS_H
+#define BOUNDS_H
+
+#include <glm/glm.hpp>
+
+#include <cfloat>
+
+// 축 정렬 바운딩 박스
+struct Aabb
+{
+	glm::vec3 min = glm::vec3(FLT_MAX);
+	glm::vec3 max = glm::vec3(-FLT_MAX);
+
+	void grow(const glm::vec3 &point);
+	void grow(const Aabb &other);
+	glm::vec3 center() const;
+	glm::vec3 extent() const;
+	// SAH 비용 계산에 사용하는 겉넓이, 비어 있으면 0
+	float surfaceArea() const;
+	bool empty() const;
+};
+
+// 중심과 반지름으로 만든, 구를 감싸는 박스 (회전해도 바뀌지 않는다)
+Aabb sphereBounds(const glm::vec3 &center, float radius);
+
+enum class Containment
+{
+	OUTSIDE,
+	INTERSECTS,
+	INSIDE,
+};
+
+// 평면 6개(left, right, bottom, top, near, far) 로 표현한 뷰 프러스텀, 법선은 안쪽을 향한다
+struct Frustum
+{
+	glm::vec4 planes[6];
+
+	// projection * view 행렬에서 평면을 뽑는다 (Gribb-Hartmann)
+	static Frustum fromMatrix(const glm::mat4 &viewProjection);
+	// 카메라 기준 좌표계의 프러스텀을 월드 좌표계로 옮긴다, 평면의 거리 항만 double 로 계산해서 정밀도를 유지한다
+	Frustum translated(const glm::dvec3 &origin) const;
+
+	// planeMask 의 비트가 켜진 평면만 검사한다. 박스가 그 평면 안쪽에 완전히 들어가면 비트를 끈다
+	// 부모 노드에서 완전히 통과한 평면은 자식에서 다시 검사할 필요가 없으므로, 계층 구조를 내려가면서 검사할 평면이 줄어든다
+	Containment classify(const Aabb &box, unsigned int &planeMask) const;
+	bool intersects(const Aabb &box) const;
+	bool intersectsSphere(const glm::vec3 &center, float radius) const;
+};
+
+const unsigned int FRUSTUM_ALL_PLANES = 0x3f;
+
+struct Ray
+{
+	glm::vec3 origin;
+	glm::vec3 direction;
+	// 1 / direction, 슬랩 검사에서 나눗셈 대신 곱셈을 쓰기 위해 미리 계산한다
+	glm::vec3 inverseDirection;
+
+	Ray(const glm::vec3 &origin, const glm::vec3 &direction);
+};
+
+// 광선이 박스와 [0, maxDistance] 안에서 만나면 진입 거리를 distance 에 넣고 true
+bool intersectRay(const Ray &ray, const Aabb &box, float maxDistance, float &distance);
+
+#endif
@@ -0,0 +1,344 @@
+#include "Bvh.h"
+
+#include <algorithm>
+#include <utility>
+
+void Bvh::clear()
+{
+	nodes.clear();
+	objectIndices.clear();
+	objectBounds.clear();
+	centroids.clear();
+}
+
+void Bvh::build(const std::vector<Aabb> &bounds)
+{
+	clear();
+	uint32_t objectCount = (uint32_t)bounds.size();
+	if (objectCount == 0)
+	{
+		return;
+	}
+	objectIndices.resize(objectCount);
+	centroids.resize(objectCount);
+	objectBounds = bounds;
+	for (uint32_t i = 0; i < objectCount; i++)
+	{
+		objectIndices[i] = i;
+		centroids[i] = bounds[i].center();
+	}
+	// 이진 트리의 노드 수는 2n - 1 을 넘지 않으므로 미리 잡아두면 빌드 중에 재할당이 없다
+	nodes.reserve(objectCount * 2);
+	BvhNode root;
+	root.leftFirst = 0;
+	root.count = objectCount;
+	nodes.push_back(root);
+	updateBounds(0);
+	// 분할할 때 번호와 함께 박스와 중심점도 옮기므로, 빌드 중에도 끝난 뒤에도 리프 순회는 메모리를 순서대로 읽는다
+	subdivide(0);
+	centroids.clear();
+	centroids.shrink_to_fit();
+}
+
+void Bvh::updateBounds(uint32_t nodeIndex)
+{
+	BvhNode &node = nodes[nodeIndex];
+	Aabb box;
+	for (uint32_t i = 0; i < node.count; i++)
+	{
+		box.grow(objectBounds[node.leftFirst + i]);
+	}
+	node.min = box.min;
+	node.max = box.max;
+}
+
+float Bvh::findSplit(const BvhNode &node, int &axis, float &splitPosition) const
+{
+	// 박스가 아니라 중심점의 범위를 나눈다, 그래야 모든 물체가 한쪽 구간에 들어간다
+	Aabb centroidBounds;
+	for (uint32_t i = 0; i < node.count; i++)
+	{
+		centroidBounds.grow(centroids[node.leftFirst + i]);
+	}
+
+	// 세 축을 한 번에 분류해서 물체 목록을 두 번만 읽는다
+	Aabb binBounds[3][BIN_COUNT];
+	uint32_t binCounts[3][BIN_COUNT] = {};
+	glm::vec3 range = centroidBounds.extent();
+	glm::vec3 scale;
+	for (int a = 0; a < 3; a++)
+	{
+		scale[a] = range[a] > 0.0f ? BIN_COUNT / range[a] : 0.0f;
+	}
+	for (uint32_t i = 0; i < node.count; i++)
+	{
+		const Aabb &box = objectBounds[node.leftFirst + i];
+		const glm::vec3 &centroid = centroids[node.leftFirst + i];
+		for (int a = 0; a < 3; a++)
+		{
+			int bin = std::min(BIN_COUNT - 1, (int)((centroid[a] - centroidBounds.min[a]) * scale[a]));
+			binCounts[a][bin]++;
+			binBounds[a][bin].grow(box);
+		}
+	}
+
+	float bestCost = FLT_MAX;
+	for (int a = 0; a < 3; a++)
+	{
+		if (range[a] <= 0.0f)
+		{
+			continue;
+		}
+		// 왼쪽에서 오른쪽, 오른쪽에서 왼쪽으로 누적해서 BIN_COUNT - 1 개 분할 평면의 비용을 한 번에 구한다
+		float leftArea[BIN_COUNT - 1];
+		float rightArea[BIN_COUNT - 1];
+		uint32_t leftCount[BIN_COUNT - 1];
+		uint32_t rightCount[BIN_COUNT - 1];
+		Aabb leftBox;
+		Aabb rightBox;
+		uint32_t leftSum = 0;
+		uint32_t rightSum = 0;
+		for (int i = 0; i < BIN_COUNT - 1; i++)
+		{
+			leftSum += binCounts[a][i];
+			leftCount[i] = leftSum;
+			leftBox.grow(binBounds[a][i]);
+			leftArea[i] = leftBox.surfaceArea();
+			rightSum += binCounts[a][BIN_COUNT - 1 - i];
+			rightCount[BIN_COUNT - 2 - i] = rightSum;
+			rightBox.grow(binBounds[a][BIN_COUNT - 1 - i]);
+			rightArea[BIN_COUNT - 2 - i] = rightBox.surfaceArea();
+		}
+		float binWidth = range[a] / BIN_COUNT;
+		for (int i = 0; i < BIN_COUNT - 1; i++)
+		{
+			float cost = leftCount[i] * leftArea[i] + rightCount[i] * rightArea[i];
+			if (leftCount[i] > 0 && rightCount[i] > 0 && cost < bestCost)
+			{
+				bestCost = cost;
+				axis = a;
+				splitPosition = centroidBounds.min[a] + binWidth * (i + 1);
+			}
+		}
+	}
+	return (bestCost);
+}
+
+void Bvh::subdivide(uint32_t nodeIndex)
+{
+	// 재귀 대신 명시적인 스택을 써서 100만 개 이상에서도 스택 깊이를 걱정하지 않는다
+	std::vector<std::pair<uint32_t, int>> pending;
+	pending.push_back(std::make_pair(nodeIndex, 1));
+	while (!pending.empty())
+	{
+		uint32_t current = pending.back().first;
+		int depth = pending.back().second;
+		pending.pop_back();
+		BvhNode node = nodes[current];
+		if (node.count <= MAX_LEAF_SIZE || depth >= MAX_DEPTH)
+		{
+			continue;
+		}
+
+		int axis = 0;
+		float splitPosition = 0.0f;
+		float splitCost = findSplit(node, axis, splitPosition);
+		// 나누지 않았을 때의 비용(물체 수 x 겉넓이) 보다 비싸면 리프로 남긴다
+		float leafCost = node.count * node.bounds().surfaceArea();
+		if (splitCost >= leafCost)
+		{
+			continue;
+		}
+
+		// [leftFirst, i) 는 분할 평면 왼쪽, [end, leftFirst + count) 는 오른쪽
+		uint32_t i = node.leftFirst;
+		uint32_t end = node.leftFirst + node.count;
+		while (i < end)
+		{
+			if (centroids[i][axis] < splitPosition)
+			{
+				i++;
+			}
+			else
+			{
+				end--;
+				std::swap(objectIndices[i], objectIndices[end]);
+				std::swap(objectBounds[i], objectBounds[end]);
+				std::swap(centroids[i], centroids[end]);
+			}
+		}
+		uint32_t leftCount = i - node.leftFirst;
+		if (leftCount == 0 || leftCount == node.count)
+		{
+			continue;
+		}
+
+		uint32_t leftChild = (uint32_t)nodes.size();
+		BvhNode left;
+		left.leftFirst = node.leftFirst;
+		left.count = leftCount;
+		BvhNode right;
+		right.leftFirst = i;
+		right.count = node.count - leftCount;
+		nodes.push_back(left);
+		nodes.push_back(right);
+		nodes[current].leftFirst = leftChild;
+		nodes[current].count = 0;
+		updateBounds(leftChild);
+		updateBounds(leftChild + 1);
+		pending.push_back(std::make_pair(leftChild + 1, depth + 1));
+		pending.push_back(std::make_pair(leftChild, depth + 1));
+	}
+}
+
+void Bvh::refit(const std::vector<Aabb> &bounds)
+{
+	for (size_t i = 0; i < objectIndices.size(); i++)
+	{
+		objectBounds[i] = bounds[objectIndices[i]];
+	}
+	// 자식은 항상 부모보다 뒤에 만들어지므로 뒤에서부터 계산하면 자식이 먼저 갱신된다
+	for (size_t n = nodes.size(); n-- > 0;)
+	{
+		BvhNode &node = nodes[n];
+		Aabb box;
+		if (node.isLeaf())
+		{
+			for (uint32_t i = 0; i < node.count; i++)
+			{
+				box.grow(objectBounds[node.leftFirst + i]);
+			}
+		}
+		else
+		{
+			box.grow(nodes[node.leftFirst].bounds());
+			box.grow(nodes[node.leftFirst + 1].bounds());
+		}
+		node.min = box.min;
+		node.max = box.max;
+	}
+}
+
+void Bvh::appendSubtree(uint32_t nodeIndex, std::vector<uint32_t> &visible) const
+{
+	// 자식이 부모의 objectIndices 구간을 그대로 나눠 가지므로, 서브트리의 물체는 연속된 구간이다
+	uint32_t first = nodeIndex;
+	uint32_t last = nodeIndex;
+	while (!nodes[first].isLeaf())
+	{
+		first = nodes[first].leftFirst;
+	}
+	while (!nodes[last].isLeaf())
+	{
+		last = nodes[last].leftFirst + 1;
+	}
+	visible.insert(visible.end(), objectIndices.begin() + nodes[first].leftFirst, objectIndices.begin() + nodes[last].leftFirst + nodes[last].count);
+}
+
+void Bvh::cullFrustum(const Frustum &frustum, std::vector<uint32_t> &visible) const
+{
+	if (nodes.empty())
+	{
+		return;
+	}
+	// 노드 번호와 아직 검사해야 하는 평면 마스크
+	std::pair<uint32_t, unsigned int> stack[MAX_DEPTH + 1];
+	int top = 0;
+	stack[top++] = std::make_pair(0u, FRUSTUM_ALL_PLANES);
+	while (top > 0)
+	{
+		uint32_t nodeIndex = stack[--top].first;
+		unsigned int planeMask = stack[top].second;
+		const BvhNode &node = nodes[nodeIndex];
+		Containment containment = frustum.classify(node.bounds(), planeMask);
+		if (containment == Containment::OUTSIDE)
+		{
+			continue;
+		}
+		if (containment == Containment::INSIDE)
+		{
+			appendSubtree(nodeIndex, visible);
+			continue;
+		}
+		if (node.isLeaf())
+		{
+			for (uint32_t i = 0; i < node.count; i++)
+			{
+				unsigned int objectMask = planeMask;
+				if (frustum.classify(objectBounds[node.leftFirst + i], objectMask) != Containment::OUTSIDE)
+				{
+					visible.push_back(objectIndices[node.leftFirst + i]);
+				}
+			}
+			continue;
+		}
+		stack[top++] = std::make_pair(node.leftFirst + 1, planeMask);
+		stack[top++] = std::make_pair(node.leftFirst, planeMask);
+	}
+}
+
+bool Bvh::raycast(const Ray &ray, float maxDistance, uint32_t &object, float &distance) const
+{
+	if (nodes.empty())
+	{
+		return (false);
+	}
+	bool hit = false;
+	float closest = maxDistance;
+	float entry;
+	if (!intersectRay(ray, nodes[0].bounds(), closest, entry))
+	{
+		return (false);
+	}
+	uint32_t stack[MAX_DEPTH + 1];
+	int top = 0;
+	stack[top++] = 0;
+	while (top > 0)
+	{
+		const BvhNode &node = nodes[stack[--top]];
+		if (node.isLeaf())
+		{
+			for (uint32_t i = 0; i < node.count; i++)
+			{
+				float t;
+				if (intersectRay(ray, objectBounds[node.leftFirst + i], closest, t))
+				{
+					hit = true;
+					closest = t;
+					object = objectIndices[node.leftFirst + i];
+				}
+			}
+			continue;
+		}
+		// 가까운 자식을 먼저 방문해야 closest 가 빨리 줄어들어서 먼 쪽 서브트리를 건너뛸 수 있다
+		uint32_t nearChild = node.leftFirst;
+		uint32_t farChild = node.leftFirst + 1;
+		float nearDistance;
+		float farDistance;
+		bool nearHit = intersectRay(ray, nodes[nearChild].bounds(), closest, nearDistance);
+		bool farHit = intersectRay(ray, nodes[farChild].bounds(), closest, farDistance);
+		if (nearHit && farHit && farDistance < nearDistance)
+		{
+			std::swap(nearChild, farChild);
+		}
+		else if (!nearHit)
+		{
+			nearChild = farChild;
+			nearHit = farHit;
+			farHit = false;
+		}
+		if (farHit)
+		{
+			stack[top++] = farChild;
+		}
+		if (nearHit)
+		{
+			stack[top++] = nearChild;
+		}
+	}
+	if (hit)
+	{
+		distance = closest;
+	}
+	return (hit);
+}
@@ -0,0 +1,83 @@
+#ifndef BVH_H
+#define BVH_H
+
+#include "Bounds.h"
+
+#include <cstdint>
+#include <vector>
+
+// 캐시 라인 하나에 두 개가 들어가는 32바이트 노드
+// 내부 노드는 leftFirst 가 왼쪽 자식 번호이고 오른쪽 자식은 바로 다음(leftFirst + 1) 에 있다
+// 리프 노드는 leftFirst 가 objectIndices 의 시작 위치, count 가 물체 수다. count 가 0 이면 내부 노드
+struct BvhNode
+{
+	glm::vec3 min;
+	uint32_t leftFirst;
+	glm::vec3 max;
+	uint32_t count;
+
+	bool isLeaf() const
+	{
+		return (count != 0);
+	}
+
+	Aabb bounds() const
+	{
+		Aabb box;
+		box.min = min;
+		box.max = max;
+		return (box);
+	}
+};
+
+// 물체의 AABB 위에 만드는 bounding volume hierarchy
+// 노드는 배열 하나에 깊이 우선 순서로 펼쳐져(flattened) 있어서 포인터를 따라가지 않고 순회한다
+class Bvh
+{
+	private:
+		// SAH 분할 후보를 찾을 때 축마다 나누는 구간(bin) 수
+		static const int BIN_COUNT = 16;
+		// 이 수 이하의 물체는 더 나누지 않고 리프로 둔다
+		static const uint32_t MAX_LEAF_SIZE = 4;
+		// 순회 스택을 고정 크기 배열로 쓰기 위한 최대 깊이, 넘어가는 노드는 물체가 많아도 리프로 남긴다
+		static const int MAX_DEPTH = 64;
+
+		std::vector<BvhNode> nodes;
+		// 리프가 가리키는 물체 번호, 빌드할 때 리프 단위로 모이도록 재배열된다
+		std::vector<uint32_t> objectIndices;
+		// objectIndices 순서로 복사한 물체 박스, 리프를 순회할 때 메모리를 순서대로 읽는다
+		std::vector<Aabb> objectBounds;
+		// 빌드하는 동안만 쓰는 박스 중심점, objectBounds 와 같은 순서
+		std::vector<glm::vec3> centroids;
+
+		void updateBounds(uint32_t nodeIndex);
+		void subdivide(uint32_t nodeIndex);
+		float findSplit(const BvhNode &node, int &axis, float &splitPosition) const;
+		void appendSubtree(uint32_t nodeIndex, std::vector<uint32_t> &visible) const;
+
+	public:
+		// bounds[i] 는 물체 i 의 월드 좌표계 박스
+		void build(const std::vector<Aabb> &bounds);
+		// 트리 구조는 그대로 두고 박스만 다시 계산한다, 물체가 조금씩 움직일 때 빌드보다 훨씬 싸다
+		// 물체 수와 순서는 build 때와 같아야 한다. 많이 움직이면 트리 품질이 떨어지므로 가끔 다시 빌드한다
+		void refit(const std::vector<Aabb> &bounds);
+		void clear();
+
+		// 프러스텀과 겹치는 물체 번호를 visible 에 추가한다
+		// 노드가 프러스텀 안에 완전히 들어가면 그 아래는 검사하지 않고 모두 추가한다
+		void cullFrustum(const Frustum &frustum, std::vector<uint32_t> &visible) const;
+		// 광선과 가장 가까이에서 만나는 물체의 박스를 찾는다
+		bool raycast(const Ray &ray, float maxDistance, uint32_t &object, float &distance) const;
+
+		size_t getNodeCount() const
+		{
+			return (nodes.size());
+		}
+
+		size_t getObjectCount() const
+		{
+			return (objectIndices.size());
+		}
+};
+
+#endif
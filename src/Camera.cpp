@@ -1,46 +1,47 @@
 #include "Camera.h"
 
-Camera::Camera(glm::vec3 position, glm::vec3 up, float yaw, float pitch) : Front(glm::vec3(0.0f, 0.0f, -1.0f)), MovementSpeed(SPEED), MouseSensitivity(SENSITIVITY), Zoom(ZOOM)
+Camera::Camera(glm::dvec3 position, glm::vec3 up, float yaw, float pitch) : MovementSpeed(SPEED), MouseSensitivity(SENSITIVITY), Zoom(ZOOM)
 {
 	Position = position;
 	WorldUp = up;
-	Yaw = yaw;
-	Pitch = pitch;
+	// yaw = -90, pitch = 0 일 때 -z 방향을 바라보는 것이 기준, 초기 방향을 만들 때만 삼각함수를 사용한다
+	Orientation = glm::normalize(glm::angleAxis(glm::radians(-(yaw - YAW)), WorldUp) * glm::angleAxis(glm::radians(pitch), glm::vec3(1.0f, 0.0f, 0.0f)));
 	updateCameraVectors();
 }
 
-Camera::Camera(float posX, float posY, float posZ, float upX, float upY, float upZ, float yaw, float pitch) : Front(glm::vec3(0.0f, 0.0f, -1.0f)), MovementSpeed(SPEED), MouseSensitivity(SENSITIVITY), Zoom(ZOOM)
+Camera::Camera(double posX, double posY, double posZ, float upX, float upY, float upZ, float yaw, float pitch) : Camera(glm::dvec3(posX, posY, posZ), glm::vec3(upX, upY, upZ), yaw, pitch)
 {
-	Position = glm::vec3(posX, posY, posZ);
-	WorldUp = glm::vec3(upX, upY, upZ);
-	Yaw = yaw;
-	Pitch = pitch;
-	updateCameraVectors();
 }
 
-glm::mat4 Camera::GetViewMatix()
+glm::mat4 Camera::GetViewMatix() const
+{
+	// 카메라가 원점에 있으므로 뷰 행렬은 카메라 회전의 역(켤레 쿼터니언)만으로 충분하다
+	return (glm::mat4_cast(glm::conjugate(Orientation)));
+}
+
+glm::vec3 Camera::ToCameraRelative(const glm::dvec3 &worldPosition) const
 {
-	return (glm::lookAt(Position, Position + Front, Up));
+	return (glm::vec3(worldPosition - Position));
 }
 
 void Camera::ProcessKeyboard(Camera_Movement direction, float deltaTime)
 {
-	float velocity = MovementSpeed * deltaTime;
+	double velocity = (double)(MovementSpeed * deltaTime);
 	if (direction == Camera_Movement::FORWARD)
 	{
-		Position += Front * velocity;
+		Position += glm::dvec3(Front) * velocity;
 	}
 	if (direction == Camera_Movement::BACKWARD)
 	{
-		Position -= Front * velocity;
+		Position -= glm::dvec3(Front) * velocity;
 	}
 	if (direction == Camera_Movement::LEFT)
 	{
-		Position -= Right * velocity;
+		Position -= glm::dvec3(Right) * velocity;
 	}
 	if (direction == Camera_Movement::RIGHT)
 	{
-		Position += Right * velocity;
+		Position += glm::dvec3(Right) * velocity;
 	}
 }
 
@@ -49,20 +50,18 @@ void Camera::ProcessMouseMovement(float xoffset, float yoffset, GLboolean constr
 	xoffset *= MouseSensitivity;
 	yoffset *= MouseSensitivity;
 
-	Yaw += xoffset;
-	Pitch += yoffset;
+	// yaw 는 월드의 윗 방향 축으로 (왼쪽에서 곱함), pitch 는 카메라의 오른쪽 축으로 (오른쪽에서 곱함) 회전한다
+	// 쿼터니언에는 짐벌 락이 없으므로 위아래 끝까지 돌려도 뷰 행렬이 깨지지 않는다
+	glm::quat yawRotation = glm::angleAxis(glm::radians(-xoffset), WorldUp);
+	glm::quat pitchRotation = glm::angleAxis(glm::radians(yoffset), glm::vec3(1.0f, 0.0f, 0.0f));
+	glm::quat rotated = glm::normalize(yawRotation * Orientation * pitchRotation);
 
-	if (constrainPitch)
+	// constrainPitch 는 1인칭 시점처럼 화면이 뒤집히지 않게 하고 싶을 때만 사용한다, 바라보는 방향이 윗 방향을 넘어가는 회전이면 pitch 를 버린다
+	if (constrainPitch && glm::dot(rotated * glm::vec3(0.0f, 1.0f, 0.0f), WorldUp) < 0.0f)
 	{
-		if (Pitch > 89.0f)
-		{
-			Pitch = 89.0f;
-		}
-		if (Pitch < -89.0f)
-		{
-			Pitch = -89.0f;
-		}
+		rotated = glm::normalize(yawRotation * Orientation);
 	}
+	Orientation = rotated;
 	updateCameraVectors();
 }
 
@@ -81,18 +80,8 @@ void Camera::ProcessMouseScroll(float yoffset)
 
 void Camera::updateCameraVectors()
 {
-	glm::vec3 front;
-	// xz 평면에서 x 좌표 cos(Yaw), 3d 공간에서의 실제 좌표를 구하기 위해 cos(Pitch) 를 곱해 Pitch에 따른 벡터의 기울어짐을 반영
-	front.x = cos(glm::radians(Yaw)) * cos(glm::radians(Pitch));
-	// y 좌표는 sin(Pitch) 만으로 정확히 구할 수 있다
-	front.y = sin(glm::radians(Pitch));
-	// xz 평면에서 z 좌표 sin(Yaw), 위의 x 성분과 마찬가지로 cos(Pitch) 를 곱해줌으로써 Pitch 에 따라 변화는 z 성분을 정확히 표현할 수 있다
-	front.z = sin(glm::radians(Yaw)) * cos(glm::radians(Pitch));
-
-	Front = glm::normalize(front);
-	// 카메라가 바라보는 방향과 월드 좌표계의 윗 방향을 cross product 하여 카메라의 오른쪽 벡터를 구하고, 그 벡터를 정규화 하여 카메라의 오른쪽 방향 벡터를 얻는다
-	// 아직 카메라의 윗 방향을 모르기 때문에 월드 좌표계의 윗 방향 벡터를 사용, cross product 의 결과 카메라의 오른쪽 벡터가 나오는 건 같으나 크기가 다르다
-	Right = glm::normalize(glm::cross(Front, WorldUp));
-	// 위에서 구한 카메라의 오른쪽 방향 벡터와 카메라가 바라보는 방향 벡터를 cross product 하여 카메라의 윗 벡터를 구하고, 정규화 한다
-	Up = glm::normalize(glm::cross(Right, Front));
-}
\ No newline at end of file
+	// 쿼터니언으로 카메라의 기준 축(-z 앞, +x 오른쪽, +y 위)을 회전시켜 방향 벡터를 얻는다, 삼각함수를 호출하지 않는다
+	Front = glm::normalize(Orientation * glm::vec3(0.0f, 0.0f, -1.0f));
+	Right = glm::normalize(Orientation * glm::vec3(1.0f, 0.0f, 0.0f));
+	Up = glm::normalize(Orientation * glm::vec3(0.0f, 1.0f, 0.0f));
+}
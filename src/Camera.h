@@ -4,6 +4,7 @@
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
 
 enum class Camera_Movement
 {
@@ -19,27 +20,32 @@ const float SPEED = 2.5f;
 const float SENSITIVITY = 0.1f;
 const float ZOOM = 45.0f;
 
+// 방향은 쿼터니언, 위치는 double 로 저장하는 카메라
+// 원점에서 멀리 떨어진 곳에서도 float 정밀도 때문에 떨리지 않도록, 렌더링은 카메라 위치를 원점으로 하는 좌표계(camera-relative) 에서 한다
 class Camera
 {
 	private:
 		void updateCameraVectors();
 	
 	public:
-		glm::vec3 Position;
+		// 월드 위치는 double 로 유지하고, GPU 로는 ToCameraRelative 로 카메라 기준 float 좌표만 보낸다
+		glm::dvec3 Position;
+		glm::quat Orientation;
 		glm::vec3 Front;
 		glm::vec3 Up;
 		glm::vec3 Right;
 		glm::vec3 WorldUp;
 
-		float Yaw;
-		float Pitch;
 		float MovementSpeed;
 		float MouseSensitivity;
 		float Zoom;
 
-		Camera(glm::vec3 position = glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3 up = glm::vec3(0.0f, 1.0f, 0.0f), float yaw = YAW, float pitch = PITCH);
-		Camera(float PosX, float PosY, float PosZ, float upX, float upY, float upZ, float yaw, float pitch);
-		glm::mat4 GetViewMatix();
+		Camera(glm::dvec3 position = glm::dvec3(0.0, 0.0, 0.0), glm::vec3 up = glm::vec3(0.0f, 1.0f, 0.0f), float yaw = YAW, float pitch = PITCH);
+		Camera(double PosX, double PosY, double PosZ, float upX, float upY, float upZ, float yaw, float pitch);
+		// 카메라 위치를 원점으로 하는 뷰 행렬(회전만 포함), 모델 행렬도 ToCameraRelative 로 만든 위치를 사용해야 한다
+		glm::mat4 GetViewMatix() const;
+		// 월드 좌표를 카메라 기준 좌표로 바꾼다, 뺄셈을 double 로 하므로 카메라 근처의 물체는 원점에서 얼마나 멀든 정밀도를 잃지 않는다
+		glm::vec3 ToCameraRelative(const glm::dvec3 &worldPosition) const;
 		void ProcessKeyboard(Camera_Movement direction, float deltaTime);
 		void ProcessMouseMovement(float xoffset, float yoffset, GLboolean constrainPitch = true);
 		void ProcessMouseScroll(float yoffset);
@@ -0,0 +1,92 @@
+#include "ComputeShader.h"
+#include "ShaderPreprocessor.h"
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <iostream>
+
+ComputeShader::ComputeShader(const char *path, const std::vector<std::string> &defines) : path(path), ID(0)
+{
+	std::cout << "Compute Shader Path: " << path << "\n";
+	std::string code;
+	std::vector<std::string> files;
+	if (!ShaderPreprocessor::process(path, defines, code, files))
+	{
+		std::cout << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ" << std::endl;
+		return;
+	}
+	const char *source = code.c_str();
+	int success;
+	char infoLog[1024];
+	unsigned int shader = glCreateShader(GL_COMPUTE_SHADER);
+	glShaderSource(shader, 1, &source, NULL);
+	glCompileShader(shader);
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+	if (!success)
+	{
+		glGetShaderInfoLog(shader, 1024, NULL, infoLog);
+		std::cout << "ERROR::SHADER_COMPILATION_ERROR of type: COMPUTE\n" << infoLog << "\n -- --------------------------------------------------- -- " << std::endl;
+		glDeleteShader(shader);
+		return;
+	}
+	ID = glCreateProgram();
+	glAttachShader(ID, shader);
+	glLinkProgram(ID);
+	glDeleteShader(shader);
+	glGetProgramiv(ID, GL_LINK_STATUS, &success);
+	if (!success)
+	{
+		glGetProgramInfoLog(ID, 1024, NULL, infoLog);
+		std::cout << "ERROR::PROGRAM_LINKING_ERROR of type: PROGRAM\n" << infoLog << "\n -- --------------------------------------------------- -- " << std::endl;
+		clear();
+	}
+}
+
+ComputeShader::~ComputeShader()
+{
+	clear();
+}
+
+void ComputeShader::clear()
+{
+	if (ID != 0)
+	{
+		glDeleteProgram(ID);
+		ID = 0;
+	}
+}
+
+void ComputeShader::use()
+{
+	glUseProgram(ID);
+}
+
+void ComputeShader::dispatch(unsigned int countX, unsigned int localSizeX, unsigned int countY, unsigned int localSizeY)
+{
+	glDispatchCompute((countX + localSizeX - 1) / localSizeX, (countY + localSizeY - 1) / localSizeY, 1);
+}
+
+void ComputeShader::setInt(const std::string &name, int value) const
+{
+	glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+}
+
+void ComputeShader::setFloat(const std::string &name, float value) const
+{
+	glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+}
+
+void ComputeShader::setVec2(const std::string &name, const glm::vec2 &value) const
+{
+	glUniform2fv(glGetUniformLocation(ID, name.c_str()), 1, glm::value_ptr(value));
+}
+
+void ComputeShader::setVec4Array(const std::string &name, const glm::vec4 *values, int count) const
+{
+	glUniform4fv(glGetUniformLocation(ID, name.c_str()), count, glm::value_ptr(values[0]));
+}
+
+void ComputeShader::setMat4(const std::string &name, const glm::mat4 &mat) const
+{
+	glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, glm::value_ptr(mat));
+}
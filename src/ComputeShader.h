@@ -0,0 +1,38 @@
+#ifndef COMPUTE_SHADER_H
+#define COMPUTE_SHADER_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <string>
+#include <vector>
+
+// 컴퓨트 셰이더 하나로 된 프로그램 (GL 4.3 / ARB_compute_shader)
+// 소스는 Shader 와 같이 ShaderPreprocessor 로 #include / #define 을 펼친 뒤 컴파일한다
+class ComputeShader
+{
+	private:
+		std::string path;
+
+	public:
+		// 컴파일이나 링크에 실패하면 0
+		unsigned int ID;
+
+		ComputeShader(const char *path, const std::vector<std::string> &defines = std::vector<std::string>());
+		~ComputeShader();
+
+		ComputeShader(const ComputeShader &) = delete;
+		ComputeShader &operator=(const ComputeShader &) = delete;
+
+		void use();
+		// 전체 작업 수를 local size 로 나눈 만큼 작업 그룹을 실행한다
+		void dispatch(unsigned int countX, unsigned int localSizeX, unsigned int countY = 1, unsigned int localSizeY = 1);
+		void clear();
+		void setInt(const std::string &name, int value) const;
+		void setFloat(const std::string &name, float value) const;
+		void setVec2(const std::string &name, const glm::vec2 &value) const;
+		void setVec4Array(const std::string &name, const glm::vec4 *values, int count) const;
+		void setMat4(const std::string &name, const glm::mat4 &mat) const;
+};
+
+#endif
@@ -0,0 +1,592 @@
+#include "DecodeBenchmark.h"
+#include "ImageDecoder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+	const int IMAGE_SIZES[] = {256, 1024, 2048};
+	const int REPEAT = 3;
+	const int JPEG_QUALITY = 90;
+
+	// 부드러운 무늬의 이미지, 64 픽셀 칸의 절반은 단계가 진 평평한 색이고 절반은 잡음을 섞어서 사진과 그린 텍스처가 섞인 압축률이 나오게 한다
+	std::vector<unsigned char> generateImage(int size, int channels)
+	{
+		std::vector<unsigned char> pixels((size_t)size * size * channels);
+		uint32_t random = 12345;
+		for (int y = 0; y < size; y++)
+		{
+			for (int x = 0; x < size; x++)
+			{
+				bool noisy = ((x / 64) + (y / 64)) % 2 == 0;
+				for (int c = 0; c < channels; c++)
+				{
+					random = random * 1664525u + 1013904223u;
+					float value = 128.0f + 70.0f * std::sin(x * (0.02f + c * 0.01f)) * std::cos(y * (0.03f - c * 0.005f));
+					value = noisy ? value + (float)((random >> 24) % 24) - 12.0f : std::floor(value / 16.0f) * 16.0f;
+					pixels[((size_t)y * size + x) * channels + c] = (unsigned char)std::min(255.0f, std::max(0.0f, value));
+				}
+			}
+		}
+		return (pixels);
+	}
+
+	void appendU32BigEndian(std::vector<unsigned char> &out, uint32_t value)
+	{
+		out.push_back((unsigned char)(value >> 24));
+		out.push_back((unsigned char)(value >> 16));
+		out.push_back((unsigned char)(value >> 8));
+		out.push_back((unsigned char)value);
+	}
+
+	// 하위 비트부터 채우는 deflate 비트 출력
+	struct DeflateWriter
+	{
+		std::vector<unsigned char> &out;
+		uint32_t buffer;
+		int count;
+
+		DeflateWriter(std::vector<unsigned char> &out) : out(out), buffer(0), count(0)
+		{
+		}
+
+		void bits(uint32_t value, int length)
+		{
+			buffer |= value << count;
+			count += length;
+			while (count >= 8)
+			{
+				out.push_back((unsigned char)buffer);
+				buffer >>= 8;
+				count -= 8;
+			}
+		}
+
+		// 허프만 부호는 상위 비트부터 쓴다
+		void code(uint32_t value, int length)
+		{
+			uint32_t reversed = 0;
+			for (int i = 0; i < length; i++)
+			{
+				reversed |= ((value >> i) & 1) << (length - 1 - i);
+			}
+			bits(reversed, length);
+		}
+
+		void literal(int symbol)
+		{
+			if (symbol < 144)
+			{
+				code(0x30 + symbol, 8);
+			}
+			else if (symbol < 256)
+			{
+				code(0x190 + symbol - 144, 9);
+			}
+			else if (symbol < 280)
+			{
+				code(symbol - 256, 7);
+			}
+			else
+			{
+				code(0xc0 + symbol - 280, 8);
+			}
+		}
+
+		void flush()
+		{
+			if (count > 0)
+			{
+				out.push_back((unsigned char)buffer);
+			}
+			buffer = 0;
+			count = 0;
+		}
+	};
+
+	// 고정 허프만 블록 하나와 해시 한 단계짜리 LZ77 로 압축한 zlib 스트림
+	std::vector<unsigned char> zlibCompress(const std::vector<unsigned char> &data)
+	{
+		static const int lengthBase[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+		static const int lengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+		static const int distanceBase[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+		static const int distanceExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+		const int WINDOW = 32768;
+		const int HASH_SIZE = 1 << 15;
+
+		std::vector<unsigned char> out = {0x78, 0x01};
+		DeflateWriter writer(out);
+		// 마지막 블록, 고정 허프만
+		writer.bits(1, 1);
+		writer.bits(1, 2);
+		std::vector<int> head(HASH_SIZE, -1);
+		size_t i = 0;
+		while (i < data.size())
+		{
+			int bestLength = 0;
+			int bestDistance = 0;
+			if (i + 3 <= data.size())
+			{
+				uint32_t hash = ((data[i] << 10) ^ (data[i + 1] << 5) ^ data[i + 2]) & (HASH_SIZE - 1);
+				int candidate = head[hash];
+				head[hash] = (int)i;
+				if (candidate >= 0 && (int)i - candidate <= WINDOW)
+				{
+					size_t limit = std::min(data.size() - i, (size_t)258);
+					size_t length = 0;
+					while (length < limit && data[candidate + length] == data[i + length])
+					{
+						length++;
+					}
+					if (length >= 3)
+					{
+						bestLength = (int)length;
+						bestDistance = (int)i - candidate;
+					}
+				}
+			}
+			if (bestLength == 0)
+			{
+				writer.literal(data[i]);
+				i++;
+				continue;
+			}
+			int lengthCode = 28;
+			while (lengthBase[lengthCode] > bestLength)
+			{
+				lengthCode--;
+			}
+			writer.literal(257 + lengthCode);
+			writer.bits(bestLength - lengthBase[lengthCode], lengthExtra[lengthCode]);
+			int distanceCode = 29;
+			while (distanceBase[distanceCode] > bestDistance)
+			{
+				distanceCode--;
+			}
+			writer.code(distanceCode, 5);
+			writer.bits(bestDistance - distanceBase[distanceCode], distanceExtra[distanceCode]);
+			i += bestLength;
+		}
+		writer.literal(256);
+		writer.flush();
+
+		uint32_t a = 1;
+		uint32_t b = 0;
+		for (unsigned char byte : data)
+		{
+			a = (a + byte) % 65521;
+			b = (b + a) % 65521;
+		}
+		appendU32BigEndian(out, (b << 16) | a);
+		return (out);
+	}
+
+	uint32_t crc32(const unsigned char *data, size_t size, uint32_t crc = 0)
+	{
+		static uint32_t table[256];
+		if (table[1] == 0)
+		{
+			for (uint32_t n = 0; n < 256; n++)
+			{
+				uint32_t c = n;
+				for (int k = 0; k < 8; k++)
+				{
+					c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+				}
+				table[n] = c;
+			}
+		}
+		crc = ~crc;
+		for (size_t i = 0; i < size; i++)
+		{
+			crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+		}
+		return (~crc);
+	}
+
+	void appendChunk(std::vector<unsigned char> &out, const char *type, const std::vector<unsigned char> &data)
+	{
+		appendU32BigEndian(out, (uint32_t)data.size());
+		size_t start = out.size();
+		out.insert(out.end(), type, type + 4);
+		out.insert(out.end(), data.begin(), data.end());
+		appendU32BigEndian(out, crc32(&out[start], out.size() - start));
+	}
+
+	// 8비트 흑백(1) / RGB(3) / RGBA(4) PNG, 모든 행에 Sub 필터를 쓴다
+	std::vector<unsigned char> encodePng(const std::vector<unsigned char> &pixels, int size, int channels)
+	{
+		static const unsigned char signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+		std::vector<unsigned char> filtered;
+		size_t stride = (size_t)size * channels;
+		filtered.reserve((stride + 1) * size);
+		for (int y = 0; y < size; y++)
+		{
+			const unsigned char *row = &pixels[y * stride];
+			filtered.push_back(1);
+			for (size_t x = 0; x < stride; x++)
+			{
+				filtered.push_back((unsigned char)(row[x] - (x >= (size_t)channels ? row[x - channels] : 0)));
+			}
+		}
+		std::vector<unsigned char> header;
+		appendU32BigEndian(header, (uint32_t)size);
+		appendU32BigEndian(header, (uint32_t)size);
+		unsigned char colorType = channels == 1 ? 0 : (channels == 3 ? 2 : 6);
+		header.insert(header.end(), {8, colorType, 0, 0, 0});
+
+		std::vector<unsigned char> out(signature, signature + 8);
+		appendChunk(out, "IHDR", header);
+		appendChunk(out, "IDAT", zlibCompress(filtered));
+		appendChunk(out, "IEND", std::vector<unsigned char>());
+		return (out);
+	}
+
+	// JPEG 표준 부록 K 의 양자화 / 허프만 테이블
+	const unsigned char ZIGZAG[64] = {0, 1, 8, 16, 9, 2, 3, 10, 17, 24, 32, 25, 18, 11, 4, 5, 12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13, 6, 7, 14, 21, 28,
+		35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51, 58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63};
+	const unsigned char LUMA_QUANT[64] = {16, 11, 10, 16, 24, 40, 51, 61, 12, 12, 14, 19, 26, 58, 60, 55, 14, 13, 16, 24, 40, 57, 69, 56, 14, 17, 22, 29, 51, 87, 80, 62,
+		18, 22, 37, 56, 68, 109, 103, 77, 24, 35, 55, 64, 81, 104, 113, 92, 49, 64, 78, 87, 103, 121, 120, 101, 72, 92, 95, 98, 112, 100, 103, 99};
+	const unsigned char CHROMA_QUANT[64] = {17, 18, 24, 47, 99, 99, 99, 99, 18, 21, 26, 66, 99, 99, 99, 99, 24, 26, 56, 99, 99, 99, 99, 99, 47, 66, 99, 99, 99, 99, 99, 99,
+		99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99};
+	const unsigned char DC_LUMA_BITS[16] = {0, 1, 5, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0};
+	const unsigned char DC_CHROMA_BITS[16] = {0, 3, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0};
+	const unsigned char DC_VALUES[12] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+	const unsigned char AC_LUMA_BITS[16] = {0, 2, 1, 3, 3, 2, 4, 3, 5, 5, 4, 4, 0, 0, 1, 0x7d};
+	const unsigned char AC_LUMA_VALUES[162] = {
+		0x01, 0x02, 0x03, 0x00, 0x04, 0x11, 0x05, 0x12, 0x21, 0x31, 0x41, 0x06, 0x13, 0x51, 0x61, 0x07, 0x22, 0x71, 0x14, 0x32, 0x81, 0x91, 0xa1, 0x08,
+		0x23, 0x42, 0xb1, 0xc1, 0x15, 0x52, 0xd1, 0xf0, 0x24, 0x33, 0x62, 0x72, 0x82, 0x09, 0x0a, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x25, 0x26, 0x27, 0x28,
+		0x29, 0x2a, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59,
+		0x5a, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89,
+		0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7, 0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6,
+		0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xe1, 0xe2,
+		0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa};
+	const unsigned char AC_CHROMA_BITS[16] = {0, 2, 1, 2, 4, 4, 3, 4, 7, 5, 4, 4, 0, 1, 2, 0x77};
+	const unsigned char AC_CHROMA_VALUES[162] = {
+		0x00, 0x01, 0x02, 0x03, 0x11, 0x04, 0x05, 0x21, 0x31, 0x06, 0x12, 0x41, 0x51, 0x07, 0x61, 0x71, 0x13, 0x22, 0x32, 0x81, 0x08, 0x14, 0x42, 0x91,
+		0xa1, 0xb1, 0xc1, 0x09, 0x23, 0x33, 0x52, 0xf0, 0x15, 0x62, 0x72, 0xd1, 0x0a, 0x16, 0x24, 0x34, 0xe1, 0x25, 0xf1, 0x17, 0x18, 0x19, 0x1a, 0x26,
+		0x27, 0x28, 0x29, 0x2a, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58,
+		0x59, 0x5a, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87,
+		0x88, 0x89, 0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7, 0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4,
+		0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda,
+		0xe2, 0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa};
+
+	struct HuffmanTable
+	{
+		uint16_t codes[256];
+		unsigned char lengths[256];
+	};
+
+	HuffmanTable buildHuffman(const unsigned char *bits, const unsigned char *values)
+	{
+		HuffmanTable table = {};
+		uint16_t code = 0;
+		int k = 0;
+		for (int length = 1; length <= 16; length++)
+		{
+			for (int i = 0; i < bits[length - 1]; i++)
+			{
+				table.codes[values[k]] = code++;
+				table.lengths[values[k]] = (unsigned char)length;
+				k++;
+			}
+			code <<= 1;
+		}
+		return (table);
+	}
+
+	// 상위 비트부터 채우고 0xFF 뒤에 0x00 을 넣는 JPEG 엔트로피 부호 출력
+	struct JpegWriter
+	{
+		std::vector<unsigned char> &out;
+		uint32_t buffer;
+		int count;
+
+		JpegWriter(std::vector<unsigned char> &out) : out(out), buffer(0), count(0)
+		{
+		}
+
+		void bits(uint32_t value, int length)
+		{
+			buffer = (buffer << length) | (value & ((1u << length) - 1));
+			count += length;
+			while (count >= 8)
+			{
+				unsigned char byte = (unsigned char)(buffer >> (count - 8));
+				out.push_back(byte);
+				if (byte == 0xff)
+				{
+					out.push_back(0);
+				}
+				count -= 8;
+			}
+		}
+
+		void flush()
+		{
+			if (count > 0)
+			{
+				bits(0x7f, 8 - count);
+			}
+		}
+	};
+
+	void appendMarker(std::vector<unsigned char> &out, unsigned char marker, const std::vector<unsigned char> &data)
+	{
+		out.push_back(0xff);
+		out.push_back(marker);
+		out.push_back((unsigned char)((data.size() + 2) >> 8));
+		out.push_back((unsigned char)(data.size() + 2));
+		out.insert(out.end(), data.begin(), data.end());
+	}
+
+	void appendHuffmanTable(std::vector<unsigned char> &data, unsigned char id, const unsigned char *bits, const unsigned char *values)
+	{
+		data.push_back(id);
+		data.insert(data.end(), bits, bits + 16);
+		int count = 0;
+		for (int i = 0; i < 16; i++)
+		{
+			count += bits[i];
+		}
+		data.insert(data.end(), values, values + count);
+	}
+
+	void encodeValue(JpegWriter &writer, const HuffmanTable &table, int run, int value)
+	{
+		int magnitude = value < 0 ? -value : value;
+		int length = 0;
+		while (magnitude >> length)
+		{
+			length++;
+		}
+		int symbol = (run << 4) | length;
+		writer.bits(table.codes[symbol], table.lengths[symbol]);
+		if (length > 0)
+		{
+			writer.bits(value < 0 ? value - 1 : value, length);
+		}
+	}
+
+	// 흑백(1) / YCbCr 4:4:4(3) 기본(baseline) JPEG
+	std::vector<unsigned char> encodeJpeg(const std::vector<unsigned char> &pixels, int size, int channels)
+	{
+		int scale = JPEG_QUALITY < 50 ? 5000 / JPEG_QUALITY : 200 - JPEG_QUALITY * 2;
+		unsigned char quant[2][64];
+		for (int i = 0; i < 64; i++)
+		{
+			quant[0][i] = (unsigned char)std::min(255, std::max(1, (LUMA_QUANT[i] * scale + 50) / 100));
+			quant[1][i] = (unsigned char)std::min(255, std::max(1, (CHROMA_QUANT[i] * scale + 50) / 100));
+		}
+		float dct[8][8];
+		for (int u = 0; u < 8; u++)
+		{
+			for (int x = 0; x < 8; x++)
+			{
+				dct[u][x] = (u == 0 ? std::sqrt(0.125f) : 0.5f) * std::cos((2 * x + 1) * u * 3.14159265f / 16.0f);
+			}
+		}
+		HuffmanTable dcTables[2] = {buildHuffman(DC_LUMA_BITS, DC_VALUES), buildHuffman(DC_CHROMA_BITS, DC_VALUES)};
+		HuffmanTable acTables[2] = {buildHuffman(AC_LUMA_BITS, AC_LUMA_VALUES), buildHuffman(AC_CHROMA_BITS, AC_CHROMA_VALUES)};
+
+		std::vector<unsigned char> out = {0xff, 0xd8};
+		std::vector<unsigned char> data;
+		for (int table = 0; table < (channels == 1 ? 1 : 2); table++)
+		{
+			data.push_back((unsigned char)table);
+			for (int i = 0; i < 64; i++)
+			{
+				data.push_back(quant[table][ZIGZAG[i]]);
+			}
+		}
+		appendMarker(out, 0xdb, data);
+		data = {8, (unsigned char)(size >> 8), (unsigned char)size, (unsigned char)(size >> 8), (unsigned char)size, (unsigned char)channels};
+		for (int c = 0; c < channels; c++)
+		{
+			data.insert(data.end(), {(unsigned char)(c + 1), 0x11, (unsigned char)(c == 0 ? 0 : 1)});
+		}
+		appendMarker(out, 0xc0, data);
+		data.clear();
+		appendHuffmanTable(data, 0x00, DC_LUMA_BITS, DC_VALUES);
+		appendHuffmanTable(data, 0x10, AC_LUMA_BITS, AC_LUMA_VALUES);
+		if (channels == 3)
+		{
+			appendHuffmanTable(data, 0x01, DC_CHROMA_BITS, DC_VALUES);
+			appendHuffmanTable(data, 0x11, AC_CHROMA_BITS, AC_CHROMA_VALUES);
+		}
+		appendMarker(out, 0xc4, data);
+		data = {(unsigned char)channels};
+		for (int c = 0; c < channels; c++)
+		{
+			data.insert(data.end(), {(unsigned char)(c + 1), (unsigned char)(c == 0 ? 0x00 : 0x11)});
+		}
+		data.insert(data.end(), {0, 63, 0});
+		appendMarker(out, 0xda, data);
+
+		JpegWriter writer(out);
+		int previousDc[3] = {};
+		for (int blockY = 0; blockY < size; blockY += 8)
+		{
+			for (int blockX = 0; blockX < size; blockX += 8)
+			{
+				for (int c = 0; c < channels; c++)
+				{
+					float block[8][8];
+					for (int y = 0; y < 8; y++)
+					{
+						for (int x = 0; x < 8; x++)
+						{
+							// 이미지 밖은 가장자리 픽셀을 반복한다
+							const unsigned char *pixel = &pixels[((size_t)std::min(blockY + y, size - 1) * size + std::min(blockX + x, size - 1)) * channels];
+							float value = pixel[0];
+							if (channels == 3)
+							{
+								float r = pixel[0];
+								float g = pixel[1];
+								float b = pixel[2];
+								value = c == 0 ? 0.299f * r + 0.587f * g + 0.114f * b : (c == 1 ? -0.1687f * r - 0.3313f * g + 0.5f * b + 128.0f : 0.5f * r - 0.4187f * g - 0.0813f * b + 128.0f);
+							}
+							block[y][x] = value - 128.0f;
+						}
+					}
+					// 행과 열 방향으로 1차원 DCT 를 한 번씩 적용한다
+					float rows[8][8];
+					for (int y = 0; y < 8; y++)
+					{
+						for (int u = 0; u < 8; u++)
+						{
+							float sum = 0.0f;
+							for (int x = 0; x < 8; x++)
+							{
+								sum += dct[u][x] * block[y][x];
+							}
+							rows[y][u] = sum;
+						}
+					}
+					int coefficients[64];
+					int table = c == 0 ? 0 : 1;
+					for (int v = 0; v < 8; v++)
+					{
+						for (int u = 0; u < 8; u++)
+						{
+							float sum = 0.0f;
+							for (int y = 0; y < 8; y++)
+							{
+								sum += dct[v][y] * rows[y][u];
+							}
+							coefficients[v * 8 + u] = (int)std::lround(sum / quant[table][v * 8 + u]);
+						}
+					}
+					encodeValue(writer, dcTables[table], 0, coefficients[0] - previousDc[c]);
+					previousDc[c] = coefficients[0];
+					int run = 0;
+					for (int i = 1; i < 64; i++)
+					{
+						int value = coefficients[ZIGZAG[i]];
+						if (value == 0)
+						{
+							run++;
+							continue;
+						}
+						while (run >= 16)
+						{
+							encodeValue(writer, acTables[table], 15, 0);
+							run -= 16;
+						}
+						encodeValue(writer, acTables[table], run, value);
+						run = 0;
+					}
+					if (run > 0)
+					{
+						encodeValue(writer, acTables[table], 0, 0);
+					}
+				}
+			}
+		}
+		writer.flush();
+		out.push_back(0xff);
+		out.push_back(0xd9);
+		return (out);
+	}
+
+	struct EncodedImage
+	{
+		std::vector<unsigned char> bytes;
+		int size;
+		int channels;
+	};
+
+	// 이미지 묶음 전체를 디코딩하는 가장 빠른 시간으로 처리량을 계산한다, MB/s 는 압축된 입력 크기 기준
+	void measure(const std::string &name, const std::vector<EncodedImage> &images, bool registry)
+	{
+		StbImageDecoder stb;
+		double best = 1e30;
+		size_t bytes = 0;
+		size_t pixels = 0;
+		for (int repeat = 0; repeat < REPEAT; repeat++)
+		{
+			bytes = 0;
+			pixels = 0;
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			for (const EncodedImage &image : images)
+			{
+				DecodedImage decoded;
+				bool success = registry ? ImageDecoderRegistry::instance().decode(image.bytes.data(), image.bytes.size(), false, decoded) : stb.decode(image.bytes.data(), image.bytes.size(), false, decoded);
+				// 디코더와 관계없이 채널 수는 원본을 따라야 한다
+				if (!success || decoded.width != image.size || decoded.channels != image.channels)
+				{
+					std::cout << name << ": failed to decode " << image.size << "x" << image.size << " image with " << image.channels << " channels" << std::endl;
+					return;
+				}
+				bytes += image.bytes.size();
+				pixels += (size_t)image.size * image.size;
+			}
+			best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+		}
+		double megabytes = bytes / (1024.0 * 1024.0);
+		std::cout << std::setw(28) << std::left << name << std::right << std::fixed << std::setprecision(1)
+			<< std::setw(8) << megabytes << " MB " << std::setw(9) << best * 1000.0 << " ms "
+			<< std::setw(9) << megabytes / best << " MB/s " << std::setw(8) << pixels / best / 1e6 << " Mpx/s" << std::endl;
+	}
+}
+
+void runDecodeBenchmark()
+{
+	struct Corpus
+	{
+		const char *name;
+		bool jpeg;
+		int channels;
+	};
+	const Corpus corpora[] = {
+		{"JPEG RGB", true, 3},
+		{"JPEG gray", true, 1},
+		{"PNG RGB", false, 3},
+		{"PNG RGBA", false, 4},
+		{"PNG gray", false, 1},
+	};
+	std::cout << "Generating images of size";
+	for (int size : IMAGE_SIZES)
+	{
+		std::cout << " " << size;
+	}
+	std::cout << std::endl;
+	for (const Corpus &corpus : corpora)
+	{
+		std::vector<EncodedImage> images;
+		for (int size : IMAGE_SIZES)
+		{
+			std::vector<unsigned char> pixels = generateImage(size, corpus.channels);
+			images.push_back({corpus.jpeg ? encodeJpeg(pixels, size, corpus.channels) : encodePng(pixels, size, corpus.channels), size, corpus.channels});
+		}
+		measure(std::string(corpus.name) + ", registry", images, true);
+		measure(std::string(corpus.name) + ", stb_image", images, false);
+	}
+}
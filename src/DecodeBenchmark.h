@@ -0,0 +1,8 @@
+#ifndef DECODE_BENCHMARK_H
+#define DECODE_BENCHMARK_H
+
+// 크기와 채널 구성이 다른 JPEG / PNG 이미지를 메모리에 만들고, 디코더 레지스트리와 stb_image 로 디코딩하는 처리량을 측정해서 출력한다
+// 빠른 디코더(libjpeg-turbo, libspng)가 없는 빌드에서는 두 결과가 같다. GL 컨텍스트 없이 CPU 에서만 실행된다
+void runDecodeBenchmark();
+
+#endif
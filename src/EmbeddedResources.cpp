@@ -0,0 +1,137 @@
+#include "EmbeddedResources.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#if defined(_WIN32)
+	#define WIN32_LEAN_AND_MEAN
+	#include <windows.h>
+#elif defined(__APPLE__)
+	#include <mach-o/dyld.h>
+	#include <cstdint>
+#endif
+
+namespace
+{
+	const char *resourceDirectory()
+	{
+		static const char *directory = std::getenv(RESOURCE_DIR_ENV);
+		return (directory);
+	}
+
+	// 실행 파일이 있는 디렉터리, 알 수 없으면 빈 경로
+	std::filesystem::path executableDirectory()
+	{
+		std::filesystem::path executable;
+#if defined(_WIN32)
+		wchar_t buffer[MAX_PATH];
+		DWORD length = GetModuleFileNameW(NULL, buffer, MAX_PATH);
+		if (length == 0 || length == MAX_PATH)
+		{
+			return (std::filesystem::path());
+		}
+		executable = std::filesystem::path(std::wstring(buffer, length));
+#elif defined(__APPLE__)
+		uint32_t size = 0;
+		_NSGetExecutablePath(NULL, &size);
+		std::string buffer(size, '\0');
+		if (_NSGetExecutablePath(&buffer[0], &size) != 0)
+		{
+			return (std::filesystem::path());
+		}
+		executable = std::filesystem::path(buffer.c_str());
+#else
+		std::error_code error;
+		executable = std::filesystem::read_symlink("/proc/self/exe", error);
+		if (error)
+		{
+			return (std::filesystem::path());
+		}
+#endif
+		return (executable.parent_path());
+	}
+}
+
+std::string normalizeResourcePath(const std::string &path)
+{
+	std::string normalized = path;
+	std::replace(normalized.begin(), normalized.end(), '\\', '/');
+	while (normalized.compare(0, 2, "./") == 0)
+	{
+		normalized.erase(0, 2);
+	}
+	return (normalized);
+}
+
+const EmbeddedResource *findEmbeddedResource(const std::string &path)
+{
+	std::string normalized = normalizeResourcePath(path);
+	for (size_t i = 0; i < EMBEDDED_RESOURCE_COUNT; ++i)
+	{
+		if (normalized == EMBEDDED_RESOURCES[i].path)
+		{
+			return (&EMBEDDED_RESOURCES[i]);
+		}
+	}
+	return (NULL);
+}
+
+bool isResourceDiskOverride()
+{
+	return (resourceDirectory() != NULL && resourceDirectory()[0] != '\0');
+}
+
+std::string resolveResourcePath(const std::string &path)
+{
+	if (!isResourceDiskOverride())
+	{
+		return (path);
+	}
+	std::string directory = resourceDirectory();
+	if (directory.back() != '/' && directory.back() != '\\')
+	{
+		directory += '/';
+	}
+	return (directory + normalizeResourcePath(path));
+}
+
+std::string resolveCachePath(const std::string &path)
+{
+	if (isResourceDiskOverride())
+	{
+		return (resolveResourcePath(path));
+	}
+	static const std::filesystem::path directory = executableDirectory();
+	if (directory.empty())
+	{
+		return (path);
+	}
+	// 디렉터리 경로의 끝 구분자를 유지해서 호출한 쪽이 파일 이름을 바로 이어붙일 수 있게 한다
+	return ((directory / normalizeResourcePath(path)).string());
+}
+
+bool readResource(const std::string &path, std::string &out)
+{
+	if (!isResourceDiskOverride())
+	{
+		const EmbeddedResource *resource = findEmbeddedResource(path);
+		if (resource != NULL)
+		{
+			out.assign((const char *)resource->data, resource->size);
+			return (true);
+		}
+	}
+	std::ifstream file(resolveResourcePath(path), std::ios::binary);
+	if (!file)
+	{
+		return (false);
+	}
+	std::stringstream stream;
+	stream << file.rdbuf();
+	out = stream.str();
+	return (true);
+}
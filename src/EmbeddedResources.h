@@ -0,0 +1,35 @@
+#ifndef EMBEDDED_RESOURCES_H
+#define EMBEDDED_RESOURCES_H
+
+#include <cstddef>
+#include <string>
+
+// 빌드 시점에 실행 파일에 포함된 리소스 (EmbedResources.cmake 가 생성)
+struct EmbeddedResource
+{
+	// 소스 디렉터리 기준 상대 경로, 예: "shader/shader.vs"
+	const char *path;
+	const unsigned char *data;
+	size_t size;
+};
+
+extern const EmbeddedResource EMBEDDED_RESOURCES[];
+extern const size_t EMBEDDED_RESOURCE_COUNT;
+
+// 리소스를 디스크에서 읽도록 강제하는 환경 변수, 값은 리소스 루트 디렉터리 (핫 리로드용)
+const char *const RESOURCE_DIR_ENV = "LEARNOPENGL_RESOURCE_DIR";
+
+// 경로 앞의 "./" 를 떼고 구분자를 '/' 로 맞춘다
+std::string normalizeResourcePath(const std::string &path);
+const EmbeddedResource *findEmbeddedResource(const std::string &path);
+// 디스크에서 읽기로 설정되어 있는지 (RESOURCE_DIR_ENV 가 설정되어 있으면 true)
+bool isResourceDiskOverride();
+// 디스크에서 읽을 때의 실제 파일 경로
+std::string resolveResourcePath(const std::string &path);
+// 실행 중에 만드는 파일(캐시 등) 의 경로, 디스크에서 읽도록 설정되어 있으면 리소스 루트 기준이고 아니면 실행 파일이 있는 디렉터리 기준
+// 작업 디렉터리와 관계없이 같은 캐시를 쓴다, 실행 파일 경로를 알 수 없으면 path 를 그대로 돌려준다
+std::string resolveCachePath(const std::string &path);
+// 디스크 오버라이드가 없으면 내장 리소스를 먼저 찾고, 없으면 작업 디렉터리 기준으로 디스크에서 읽는다
+bool readResource(const std::string &path, std::string &out);
+
+#endif
@@ -0,0 +1,55 @@
+#include "FixedTimestep.h"
+
+#include <cmath>
+
+Transform interpolate(const Transform &previous, const Transform &current, float alpha)
+{
+	Transform result;
+	result.position = previous.position + (current.position - previous.position) * (double)alpha;
+	result.rotation = glm::slerp(previous.rotation, current.rotation, alpha);
+	return (result);
+}
+
+FixedTimestep::FixedTimestep(double hz, int maxSteps) : step(1.0 / hz), accumulator(0.0), maxSteps(maxSteps), stepCount(0), droppedSteps(0)
+{
+}
+
+int FixedTimestep::advance(double frameTime)
+{
+	if (frameTime < 0.0)
+	{
+		frameTime = 0.0;
+	}
+	accumulator += frameTime;
+	int steps = (int)(accumulator / step);
+	if (steps > maxSteps)
+	{
+		droppedSteps += (unsigned long long)(steps - maxSteps);
+		steps = maxSteps;
+		// 따라잡지 못한 시간은 버린다, 시뮬레이션이 실제 시간보다 느려지지만 보간 비율은 유지된다
+		accumulator = step * steps + std::fmod(accumulator, step);
+	}
+	accumulator -= step * steps;
+	stepCount += (unsigned long long)steps;
+	return (steps);
+}
+
+double FixedTimestep::getStep() const
+{
+	return (step);
+}
+
+float FixedTimestep::getAlpha() const
+{
+	return ((float)(accumulator / step));
+}
+
+unsigned long long FixedTimestep::getStepCount() const
+{
+	return (stepCount);
+}
+
+unsigned long long FixedTimestep::getDroppedSteps() const
+{
+	return (droppedSteps);
+}
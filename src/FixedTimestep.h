@@ -0,0 +1,42 @@
+#ifndef FIXEDTIMESTEP_H
+#define FIXEDTIMESTEP_H
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+// 위치와 회전, 고정 스텝 사이의 렌더링에서 이전/현재 상태를 보간하는 단위
+struct Transform
+{
+	glm::dvec3 position = glm::dvec3(0.0);
+	glm::quat rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+};
+
+// alpha = 0 이면 previous, 1 이면 current
+Transform interpolate(const Transform &previous, const Transform &current, float alpha);
+
+// 시뮬레이션을 렌더링 프레임과 관계없이 일정한 간격(step)으로 실행하기 위한 누적기(accumulator)
+// 프레임 레이트가 달라도 시뮬레이션 결과와 비용이 같고, 남은 시간 비율(alpha) 로 렌더링할 상태를 보간한다
+class FixedTimestep
+{
+	private:
+		double step;
+		double accumulator;
+		// 한 프레임에 실행할 최대 스텝 수, 프레임이 오래 멈췄을 때 따라잡느라 더 느려지는 것(spiral of death) 을 막는다
+		int maxSteps;
+		unsigned long long stepCount;
+		unsigned long long droppedSteps;
+
+	public:
+		FixedTimestep(double hz, int maxSteps = 8);
+
+		// 이번 프레임 동안 흐른 시간을 더하고, 실행해야 할 스텝 수를 반환한다
+		int advance(double frameTime);
+		double getStep() const;
+		// 마지막 스텝 이후 흐른 시간을 스텝 길이로 나눈 값 [0, 1)
+		float getAlpha() const;
+		unsigned long long getStepCount() const;
+		// maxSteps 를 넘어서 버린 스텝 수
+		unsigned long long getDroppedSteps() const;
+};
+
+#endif
@@ -0,0 +1,102 @@
+#include "FrameArena.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <new>
+
+LinearAllocator::LinearAllocator(size_t blockSize) : blockSize(blockSize), offset(0), used(0), highWater(0), overflowBlocks(0)
+{
+	addBlock(blockSize);
+}
+
+LinearAllocator::~LinearAllocator()
+{
+	freeBlocks();
+}
+
+void LinearAllocator::addBlock(size_t size)
+{
+	Block block;
+	block.data = (unsigned char *)::operator new(size);
+	block.size = size;
+	blocks.push_back(block);
+	offset = 0;
+}
+
+void LinearAllocator::freeBlocks()
+{
+	for (const Block &block : blocks)
+	{
+		::operator delete(block.data);
+	}
+	blocks.clear();
+}
+
+void *LinearAllocator::allocate(size_t size, size_t alignment)
+{
+	Block &block = blocks.back();
+	uintptr_t address = (uintptr_t)(block.data + offset);
+	size_t padding = (alignment - address % alignment) % alignment;
+	if (offset + padding + size > block.size)
+	{
+		// 현재 블록의 남은 부분은 버리고 요청이 들어가는 블록을 이어붙인다
+		used += block.size - offset;
+		overflowBlocks++;
+		addBlock(std::max(blockSize, size + alignment));
+		return (allocate(size, alignment));
+	}
+	void *result = block.data + offset + padding;
+	offset += padding + size;
+	used += padding + size;
+	return (result);
+}
+
+void LinearAllocator::reset()
+{
+	highWater = std::max(highWater, used);
+	if (blocks.size() > 1)
+	{
+		// 이번 프레임이 쓴 만큼 블록 크기를 늘려서, 같은 양을 쓰는 다음 프레임부터는 넘치지 않게 한다
+		while (blockSize < used)
+		{
+			blockSize *= 2;
+		}
+		freeBlocks();
+		addBlock(blockSize);
+	}
+	offset = 0;
+	used = 0;
+}
+
+size_t LinearAllocator::getCapacity() const
+{
+	size_t capacity = 0;
+	for (const Block &block : blocks)
+	{
+		capacity += block.size;
+	}
+	return (capacity);
+}
+
+FrameArena::FrameArena(unsigned int frameCount, size_t blockSize)
+{
+	for (unsigned int i = 0; i < frameCount; i++)
+	{
+		frames.push_back(std::make_unique<LinearAllocator>(blockSize));
+	}
+}
+
+void FrameArena::printStats() const
+{
+	size_t highWater = 0;
+	size_t capacity = 0;
+	unsigned long long overflowBlocks = 0;
+	for (const std::unique_ptr<LinearAllocator> &frame : frames)
+	{
+		highWater = std::max(highWater, std::max(frame->getHighWater(), frame->getUsed()));
+		capacity += frame->getCapacity();
+		overflowBlocks += frame->getOverflowBlocks();
+	}
+	std::cout << "Frame arena: " << frames.size() << " frames, " << capacity / 1024.0 << " KB reserved, per-frame high water " << highWater / 1024.0 << " KB, " << overflowBlocks << " overflow blocks" << std::endl;
+}
@@ -0,0 +1,146 @@
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// 포인터만 앞으로 옮기는(bump) 할당기, 개별 해제는 없고 reset 으로 한꺼번에 비운다
+// 블록이 모자라면 새 블록을 이어붙이고(overflow chaining), 다음 reset 에서 그 프레임이 쓴 만큼의 블록 하나로 합친다
+// 사용량이 일정해지면 reset 도 할당도 malloc 을 부르지 않는다
+class LinearAllocator
+{
+	private:
+		struct Block
+		{
+			unsigned char *data;
+			size_t size;
+		};
+
+		// blocks.back() 이 현재 블록, 앞의 블록은 가득 찬 블록
+		std::vector<Block> blocks;
+		size_t blockSize;
+		// 현재 블록에서 쓴 바이트
+		size_t offset;
+		// 이번 프레임에 쓴 바이트, 정렬 패딩과 넘칠 때 버린 블록 끝을 포함한다
+		size_t used;
+		size_t highWater;
+		unsigned long long overflowBlocks;
+
+		void addBlock(size_t size);
+		void freeBlocks();
+
+	public:
+		LinearAllocator(size_t blockSize);
+		~LinearAllocator();
+
+		LinearAllocator(const LinearAllocator &) = delete;
+		LinearAllocator &operator=(const LinearAllocator &) = delete;
+
+		// alignment 는 2의 거듭제곱
+		void *allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+		// 모든 할당을 한꺼번에 해제한다, 이전 할당을 가리키는 포인터는 모두 무효가 된다
+		void reset();
+
+		template <typename T>
+		T *allocate(size_t count)
+		{
+			return ((T *)allocate(count * sizeof(T), alignof(T)));
+		}
+
+		size_t getUsed() const
+		{
+			return (used);
+		}
+
+		// 지금까지 한 프레임에 가장 많이 쓴 바이트
+		size_t getHighWater() const
+		{
+			return (highWater);
+		}
+
+		size_t getCapacity() const;
+
+		// 블록이 모자라서 이어붙인 횟수, 사용량이 일정해진 뒤에는 늘어나지 않아야 한다
+		unsigned long long getOverflowBlocks() const
+		{
+			return (overflowBlocks);
+		}
+};
+
+// LinearAllocator 를 쓰는 STL 할당기, deallocate 는 아무것도 하지 않는다
+// 컨테이너가 커질 때 이전 저장소는 reset 까지 남으므로, 크기를 알면 reserve 로 한 번에 잡는 것이 좋다
+template <typename T>
+class FrameAllocator
+{
+	public:
+		using value_type = T;
+
+		LinearAllocator *arena;
+
+		FrameAllocator(LinearAllocator *arena) noexcept : arena(arena)
+		{
+		}
+
+		template <typename U>
+		FrameAllocator(const FrameAllocator<U> &other) noexcept : arena(other.arena)
+		{
+		}
+
+		T *allocate(size_t count)
+		{
+			return (arena->allocate<T>(count));
+		}
+
+		void deallocate(T *, size_t) noexcept
+		{
+		}
+
+		template <typename U>
+		bool operator==(const FrameAllocator<U> &other) const noexcept
+		{
+			return (arena == other.arena);
+		}
+
+		template <typename U>
+		bool operator!=(const FrameAllocator<U> &other) const noexcept
+		{
+			return (arena != other.arena);
+		}
+};
+
+// 한 프레임 동안만 쓰는 배열, 할당기의 reset 전에 release 로 비워야 한다
+template <typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
+
+// 저장소를 reset 될 할당기에 돌려준다, clear 와 달리 이전 저장소를 가리키지 않게 된다
+template <typename T>
+void release(FrameVector<T> &vector)
+{
+	FrameVector<T>(vector.get_allocator()).swap(vector);
+}
+
+// 동시에 처리 중인 프레임 수만큼 LinearAllocator 를 두고 프레임마다 돌아가며 쓴다
+// 프레임 N 의 데이터를 다른 스레드가 읽는 동안 프레임 N+1 을 다른 할당기에 채울 수 있다
+class FrameArena
+{
+	private:
+		std::vector<std::unique_ptr<LinearAllocator>> frames;
+
+	public:
+		FrameArena(unsigned int frameCount, size_t blockSize);
+
+		LinearAllocator &getFrame(unsigned int frame)
+		{
+			return (*frames[frame]);
+		}
+
+		unsigned int getFrameCount() const
+		{
+			return ((unsigned int)frames.size());
+		}
+
+		void printStats() const;
+};
+
+#endif
@@ -0,0 +1,177 @@
+#include "FrameBuilder.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+	// CPU 오클루전 컬링 깊이 버퍼 크기(창과 같은 16:9) 와 프레임마다 그리는 가리개 수
+	const int OCCLUSION_BUFFER_WIDTH = 320;
+	const int OCCLUSION_BUFFER_HEIGHT = 180;
+	const size_t MAX_OCCLUDERS = 8;
+	// LOD 단계를 고를 때 허용하는 화면상 오차(픽셀) 와, 단계가 깜빡이지 않도록 거친 단계로 갈 때 더 요구하는 여유 비율
+	const float LOD_PIXEL_ERROR = 1.0f;
+	const float LOD_HYSTERESIS = 0.25f;
+}
+
+FrameBuilder::FrameBuilder(const FrameScene &scene) : scene(scene), occlusion(OCCLUSION_BUFFER_WIDTH, OCCLUSION_BUFFER_HEIGHT), submittedDraws(0), occludedDraws(0), lodTriangles(0), fullDetailTriangles(0), meshletTriangles(0), meshletFullTriangles(0)
+{
+}
+
+void FrameBuilder::build(FramePacket &frame, const glm::mat4 &projection, float alpha)
+{
+	// 카메라 기준 좌표계의 프러스텀을 월드 좌표계로 옮겨서, 보이는 물체만 패킷에 넣는다
+	Frustum frustum = Frustum::fromMatrix(projection * frame.camera.GetViewMatix()).translated(frame.camera.Position);
+	if (scene.staticBatch != NULL)
+	{
+		frame.staticDraws.reserve(scene.staticBatch->getChunkCount());
+		scene.staticBatch->cull(frustum, frame.camera, frame.staticDraws);
+	}
+	buildMeshes(frame, projection, frustum);
+	buildCubes(frame, projection, frustum, alpha);
+	if (scene.streamer != NULL)
+	{
+		frame.textureLevels.resize(scene.streamer->getTextureCount());
+		scene.streamer->selectLevels(frame.camera, scene.screenHeight, frame.textureLevels.data());
+	}
+}
+
+void FrameBuilder::buildMeshes(FramePacket &frame, const glm::mat4 &projection, const Frustum &frustum)
+{
+	if (scene.meshlets != NULL)
+	{
+		const std::vector<glm::dvec3> &positions = *scene.meshletPositions;
+		frame.meshletDraws.reserve(positions.size());
+		// 프러스텀과 카메라 위치를 물체마다 물체의 좌표계로 옮겨서 검사한다, 뺄셈은 double 로 한다
+		Frustum cameraFrustum = Frustum::fromMatrix(projection * frame.camera.GetViewMatix());
+		for (size_t i = 0; i < positions.size(); ++i)
+		{
+			glm::dvec3 offset = frame.camera.Position - positions[i];
+			Frustum localFrustum = cameraFrustum.translated(offset);
+			if (!localFrustum.intersectsSphere(glm::vec3(0.0f), scene.meshletRadius))
+			{
+				continue;
+			}
+			MeshletDraw draw;
+			draw.model = glm::translate(glm::mat4(1.0f), frame.camera.ToCameraRelative(positions[i]));
+			draw.firstRange = (unsigned int)frame.meshletRanges.size();
+			draw.rangeCount = (unsigned int)scene.meshlets->cull(localFrustum, glm::vec3(offset), frame.meshletRanges);
+			for (size_t range = draw.firstRange; range < frame.meshletRanges.size(); ++range)
+			{
+				meshletTriangles += frame.meshletRanges[range].indexCount / 3;
+			}
+			meshletFullTriangles += scene.meshlets->getTriangleCount();
+			if (draw.rangeCount > 0)
+			{
+				frame.meshletDraws.push_back(draw);
+			}
+		}
+	}
+	if (scene.meshInstances != NULL && !scene.meshInstances->empty())
+	{
+		frame.meshDraws.reserve(scene.meshInstances->size());
+		// 거리 1 에서 길이 1 이 화면 세로로 차지하는 픽셀 수
+		float pixelsPerUnit = scene.screenHeight / (2.0f * std::tan(glm::radians(frame.camera.Zoom) * 0.5f));
+		for (MeshInstance &instance : *scene.meshInstances)
+		{
+			const MeshInfo &mesh = scene.meshArena->getMesh(instance.mesh);
+			if (!frustum.intersectsSphere(glm::vec3(instance.position), mesh.radius))
+			{
+				continue;
+			}
+			float distance = (float)glm::length(instance.position - frame.camera.Position) - mesh.radius;
+			instance.lod = scene.meshArena->selectLod(instance.mesh, distance, pixelsPerUnit, LOD_PIXEL_ERROR, LOD_HYSTERESIS, instance.lod);
+			glm::mat4 model = glm::translate(glm::mat4(1.0f), frame.camera.ToCameraRelative(instance.position));
+			frame.meshDraws.push_back(scene.meshArena->makeDraw(instance.mesh, instance.lod, model));
+			lodTriangles += mesh.lods[instance.lod].indexCount / 3;
+			fullDetailTriangles += mesh.lods[0].indexCount / 3;
+		}
+	}
+}
+
+void FrameBuilder::buildCubes(FramePacket &frame, const glm::mat4 &projection, const Frustum &frustum, float alpha)
+{
+	if (scene.currentCubes == NULL)
+	{
+		return;
+	}
+	const std::vector<Transform> &previousCubes = *scene.previousCubes;
+	const std::vector<Transform> &currentCubes = *scene.currentCubes;
+	// GPU 컬링은 모든 큐브를 넘기므로, 비교할 때만 CPU 에서도 큐브를 컬링한다
+	bool cpuCubeCulling = (!scene.gpuCulling || scene.compareGpuCulling) && !currentCubes.empty();
+	visibleCubes.clear();
+	if (cpuCubeCulling)
+	{
+		scene.cubeBvh->cullFrustum(frustum, visibleCubes);
+	}
+	// 가까운 큐브부터 정렬해서 앞쪽 큐브가 가리개가 되게 한다
+	std::sort(visibleCubes.begin(), visibleCubes.end(), [&](uint32_t a, uint32_t b)
+	{
+		return (glm::length(currentCubes[a].position - frame.camera.Position) < glm::length(currentCubes[b].position - frame.camera.Position));
+	});
+	FrameVector<Transform> visibleTransforms(visibleCubes.size(), frame.scratch);
+	// GPU 컬링은 아래에서 모든 큐브로 다시 채우므로 처음부터 그만큼 잡아둔다
+	frame.models.reserve(scene.gpuCulling ? currentCubes.size() : visibleCubes.size());
+	frame.models.resize(visibleCubes.size());
+	for (size_t i = 0; i < visibleCubes.size(); ++i)
+	{
+		// 월드 위치에서 카메라 위치를 (double 로) 뺀 카메라 기준 위치로 모델 행렬을 만든다
+		uint32_t index = visibleCubes[i];
+		visibleTransforms[i] = interpolate(previousCubes[index], currentCubes[index], alpha);
+		glm::mat4 model = glm::mat4(1.0f);
+		model = glm::translate(model, frame.camera.ToCameraRelative(visibleTransforms[i].position));
+		frame.models[i] = model * glm::mat4_cast(visibleTransforms[i].rotation);
+	}
+	submittedDraws += frame.models.size();
+	if (scene.occlusionCulling && cpuCubeCulling)
+	{
+		// 모든 계산은 카메라 기준 좌표계에서 한다
+		glm::mat4 viewProjection = projection * frame.camera.GetViewMatix();
+		occlusion.clear();
+		for (size_t i = 0; i < std::min(MAX_OCCLUDERS, frame.models.size()); ++i)
+		{
+			occlusion.addOccluder(viewProjection * frame.models[i], scene.cubeOccluder.data(), scene.cubeOccluder.size());
+		}
+		// 가리개 자신은 바운딩 박스가 자기 표면보다 앞에 있으므로 스스로를 가리지 않는다
+		size_t kept = 0;
+		for (size_t i = 0; i < frame.models.size(); ++i)
+		{
+			Aabb box = sphereBounds(frame.camera.ToCameraRelative(visibleTransforms[i].position), scene.cubeRadius);
+			if (occlusion.isVisible(viewProjection, box))
+			{
+				frame.models[kept++] = frame.models[i];
+			}
+		}
+		occludedDraws += frame.models.size() - kept;
+		frame.models.resize(kept);
+	}
+	if (scene.gpuCulling)
+	{
+		// GPU 가 컬링하므로 모든 큐브를 넘기고, CPU 컬링 결과는 비교할 때 개수만 남긴다
+		frame.cpuVisibleCount = scene.compareGpuCulling ? (unsigned int)frame.models.size() : 0;
+		frame.models.resize(currentCubes.size());
+		for (size_t i = 0; i < currentCubes.size(); ++i)
+		{
+			Transform cube = interpolate(previousCubes[i], currentCubes[i], alpha);
+			glm::mat4 model = glm::mat4(1.0f);
+			model = glm::translate(model, frame.camera.ToCameraRelative(cube.position));
+			frame.models[i] = model * glm::mat4_cast(cube.rotation);
+		}
+	}
+}
+
+void FrameBuilder::printStats() const
+{
+	std::cout << "Occlusion culling: " << occludedDraws << " of " << submittedDraws << " draws culled" << std::endl;
+	if (fullDetailTriangles > 0)
+	{
+		std::cout << "LOD: " << lodTriangles << " of " << fullDetailTriangles << " full detail triangles submitted (" << 100.0 * lodTriangles / fullDetailTriangles << "%)" << std::endl;
+	}
+	if (meshletFullTriangles > 0)
+	{
+		std::cout << "Meshlet culling: " << meshletTriangles << " of " << meshletFullTriangles << " triangles submitted (" << 100.0 * meshletTriangles / meshletFullTriangles << "%)" << std::endl;
+	}
+}
@@ -0,0 +1,79 @@
+#ifndef FRAME_BUILDER_H
+#define FRAME_BUILDER_H
+
+#include "Bvh.h"
+#include "FixedTimestep.h"
+#include "FramePacket.h"
+#include "MeshArena.h"
+#include "Meshlet.h"
+#include "OcclusionCuller.h"
+#include "StaticBatch.h"
+#include "TextureStreamer.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+// 프레임 패킷을 만들 때 읽는 장면, main 이 소유하고 FrameBuilder 는 가리키기만 한다
+// 여기 있는 것은 모두 CPU 데이터이므로 GL 버퍼를 올리지 않아도(창 없이도) 패킷을 만들 수 있다
+// 포인터가 NULL 이면 장면에 그 부분이 없다
+struct FrameScene
+{
+	// 물체마다 그리는 큐브의 이전 / 현재 시뮬레이션 상태, 같은 순서로 만든 BVH
+	const std::vector<Transform> *previousCubes = NULL;
+	const std::vector<Transform> *currentCubes = NULL;
+	const Bvh *cubeBvh = NULL;
+	float cubeRadius = 0.0f;
+	// 가리개로 그리는 큐브 삼각형의 정점 위치
+	std::vector<glm::vec3> cubeOccluder;
+	const StaticBatch *staticBatch = NULL;
+	// LOD 를 고르는 메쉬 물체, 고른 단계를 instance.lod 에 남겨서 다음 프레임의 히스테리시스에 쓴다
+	const MeshArena *meshArena = NULL;
+	std::vector<MeshInstance> *meshInstances = NULL;
+	// meshlet 컬링으로 그리는 메쉬와 그 메쉬를 놓은 위치, 바운딩 구의 반지름
+	const MeshletMesh *meshlets = NULL;
+	const std::vector<glm::dvec3> *meshletPositions = NULL;
+	float meshletRadius = 0.0f;
+	const TextureStreamer *streamer = NULL;
+	// 렌더링 해상도의 세로 픽셀 수, LOD 와 텍스처 밉 레벨을 고를 때 쓴다
+	int screenHeight = 0;
+	bool occlusionCulling = true;
+	bool gpuCulling = false;
+	bool compareGpuCulling = false;
+};
+
+// 메인 스레드가 매 프레임 하는 일 중 패킷을 채우는 부분
+// 큐브의 BVH 프러스텀 컬링, 가까운 순서 정렬, CPU 오클루전 컬링, 정적 배칭 덩어리 컬링, 메쉬 LOD 선택, meshlet 컬링,
+// 텍스처 밉 레벨 선택을 한다. 임시 배열은 패킷의 프레임 할당기나 여기 남겨두는 배열을 쓰므로 정상 상태에서는 힙을 쓰지 않는다
+class FrameBuilder
+{
+	private:
+		const FrameScene &scene;
+		// 프러스텀 컬링을 통과한 큐브 번호, 프레임마다 비우고 용량은 유지한다
+		std::vector<uint32_t> visibleCubes;
+		OcclusionCuller occlusion;
+
+		unsigned long long submittedDraws;
+		unsigned long long occludedDraws;
+		unsigned long long lodTriangles;
+		unsigned long long fullDetailTriangles;
+		unsigned long long meshletTriangles;
+		unsigned long long meshletFullTriangles;
+
+		void buildCubes(FramePacket &frame, const glm::mat4 &projection, const Frustum &frustum, float alpha);
+		void buildMeshes(FramePacket &frame, const glm::mat4 &projection, const Frustum &frustum);
+
+	public:
+		FrameBuilder(const FrameScene &scene);
+
+		FrameBuilder(const FrameBuilder &) = delete;
+		FrameBuilder &operator=(const FrameBuilder &) = delete;
+
+		// frame.camera 를 채운 뒤 호출한다. projection 은 컬링에 쓰는 투영(late latch 면 넓힌 것), alpha 는 시뮬레이션 상태의 보간 비율
+		void build(FramePacket &frame, const glm::mat4 &projection, float alpha);
+		// 오클루전 컬링, LOD, meshlet 컬링이 줄인 그리기 수와 삼각형 수를 출력한다
+		void printStats() const;
+};
+
+#endif
@@ -0,0 +1,98 @@
+#include "FramePacer.h"
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#ifdef __linux__
+	#include <cerrno>
+	#include <time.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define FRAME_PACER_PAUSE() _mm_pause()
+#else
+	#define FRAME_PACER_PAUSE() std::this_thread::yield()
+#endif
+
+namespace
+{
+	int64_t monotonicNanoseconds()
+	{
+#ifdef __linux__
+		timespec now;
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		return ((int64_t)now.tv_sec * 1000000000LL + now.tv_nsec);
+#else
+		return (std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+	}
+
+	// until 까지 잠든다, 신호로 깨어나면 다시 잔다
+	void sleepUntil(int64_t until)
+	{
+#ifdef __linux__
+		timespec target;
+		target.tv_sec = (time_t)(until / 1000000000LL);
+		target.tv_nsec = (long)(until % 1000000000LL);
+		while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &target, NULL) == EINTR)
+		{
+		}
+#else
+		std::this_thread::sleep_until(std::chrono::steady_clock::time_point(std::chrono::nanoseconds(until)));
+#endif
+	}
+}
+
+FramePacer::FramePacer(double targetRate, double spinMicroseconds) : intervalNanoseconds(0), spinNanoseconds((int64_t)(spinMicroseconds * 1000.0)), deadline(0), lastFrameStart(0), intervals("Frame start interval"), wakeErrors("Pacer wake error")
+{
+	setTargetRate(targetRate);
+}
+
+void FramePacer::setTargetRate(double targetRate)
+{
+	intervalNanoseconds = targetRate > 0.0 ? (int64_t)(1e9 / targetRate) : 0;
+	deadline = 0;
+}
+
+void FramePacer::wait()
+{
+	int64_t now = monotonicNanoseconds();
+	if (intervalNanoseconds > 0)
+	{
+		if (deadline == 0)
+		{
+			deadline = now;
+		}
+		if (now < deadline)
+		{
+			if (deadline - now > spinNanoseconds)
+			{
+				sleepUntil(deadline - spinNanoseconds);
+			}
+			while ((now = monotonicNanoseconds()) < deadline)
+			{
+				FRAME_PACER_PAUSE();
+			}
+			wakeErrors.add((now - deadline) / 1e6);
+		}
+		// 마감 시간은 실제로 깨어난 시간이 아니라 이전 마감 시간에서 간격만큼 더해서 오차가 쌓이지 않게 한다
+		// 한 프레임 이상 늦었으면 따라잡으려고 몰아서 실행하지 않고 지금부터 다시 맞춘다
+		deadline += intervalNanoseconds;
+		if (deadline < now)
+		{
+			deadline = now + intervalNanoseconds;
+		}
+	}
+	if (lastFrameStart != 0)
+	{
+		intervals.add((now - lastFrameStart) / 1e6);
+	}
+	lastFrameStart = now;
+}
+
+void FramePacer::printStats() const
+{
+	intervals.print();
+	wakeErrors.print();
+}
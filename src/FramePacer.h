@@ -0,0 +1,33 @@
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include "FrameStats.h"
+
+#include <cstdint>
+
+// 목표 프레임 레이트에 맞춰 프레임 시작 시간을 일정하게 맞춘다
+// 마감 시간 직전까지는 잠들어서(clock_nanosleep) CPU 를 쓰지 않고, 잠에서 깨는 시간의 오차를 줄이기 위해 마지막 spinTail 만큼만 돌면서 기다린다
+class FramePacer
+{
+	private:
+		// 0 이면 제한하지 않는다
+		int64_t intervalNanoseconds;
+		int64_t spinNanoseconds;
+		// 다음 프레임을 시작할 시간(단조 시계, ns)
+		int64_t deadline;
+		int64_t lastFrameStart;
+		// 프레임 시작 간격과, 마감 시간보다 늦게 깨어난 시간
+		FrameStats intervals;
+		FrameStats wakeErrors;
+
+	public:
+		FramePacer(double targetRate, double spinMicroseconds = 500.0);
+
+		// targetRate 가 0 이하면 제한을 끈다
+		void setTargetRate(double targetRate);
+		// 다음 프레임 시작 시간까지 기다린다, 메인 루프의 맨 앞(입력을 읽기 전)에서 호출
+		void wait();
+		void printStats() const;
+};
+
+#endif
@@ -0,0 +1,16 @@
+#include "FramePacket.h"
+
+FramePacket::FramePacket(LinearAllocator &scratch) : scratch(&scratch), models(&scratch), staticDraws(&scratch), meshDraws(&scratch), meshletDraws(&scratch), meshletRanges(&scratch), textureLevels(&scratch)
+{
+}
+
+void FramePacket::reset()
+{
+	release(models);
+	release(staticDraws);
+	release(meshDraws);
+	release(meshletDraws);
+	release(meshletRanges);
+	release(textureLevels);
+	scratch->reset();
+}
@@ -0,0 +1,45 @@
+#ifndef FRAME_PACKET_H
+#define FRAME_PACKET_H
+
+#include "Camera.h"
+#include "FrameArena.h"
+#include "StaticBatch.h"
+#include "MeshArena.h"
+#include "Meshlet.h"
+
+#include <glm/glm.hpp>
+
+// 메인 스레드(이벤트, 시뮬레이션)가 채워서 렌더 스레드로 넘기는 한 프레임 분량의 데이터
+// 렌더 스레드는 이 패킷만 읽으므로 메인 스레드의 상태(카메라, 시뮬레이션)와 경쟁하지 않는다
+// 배열은 패킷마다 하나인 프레임 할당기에 잡히고, 렌더 스레드가 패킷을 다 읽은 뒤 beginFrame 에서 한꺼번에 비워진다
+struct FramePacket
+{
+	// 배열과, 메인 스레드가 이 프레임을 만드는 동안 쓰는 임시 메모리를 할당하는 곳
+	LinearAllocator *scratch;
+	unsigned long long frameIndex = 0;
+	// 보간이 끝난 렌더링용 카메라
+	Camera camera;
+	int viewportWidth = 0;
+	int viewportHeight = 0;
+	// 큐브마다 카메라 기준 모델 행렬
+	FrameVector<glm::mat4> models;
+	// GPU 컬링을 할 때 models 에는 모든 큐브가 들어 있고, --compare-gpu-culling 이면 CPU 컬링을 했다면 남았을 큐브 수를 비교용으로 함께 넘긴다
+	unsigned int cpuVisibleCount = 0;
+	// 프러스텀과 겹치는 정적 배칭 덩어리
+	FrameVector<StaticBatchDraw> staticDraws;
+	// LOD 단계를 고른 메쉬 그리기 명령
+	FrameVector<MeshDraw> meshDraws;
+	// meshlet 컬링을 통과한 물체와, 물체마다 그릴 인덱스 구간
+	FrameVector<MeshletDraw> meshletDraws;
+	FrameVector<IndexRange> meshletRanges;
+	// 텍스처 핸들마다 필요한 밉 레벨(TextureStreamer::selectLevels), 렌더 스레드가 TextureStreamer::stream 으로 요청한다
+	FrameVector<int> textureLevels;
+	// 이 프레임에 처음 반영된 입력 중 가장 오래된 것의 시간(glfwGetTime), 없으면 0
+	double inputTime = 0.0;
+
+	FramePacket(LinearAllocator &scratch);
+	// 배열을 비우고 할당기를 reset 한다
+	void reset();
+};
+
+#endif
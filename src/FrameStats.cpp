@@ -0,0 +1,81 @@
+#include "FrameStats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+FrameStats::FrameStats(const std::string &name, size_t capacity) : name(name), capacity(capacity), next(0), total(0)
+{
+	samples.reserve(capacity);
+}
+
+void FrameStats::add(double milliseconds)
+{
+	if (samples.size() < capacity)
+	{
+		samples.push_back(milliseconds);
+	}
+	else
+	{
+		samples[next] = milliseconds;
+		next = (next + 1) % capacity;
+	}
+	total++;
+}
+
+size_t FrameStats::count() const
+{
+	return (samples.size());
+}
+
+double FrameStats::percentile(double p) const
+{
+	if (samples.empty())
+	{
+		return (0.0);
+	}
+	// nearest-rank 방식
+	std::vector<double> sorted(samples);
+	double rank = std::ceil(p / 100.0 * sorted.size()) - 1.0;
+	size_t index = (size_t)std::max(0.0, std::min(rank, (double)(sorted.size() - 1)));
+	std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+	return (sorted[index]);
+}
+
+double FrameStats::mean() const
+{
+	if (samples.empty())
+	{
+		return (0.0);
+	}
+	double sum = 0.0;
+	for (double sample : samples)
+	{
+		sum += sample;
+	}
+	return (sum / samples.size());
+}
+
+double FrameStats::standardDeviation() const
+{
+	if (samples.size() < 2)
+	{
+		return (0.0);
+	}
+	double average = mean();
+	double sum = 0.0;
+	for (double sample : samples)
+	{
+		sum += (sample - average) * (sample - average);
+	}
+	return (std::sqrt(sum / (samples.size() - 1)));
+}
+
+void FrameStats::print() const
+{
+	if (samples.empty())
+	{
+		return;
+	}
+	std::cout << name << " (" << total << " samples): mean " << mean() << " ms, p50 " << percentile(50.0) << " ms, p90 " << percentile(90.0) << " ms, p99 " << percentile(99.0) << " ms, max " << percentile(100.0) << " ms, stddev " << standardDeviation() << " ms" << std::endl;
+}
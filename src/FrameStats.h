@@ -0,0 +1,32 @@
+#ifndef FRAME_STATS_H
+#define FRAME_STATS_H
+
+#include <string>
+#include <vector>
+
+// 프레임마다 측정한 값(ms) 을 모아서 백분위수와 분산을 보고한다
+// 최근 capacity 개의 샘플만 유지하므로 오래 실행해도 메모리가 늘어나지 않는다
+class FrameStats
+{
+	private:
+		std::string name;
+		std::vector<double> samples;
+		size_t capacity;
+		size_t next;
+		unsigned long long total;
+
+	public:
+		FrameStats(const std::string &name, size_t capacity = 16384);
+
+		void add(double milliseconds);
+		size_t count() const;
+		// p 는 0 ~ 100
+		double percentile(double p) const;
+		double mean() const;
+		// 표준편차, 프레임 간격이 얼마나 고른지(jitter) 를 나타낸다
+		double standardDeviation() const;
+		// 평균, p50 / p90 / p99, 최대값, 표준편차를 한 줄로 출력한다
+		void print() const;
+};
+
+#endif
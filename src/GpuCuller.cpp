@@ -0,0 +1,251 @@
+#include "GpuCuller.h"
+#include "Bounds.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+	// glDrawArraysIndirect 가 읽는 명령 형식
+	struct DrawArraysIndirectCommand
+	{
+		GLuint count;
+		GLuint instanceCount;
+		GLuint first;
+		GLuint baseInstance;
+	};
+
+	const GLuint INSTANCE_BINDING = 0;
+	const GLuint VISIBLE_BINDING = 1;
+	const GLuint COMMAND_BINDING = 2;
+}
+
+bool GpuCuller::isSupported()
+{
+	return (GLAD_GL_VERSION_4_3 != 0);
+}
+
+GpuCuller::GpuCuller() : cullShader("./shader/cull.comp"), copyDepthShader("./shader/depth_pyramid.comp", {"COPY_DEPTH"}), downsampleShader("./shader/depth_pyramid.comp"),
+	instanceBuffer(0), visibleBuffer(0), commandBuffer(0), capacity(0), instanceCount(0), depthTexture(0), depthFramebuffer(0), pyramidTexture(0),
+	pyramidWidth(0), pyramidHeight(0), pyramidLevels(0), pyramidViewProjection(1.0f), pyramidCameraPosition(0.0), pyramidValid(false), depthCopySupported(true)
+{
+	glGenBuffers(1, &instanceBuffer);
+	glGenBuffers(1, &visibleBuffer);
+	glGenBuffers(1, &commandBuffer);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+	glBufferData(GL_DRAW_INDIRECT_BUFFER, sizeof(DrawArraysIndirectCommand), NULL, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+GpuCuller::~GpuCuller()
+{
+	clear();
+}
+
+void GpuCuller::clear()
+{
+	releasePyramid();
+	unsigned int buffers[] = {instanceBuffer, visibleBuffer, commandBuffer};
+	if (instanceBuffer != 0)
+	{
+		glDeleteBuffers(3, buffers);
+	}
+	instanceBuffer = 0;
+	visibleBuffer = 0;
+	commandBuffer = 0;
+	capacity = 0;
+	cullShader.clear();
+	copyDepthShader.clear();
+	downsampleShader.clear();
+}
+
+void GpuCuller::bindInstanceAttributes(GLuint firstLocation)
+{
+	// 버퍼 이름은 바뀌지 않고 cull 에서 glBufferData 로 크기만 늘리므로, 연결은 한 번만 하면 된다
+	glBindBuffer(GL_ARRAY_BUFFER, visibleBuffer);
+	for (GLuint column = 0; column < 4; column++)
+	{
+		glVertexAttribPointer(firstLocation + column, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void *)(column * sizeof(glm::vec4)));
+		glEnableVertexAttribArray(firstLocation + column);
+		glVertexAttribDivisor(firstLocation + column, 1);
+	}
+}
+
+void GpuCuller::cull(const glm::mat4 *models, size_t modelCount, float boundingRadius, const glm::mat4 &projection, const glm::mat4 &view, const glm::dvec3 &cameraPosition, GLuint vertexCount)
+{
+	instanceCount = (unsigned int)modelCount;
+	GLsizeiptr size = (GLsizeiptr)(modelCount * sizeof(glm::mat4));
+	if (modelCount > capacity)
+	{
+		capacity = std::max(modelCount, capacity * 2);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, visibleBuffer);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, (GLsizeiptr)(capacity * sizeof(glm::mat4)), NULL, GL_DYNAMIC_COPY);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, instanceBuffer);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, (GLsizeiptr)(capacity * sizeof(glm::mat4)), NULL, GL_STREAM_DRAW);
+	}
+	if (size > 0)
+	{
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, instanceBuffer);
+		glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, size, models);
+	}
+	// instanceCount 는 컴퓨트 셰이더가 atomicAdd 로 늘린다
+	DrawArraysIndirectCommand command = {vertexCount, 0, 0, 0};
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+	glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, sizeof(command), &command);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+	if (instanceCount == 0 || cullShader.ID == 0)
+	{
+		return;
+	}
+
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, INSTANCE_BINDING, instanceBuffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, VISIBLE_BINDING, visibleBuffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, COMMAND_BINDING, commandBuffer);
+
+	Frustum frustum = Frustum::fromMatrix(projection * view);
+	cullShader.use();
+	cullShader.setInt("instanceCount", (int)instanceCount);
+	cullShader.setFloat("boundingRadius", boundingRadius);
+	cullShader.setVec4Array("frustumPlanes", frustum.planes, 6);
+	cullShader.setInt("useDepthPyramid", pyramidValid ? 1 : 0);
+	if (pyramidValid)
+	{
+		// 이번 프레임의 카메라 기준 좌표 p 는 월드 좌표 p + cameraPosition, 피라미드 카메라 기준으로는 p + (cameraPosition - pyramidCameraPosition)
+		glm::vec3 offset = glm::vec3(cameraPosition - pyramidCameraPosition);
+		cullShader.setMat4("previousViewProjection", glm::translate(pyramidViewProjection, offset));
+		cullShader.setVec2("depthPyramidSize", glm::vec2((float)pyramidWidth, (float)pyramidHeight));
+		cullShader.setInt("depthPyramidLevels", pyramidLevels);
+		cullShader.setInt("depthPyramid", TEXTURE_UNIT);
+		glActiveTexture(GL_TEXTURE0 + TEXTURE_UNIT);
+		glBindTexture(GL_TEXTURE_2D, pyramidTexture);
+		glActiveTexture(GL_TEXTURE0);
+	}
+	cullShader.dispatch(instanceCount, LOCAL_SIZE);
+	// 그리기 명령과 인스턴스 정점 속성이 컴퓨트 셰이더의 쓰기 결과를 보도록 한다
+	glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+}
+
+void GpuCuller::draw()
+{
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+	glDrawArraysIndirect(GL_TRIANGLES, (void *)0);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+void GpuCuller::releasePyramid()
+{
+	if (depthFramebuffer != 0)
+	{
+		glDeleteFramebuffers(1, &depthFramebuffer);
+		depthFramebuffer = 0;
+	}
+	if (depthTexture != 0)
+	{
+		glDeleteTextures(1, &depthTexture);
+		depthTexture = 0;
+	}
+	if (pyramidTexture != 0)
+	{
+		glDeleteTextures(1, &pyramidTexture);
+		pyramidTexture = 0;
+	}
+	pyramidValid = false;
+}
+
+void GpuCuller::resizePyramid(int width, int height)
+{
+	releasePyramid();
+	pyramidWidth = width;
+	pyramidHeight = height;
+	pyramidLevels = (int)std::floor(std::log2((double)std::max(width, height))) + 1;
+
+	glActiveTexture(GL_TEXTURE0 + TEXTURE_UNIT);
+	// 기본 프레임버퍼(GLFW 기본값 24비트 깊이 + 8비트 스텐실) 와 형식이 같아야 blit 할 수 있다
+	glGenTextures(1, &depthTexture);
+	glBindTexture(GL_TEXTURE_2D, depthTexture);
+	glTexStorage2D(GL_TEXTURE_2D, 1, GL_DEPTH24_STENCIL8, width, height);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glGenFramebuffers(1, &depthFramebuffer);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, depthFramebuffer);
+	glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, depthTexture, 0);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+
+	// 밉마다 가장 먼 깊이를 저장하므로 보간하면 안 된다
+	glGenTextures(1, &pyramidTexture);
+	glBindTexture(GL_TEXTURE_2D, pyramidTexture);
+	glTexStorage2D(GL_TEXTURE_2D, pyramidLevels, GL_R32F, width, height);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void GpuCuller::buildDepthPyramid(int width, int height, const glm::mat4 &viewProjection, const glm::dvec3 &cameraPosition)
+{
+	if (!depthCopySupported || width <= 0 || height <= 0 || copyDepthShader.ID == 0 || downsampleShader.ID == 0)
+	{
+		return;
+	}
+	if (width != pyramidWidth || height != pyramidHeight || pyramidTexture == 0)
+	{
+		resizePyramid(width, height);
+	}
+
+	glGetError();
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, depthFramebuffer);
+	glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	if (glGetError() != GL_NO_ERROR)
+	{
+		std::cout << "GpuCuller: depth copy is not supported, falling back to frustum culling only" << std::endl;
+		depthCopySupported = false;
+		releasePyramid();
+		return;
+	}
+
+	// 레벨 0 은 깊이 텍스처를 그대로 복사한다
+	copyDepthShader.use();
+	copyDepthShader.setInt("depthTexture", TEXTURE_UNIT);
+	glActiveTexture(GL_TEXTURE0 + TEXTURE_UNIT);
+	glBindTexture(GL_TEXTURE_2D, depthTexture);
+	glBindImageTexture(1, pyramidTexture, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+	copyDepthShader.dispatch(width, PYRAMID_LOCAL_SIZE, height, PYRAMID_LOCAL_SIZE);
+
+	downsampleShader.use();
+	int levelWidth = width;
+	int levelHeight = height;
+	for (int level = 1; level < pyramidLevels; level++)
+	{
+		glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+		downsampleShader.setVec2("sourceSize", glm::vec2((float)levelWidth, (float)levelHeight));
+		levelWidth = std::max(1, levelWidth / 2);
+		levelHeight = std::max(1, levelHeight / 2);
+		glBindImageTexture(0, pyramidTexture, level - 1, GL_FALSE, 0, GL_READ_ONLY, GL_R32F);
+		glBindImageTexture(1, pyramidTexture, level, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+		downsampleShader.dispatch(levelWidth, PYRAMID_LOCAL_SIZE, levelHeight, PYRAMID_LOCAL_SIZE);
+	}
+	// 다음 프레임의 컬링이 피라미드를 텍스처로 읽는다
+	glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+	glBindTexture(GL_TEXTURE_2D, 0);
+	glActiveTexture(GL_TEXTURE0);
+
+	pyramidViewProjection = viewProjection;
+	pyramidCameraPosition = cameraPosition;
+	pyramidValid = true;
+}
+
+unsigned int GpuCuller::readVisibleCount()
+{
+	DrawArraysIndirectCommand command = {0, 0, 0, 0};
+	glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+	glGetBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, sizeof(command), &command);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+	return (command.instanceCount);
+}
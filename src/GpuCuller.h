@@ -0,0 +1,75 @@
+#ifndef GPU_CULLER_H
+#define GPU_CULLER_H
+
+#include "ComputeShader.h"
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+
+// 컴퓨트 셰이더로 인스턴스를 컬링하고 간접 그리기(indirect draw) 명령을 GPU 에서 만든다 (GL 4.3)
+// 1. 지난 프레임의 깊이 버퍼로 깊이 피라미드(Hi-Z, 밉마다 아래 레벨 2x2 의 가장 먼 깊이) 를 만든다
+// 2. 인스턴스마다 바운딩 구를 프러스텀과 피라미드에 검사하고, 남은 인스턴스의 모델 행렬을 빈틈없이 모아서 쓰고 instanceCount 를 늘린다
+// 3. CPU 는 인스턴스 수와 관계없이 glDrawArraysIndirect 한 번만 호출한다, 결과를 CPU 로 읽어오지 않으므로 기다리지 않는다
+// 지난 프레임의 깊이를 쓰므로 갑자기 드러난 물체는 한 프레임 늦게 나타날 수 있다
+class GpuCuller
+{
+	private:
+		static const unsigned int LOCAL_SIZE = 64;
+		static const unsigned int PYRAMID_LOCAL_SIZE = 8;
+		// 깊이 텍스처와 피라미드를 읽을 텍스처 유닛, 머티리얼 텍스처(유닛 0 부터) 와 겹치지 않도록 마지막 유닛을 쓴다 (컴퓨트 셰이더는 최소 16개)
+		static const int TEXTURE_UNIT = 15;
+
+		ComputeShader cullShader;
+		ComputeShader copyDepthShader;
+		ComputeShader downsampleShader;
+		// 입력 인스턴스, 컬링을 통과한 인스턴스(정점 속성으로도 읽는다), 간접 그리기 명령
+		unsigned int instanceBuffer;
+		unsigned int visibleBuffer;
+		unsigned int commandBuffer;
+		size_t capacity;
+		unsigned int instanceCount;
+
+		// 기본 프레임버퍼의 깊이를 복사해 둘 텍스처와 FBO, 그리고 R32F 깊이 피라미드
+		unsigned int depthTexture;
+		unsigned int depthFramebuffer;
+		unsigned int pyramidTexture;
+		int pyramidWidth;
+		int pyramidHeight;
+		int pyramidLevels;
+		// 피라미드를 만들 때의 카메라, 다음 프레임의 카메라 기준 좌표를 이 카메라 기준으로 옮겨서 투영한다
+		glm::mat4 pyramidViewProjection;
+		glm::dvec3 pyramidCameraPosition;
+		bool pyramidValid;
+		// 깊이 복사(blit) 가 실패하는 드라이버에서는 프러스텀 컬링만 한다
+		bool depthCopySupported;
+
+		void resizePyramid(int width, int height);
+		void releasePyramid();
+
+	public:
+		// 컴퓨트 셰이더, SSBO, 간접 그리기, glTexStorage 가 모두 필요하다
+		static bool isSupported();
+
+		GpuCuller();
+		~GpuCuller();
+
+		GpuCuller(const GpuCuller &) = delete;
+		GpuCuller &operator=(const GpuCuller &) = delete;
+
+		// 현재 바인딩된 VAO 의 firstLocation ~ firstLocation + 3 에 컬링을 통과한 모델 행렬(mat4) 을 인스턴스마다 하나씩 읽도록 연결한다
+		void bindInstanceAttributes(GLuint firstLocation);
+		// models 는 카메라 기준 모델 행렬, 바운딩 구의 중심은 각 행렬의 이동 성분이다
+		// view 는 회전만 포함한 카메라 기준 뷰 행렬, vertexCount 는 인스턴스 하나의 정점 수
+		void cull(const glm::mat4 *models, size_t modelCount, float boundingRadius, const glm::mat4 &projection, const glm::mat4 &view, const glm::dvec3 &cameraPosition, GLuint vertexCount);
+		// cull 이 만든 명령으로 그린다, bindInstanceAttributes 로 연결한 VAO 를 바인딩한 상태에서 호출
+		void draw();
+		// 이번 프레임을 다 그린 뒤(스왑 전) 호출한다, 기본 프레임버퍼의 깊이로 다음 프레임이 쓸 피라미드를 만든다
+		void buildDepthPyramid(int width, int height, const glm::mat4 &viewProjection, const glm::dvec3 &cameraPosition);
+		// 마지막 cull 이 남긴 인스턴스 수, GPU 를 기다리므로 검증할 때만 사용한다
+		unsigned int readVisibleCount();
+		void clear();
+};
+
+#endif
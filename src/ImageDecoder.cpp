@@ -0,0 +1,273 @@
+#include "ImageDecoder.h"
+
+#include "EmbeddedResources.h"
+#include "stb_image.h"
+
+#ifdef HAVE_TURBOJPEG
+	#include <turbojpeg.h>
+#endif
+#ifdef HAVE_SPNG
+	#include <spng.h>
+#endif
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+namespace
+{
+	// 이 크기 이상의 JPEG/PNG 만 빠른 디코더로 보낸다
+	const size_t LARGE_IMAGE_BYTES = 256 * 1024;
+
+#ifdef HAVE_SPNG
+	// libspng 는 세로 뒤집기 옵션이 없으므로 디코딩한 뒤 행을 뒤집는다
+	void flipRows(DecodedImage &image)
+	{
+		size_t stride = (size_t)image.width * image.channels;
+		std::vector<unsigned char> tmp(stride);
+		for (int y = 0; y < image.height / 2; ++y)
+		{
+			unsigned char *top = &image.pixels[(size_t)y * stride];
+			unsigned char *bottom = &image.pixels[(size_t)(image.height - 1 - y) * stride];
+			std::memcpy(tmp.data(), top, stride);
+			std::memcpy(top, bottom, stride);
+			std::memcpy(bottom, tmp.data(), stride);
+		}
+	}
+#endif
+}
+
+ImageFormat sniffImageFormat(const unsigned char *data, size_t size)
+{
+	static const unsigned char pngSignature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+	if (size >= 3 && data[0] == 0xFF && data[1] == 0xD8 && data[2] == 0xFF)
+	{
+		return (ImageFormat::JPEG);
+	}
+	if (size >= 8 && std::memcmp(data, pngSignature, 8) == 0)
+	{
+		return (ImageFormat::PNG);
+	}
+	return (ImageFormat::UNKNOWN);
+}
+
+const char *imageFormatName(ImageFormat format)
+{
+	switch (format)
+	{
+		case ImageFormat::JPEG:
+			return ("JPEG");
+		case ImageFormat::PNG:
+			return ("PNG");
+		default:
+			return ("other");
+	}
+}
+
+const char *StbImageDecoder::name() const
+{
+	return ("stb_image");
+}
+
+// sniffImageFormat 이 모르는 형식(BMP, TGA 등) 도 stb_image 가 읽으므로 형식과 관계없이 마지막 대체 디코더가 된다
+bool StbImageDecoder::supports([[maybe_unused]] ImageFormat format) const
+{
+	return (true);
+}
+
+bool StbImageDecoder::decode(const unsigned char *data, size_t size, bool flipVertically, DecodedImage &out) const
+{
+	stbi_set_flip_vertically_on_load_thread(flipVertically);
+	unsigned char *pixels = stbi_load_from_memory(data, (int)size, &out.width, &out.height, &out.channels, 0);
+	if (!pixels)
+	{
+		return (false);
+	}
+	out.pixels.assign(pixels, pixels + (size_t)out.width * out.height * out.channels);
+	stbi_image_free(pixels);
+	return (true);
+}
+
+#ifdef HAVE_TURBOJPEG
+const char *TurboJpegDecoder::name() const
+{
+	return ("libjpeg-turbo");
+}
+
+bool TurboJpegDecoder::supports(ImageFormat format) const
+{
+	return (format == ImageFormat::JPEG);
+}
+
+bool TurboJpegDecoder::decode(const unsigned char *data, size_t size, bool flipVertically, DecodedImage &out) const
+{
+	// 핸들 생성 비용을 아끼기 위해 워커 스레드마다 하나씩 만들어 재사용한다
+	thread_local struct Handle
+	{
+		tjhandle handle = tjInitDecompress();
+		~Handle()
+		{
+			tjDestroy(handle);
+		}
+	} decompressor;
+
+	int subsampling;
+	int colorspace;
+	if (!decompressor.handle || tjDecompressHeader3(decompressor.handle, data, (unsigned long)size, &out.width, &out.height, &subsampling, &colorspace) != 0)
+	{
+		return (false);
+	}
+	// stb_image 와 같이 흑백 JPEG 는 1 채널, 나머지는 RGB 3 채널로 디코딩
+	int pixelFormat = (colorspace == TJCS_GRAY) ? TJPF_GRAY : TJPF_RGB;
+	out.channels = tjPixelSize[pixelFormat];
+	out.pixels.resize((size_t)out.width * out.height * out.channels);
+	int flags = flipVertically ? TJFLAG_BOTTOMUP : 0;
+	if (tjDecompress2(decompressor.handle, data, (unsigned long)size, out.pixels.data(), out.width, 0, out.height, pixelFormat, flags) != 0)
+	{
+		std::cout << "ERROR::TURBOJPEG::" << tjGetErrorStr2(decompressor.handle) << std::endl;
+		return (false);
+	}
+	return (true);
+}
+#endif
+
+#ifdef HAVE_SPNG
+const char *SpngDecoder::name() const
+{
+	return ("libspng");
+}
+
+bool SpngDecoder::supports(ImageFormat format) const
+{
+	return (format == ImageFormat::PNG);
+}
+
+bool SpngDecoder::decode(const unsigned char *data, size_t size, bool flipVertically, DecodedImage &out) const
+{
+	spng_ctx *ctx = spng_ctx_new(0);
+	if (!ctx)
+	{
+		return (false);
+	}
+	bool success = false;
+	struct spng_ihdr ihdr;
+	struct spng_trns trns;
+	if (spng_set_png_buffer(ctx, data, size) == 0 && spng_get_ihdr(ctx, &ihdr) == 0)
+	{
+		// stb_image 의 req_comp = 0 과 같은 채널 수로 디코딩한다
+		// 흑백은 1, 흑백 + 알파는 2, 컬러(팔레트 포함)는 3, 컬러 + 알파는 4 채널이고, 투명색 청크(tRNS)가 있으면 알파 채널을 더한다
+		bool transparent = (spng_get_trns(ctx, &trns) == 0);
+		bool gray = (ihdr.color_type == SPNG_COLOR_TYPE_GRAYSCALE || ihdr.color_type == SPNG_COLOR_TYPE_GRAYSCALE_ALPHA);
+		bool alpha = transparent || ihdr.color_type == SPNG_COLOR_TYPE_GRAYSCALE_ALPHA || ihdr.color_type == SPNG_COLOR_TYPE_TRUECOLOR_ALPHA;
+		int channels = (gray ? 1 : 3) + (alpha ? 1 : 0);
+		int format = gray ? (alpha ? SPNG_FMT_GA8 : SPNG_FMT_G8) : (alpha ? SPNG_FMT_RGBA8 : SPNG_FMT_RGB8);
+		size_t imageSize;
+		// 8비트 흑백 형식은 16비트 흑백 원본을 지원하지 않으므로 false 를 반환해서 stb_image 로 디코딩하게 한다
+		if (!(gray && ihdr.bit_depth > 8) && spng_decoded_image_size(ctx, format, &imageSize) == 0)
+		{
+			out.width = (int)ihdr.width;
+			out.height = (int)ihdr.height;
+			out.channels = channels;
+			out.pixels.resize(imageSize);
+			success = (spng_decode_image(ctx, out.pixels.data(), imageSize, format, transparent ? SPNG_DECODE_TRNS : 0) == 0);
+		}
+	}
+	spng_ctx_free(ctx);
+	if (success && flipVertically)
+	{
+		flipRows(out);
+	}
+	return (success);
+}
+#endif
+
+ImageDecoderRegistry::ImageDecoderRegistry()
+{
+#ifdef HAVE_TURBOJPEG
+	registerDecoder(std::unique_ptr<ImageDecoder>(new TurboJpegDecoder()), LARGE_IMAGE_BYTES);
+#endif
+#ifdef HAVE_SPNG
+	registerDecoder(std::unique_ptr<ImageDecoder>(new SpngDecoder()), LARGE_IMAGE_BYTES);
+#endif
+}
+
+ImageDecoderRegistry &ImageDecoderRegistry::instance()
+{
+	static ImageDecoderRegistry registry;
+	return (registry);
+}
+
+void ImageDecoderRegistry::registerDecoder(std::unique_ptr<ImageDecoder> decoder, size_t minimumSize)
+{
+	decoders.push_back({std::move(decoder), minimumSize});
+}
+
+bool ImageDecoderRegistry::decode(const unsigned char *data, size_t size, bool flipVertically, DecodedImage &out)
+{
+	ImageFormat format = sniffImageFormat(data, size);
+	const ImageDecoder *selected = &fallback;
+	for (const Entry &entry : decoders)
+	{
+		if (size >= entry.minimumSize && entry.decoder->supports(format))
+		{
+			selected = entry.decoder.get();
+			break;
+		}
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	bool success = selected->decode(data, size, flipVertically, out);
+	// 빠른 디코더가 실패하면(지원하지 않는 변형 포맷 등) stb_image 로 다시 시도
+	if (!success && selected != &fallback)
+	{
+		// 실패한 디코더의 시간이 stb_image 의 처리량에 섞이지 않도록 다시 잰다
+		start = std::chrono::steady_clock::now();
+		selected = &fallback;
+		success = fallback.decode(data, size, flipVertically, out);
+	}
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	if (success)
+	{
+		record(selected->name(), format, size, elapsed.count());
+	}
+	return (success);
+}
+
+bool ImageDecoderRegistry::decodeFile(const std::string &path, bool flipVertically, DecodedImage &out)
+{
+	// EMBED_TEXTURES 로 실행 파일에 포함된 텍스처라면 파일을 열지 않는다
+	std::string bytes;
+	if (!readResource(path, bytes))
+	{
+		return (false);
+	}
+	return (decode((const unsigned char *)bytes.data(), bytes.size(), flipVertically, out));
+}
+
+void ImageDecoderRegistry::record(const char *decoder, ImageFormat format, size_t bytes, double seconds)
+{
+	std::lock_guard<std::mutex> lock(statsMutex);
+	for (Stats &entry : stats)
+	{
+		if (entry.decoder == decoder && entry.format == format)
+		{
+			++entry.files;
+			entry.bytes += bytes;
+			entry.seconds += seconds;
+			return;
+		}
+	}
+	stats.push_back({decoder, format, 1, bytes, seconds});
+}
+
+void ImageDecoderRegistry::printStats() const
+{
+	std::lock_guard<std::mutex> lock(statsMutex);
+	for (const Stats &entry : stats)
+	{
+		double megabytes = entry.bytes / (1024.0 * 1024.0);
+		double throughput = entry.seconds > 0.0 ? megabytes / entry.seconds : 0.0;
+		std::cout << "Image decode [" << imageFormatName(entry.format) << ", " << entry.decoder << "] "
+			<< entry.files << " files, " << megabytes << " MB, " << throughput << " MB/s" << std::endl;
+	}
+}
@@ -0,0 +1,109 @@
+#ifndef IMAGE_DECODER_H
+#define IMAGE_DECODER_H
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+enum class ImageFormat
+{
+	UNKNOWN,
+	JPEG,
+	PNG,
+};
+
+// 파일 앞부분의 시그니처(매직 넘버)로 이미지 포맷을 판별한다
+ImageFormat sniffImageFormat(const unsigned char *data, size_t size);
+const char *imageFormatName(ImageFormat format);
+
+// 디코딩 결과, 채널 수는 원본 파일의 채널 구성을 따른다 (stbi_load 의 req_comp = 0 과 같은 규칙)
+struct DecodedImage
+{
+	int width = 0;
+	int height = 0;
+	int channels = 0;
+	std::vector<unsigned char> pixels;
+};
+
+// 디코더 구현의 공통 인터페이스. decode 는 여러 워커 스레드에서 동시에 호출될 수 있다
+class ImageDecoder
+{
+	public:
+		virtual ~ImageDecoder() = default;
+		virtual const char *name() const = 0;
+		virtual bool supports(ImageFormat format) const = 0;
+		virtual bool decode(const unsigned char *data, size_t size, bool flipVertically, DecodedImage &out) const = 0;
+};
+
+// 모든 포맷을 처리하는 기본(fallback) 디코더
+class StbImageDecoder : public ImageDecoder
+{
+	public:
+		const char *name() const override;
+		bool supports(ImageFormat format) const override;
+		bool decode(const unsigned char *data, size_t size, bool flipVertically, DecodedImage &out) const override;
+};
+
+#ifdef HAVE_TURBOJPEG
+// libjpeg-turbo 의 SIMD IDCT/색 변환을 사용하는 JPEG 디코더
+class TurboJpegDecoder : public ImageDecoder
+{
+	public:
+		const char *name() const override;
+		bool supports(ImageFormat format) const override;
+		bool decode(const unsigned char *data, size_t size, bool flipVertically, DecodedImage &out) const override;
+};
+#endif
+
+#ifdef HAVE_SPNG
+// libspng(zlib-ng/miniz 기반 inflate) 를 사용하는 PNG 디코더
+class SpngDecoder : public ImageDecoder
+{
+	public:
+		const char *name() const override;
+		bool supports(ImageFormat format) const override;
+		bool decode(const unsigned char *data, size_t size, bool flipVertically, DecodedImage &out) const override;
+};
+#endif
+
+// 포맷과 파일 크기에 따라 디코더를 선택하고, 포맷별 디코딩 처리량(MB/s)을 기록한다
+class ImageDecoderRegistry
+{
+	private:
+		struct Entry
+		{
+			std::unique_ptr<ImageDecoder> decoder;
+			size_t minimumSize;
+		};
+
+		struct Stats
+		{
+			std::string decoder;
+			ImageFormat format;
+			size_t files;
+			size_t bytes;
+			double seconds;
+		};
+
+		std::vector<Entry> decoders;
+		StbImageDecoder fallback;
+		mutable std::mutex statsMutex;
+		std::vector<Stats> stats;
+
+		ImageDecoderRegistry();
+		void record(const char *decoder, ImageFormat format, size_t bytes, double seconds);
+
+	public:
+		static ImageDecoderRegistry &instance();
+
+		// minimumSize 이상인 파일만 이 디코더로 보낸다, 작은 파일은 초기화 비용이 더 크므로 fallback 이 낫다
+		void registerDecoder(std::unique_ptr<ImageDecoder> decoder, size_t minimumSize = 0);
+		bool decode(const unsigned char *data, size_t size, bool flipVertically, DecodedImage &out);
+		bool decodeFile(const std::string &path, bool flipVertically, DecodedImage &out);
+		// 지금까지의 디코더/포맷별 처리량을 출력, MB/s 는 압축된 입력 파일 크기 기준
+		void printStats() const;
+};
+
+#endif
@@ -0,0 +1,116 @@
+#include "InputEvents.h"
+
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+
+namespace
+{
+	const uint32_t INPUT_MAGIC = 0x54504e49; // "INPT"
+	const uint32_t INPUT_VERSION = 1;
+
+	struct InputFileHeader
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint32_t recordSize;
+		uint32_t reserved;
+		double step;
+		uint64_t stepCount;
+	};
+
+	struct InputFileRecord
+	{
+		uint64_t stepIndex;
+		InputEvent event;
+	};
+}
+
+bool InputRecorder::open(const std::string &path, double step)
+{
+	file.open(path, std::ios::binary | std::ios::trunc);
+	if (!file)
+	{
+		std::cout << "ERROR::INPUT::FAILED_TO_OPEN_RECORDING: " << path << std::endl;
+		return (false);
+	}
+	InputFileHeader header = {INPUT_MAGIC, INPUT_VERSION, (uint32_t)sizeof(InputFileRecord), 0, step, 0};
+	file.write((const char *)&header, sizeof(header));
+	return ((bool)file);
+}
+
+bool InputRecorder::isOpen() const
+{
+	return (file.is_open());
+}
+
+void InputRecorder::record(uint64_t stepIndex, const InputEvent &event)
+{
+	if (!file.is_open())
+	{
+		return;
+	}
+	InputFileRecord record = {stepIndex, event};
+	file.write((const char *)&record, sizeof(record));
+}
+
+void InputRecorder::close(uint64_t stepCount)
+{
+	if (!file.is_open())
+	{
+		return;
+	}
+	// 헤더의 stepCount 만 덮어쓴다
+	file.seekp(offsetof(InputFileHeader, stepCount));
+	file.write((const char *)&stepCount, sizeof(stepCount));
+	file.close();
+}
+
+InputReplay::InputReplay() : next(0), stepCount(0)
+{
+}
+
+bool InputReplay::load(const std::string &path, double step)
+{
+	std::ifstream file(path, std::ios::binary);
+	InputFileHeader header;
+	if (!file || !file.read((char *)&header, sizeof(header)) || header.magic != INPUT_MAGIC || header.version != INPUT_VERSION || header.recordSize != sizeof(InputFileRecord))
+	{
+		std::cout << "ERROR::INPUT::INVALID_RECORDING: " << path << std::endl;
+		return (false);
+	}
+	if (std::fabs(header.step - step) > 1e-9)
+	{
+		std::cout << "WARNING::INPUT: recording was made with a " << 1.0 / header.step << " Hz simulation, replay will not match" << std::endl;
+	}
+	records.clear();
+	InputFileRecord record;
+	while (file.read((char *)&record, sizeof(record)))
+	{
+		records.push_back({record.stepIndex, record.event});
+	}
+	next = 0;
+	stepCount = header.stepCount;
+	return (true);
+}
+
+bool InputReplay::isLoaded() const
+{
+	return (stepCount > 0 || !records.empty());
+}
+
+bool InputReplay::poll(uint64_t stepIndex, InputEvent &event)
+{
+	if (next >= records.size() || records[next].stepIndex > stepIndex)
+	{
+		return (false);
+	}
+	event = records[next].event;
+	next++;
+	return (true);
+}
+
+bool InputReplay::finished(uint64_t stepIndex) const
+{
+	return (next >= records.size() && stepIndex >= stepCount);
+}
@@ -0,0 +1,75 @@
+#ifndef INPUT_EVENTS_H
+#define INPUT_EVENTS_H
+
+#include "SpscQueue.h"
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+enum class InputEventType : uint32_t
+{
+	KEY,
+	MOUSE_MOVE,
+	SCROLL,
+	MOUSE_BUTTON,
+};
+
+// GLFW 콜백에서 만들어지는 입력 이벤트 하나, time 은 glfwGetTime 기준(초)
+// KEY 는 key / action, MOUSE_MOVE 는 커서 위치 x / y, SCROLL 은 스크롤 양 x / y, MOUSE_BUTTON 은 key(버튼) / action 을 사용한다
+struct InputEvent
+{
+	double time;
+	InputEventType type;
+	int32_t key;
+	int32_t action;
+	double x;
+	double y;
+};
+
+// GLFW 콜백(메인 스레드의 glfwPollEvents) 이 채우고 시뮬레이션이 꺼내 쓰는 큐
+using InputQueue = SpscQueue<InputEvent, 4096>;
+
+// 시뮬레이션 스텝 번호와 함께 입력 이벤트를 바이너리 파일로 저장한다
+// 같은 스텝에 같은 이벤트를 넣으면 시뮬레이션 결과가 같으므로, 재생하면 항상 같은 카메라 경로를 얻는다
+class InputRecorder
+{
+	private:
+		std::ofstream file;
+
+	public:
+		// step 은 시뮬레이션 스텝 길이(초), 재생할 때 다른 스텝 길이로 실행하면 경고한다
+		bool open(const std::string &path, double step);
+		bool isOpen() const;
+		void record(uint64_t stepIndex, const InputEvent &event);
+		// 기록한 세션의 길이(스텝 수)를 헤더에 적고 파일을 닫는다
+		void close(uint64_t stepCount);
+};
+
+// InputRecorder 로 저장한 파일을 읽어서 스텝 번호에 맞춰 이벤트를 돌려준다
+class InputReplay
+{
+	private:
+		struct Record
+		{
+			uint64_t stepIndex;
+			InputEvent event;
+		};
+
+		std::vector<Record> records;
+		size_t next;
+		uint64_t stepCount;
+
+	public:
+		InputReplay();
+
+		bool load(const std::string &path, double step);
+		bool isLoaded() const;
+		// stepIndex 에 속한 다음 이벤트가 있으면 꺼내서 true
+		bool poll(uint64_t stepIndex, InputEvent &event);
+		// 기록된 세션 길이만큼 스텝을 진행하면 true, 벤치마크는 이때 종료한다
+		bool finished(uint64_t stepIndex) const;
+};
+
+#endif
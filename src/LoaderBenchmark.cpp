@@ -0,0 +1,227 @@
+#include "LoaderBenchmark.h"
+#include "ModelLoader.h"
+#include "MeshCache.h"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	// 한 변의 정점 수, 삼각형은 약 2 * GRID_SIZE^2 개
+	const int GRID_SIZE = 1024;
+	const int REPEAT = 3;
+
+	// 물결 모양 높이를 가진 격자, 정점은 위치 + 텍스처 좌표
+	MeshData generateGrid(int size)
+	{
+		MeshData mesh;
+		mesh.vertices.reserve((size_t)size * size * 5);
+		for (int z = 0; z < size; z++)
+		{
+			for (int x = 0; x < size; x++)
+			{
+				float u = (float)x / (size - 1);
+				float v = (float)z / (size - 1);
+				mesh.vertices.insert(mesh.vertices.end(), {u * 100.0f - 50.0f, std::sin(u * 40.0f) * std::cos(v * 40.0f), v * 100.0f - 50.0f, u, v});
+			}
+		}
+		for (int z = 0; z + 1 < size; z++)
+		{
+			for (int x = 0; x + 1 < size; x++)
+			{
+				uint32_t a = (uint32_t)(z * size + x);
+				uint32_t b = a + (uint32_t)size;
+				mesh.indices.insert(mesh.indices.end(), {a, b, a + 1, a + 1, b, b + 1});
+			}
+		}
+		return (mesh);
+	}
+
+	bool writeObj(const std::string &path, const MeshData &mesh)
+	{
+		FILE *file = std::fopen(path.c_str(), "wb");
+		if (file == NULL)
+		{
+			return (false);
+		}
+		for (size_t v = 0; v < mesh.vertices.size(); v += 5)
+		{
+			std::fprintf(file, "v %.6f %.6f %.6f\n", mesh.vertices[v], mesh.vertices[v + 1], mesh.vertices[v + 2]);
+		}
+		for (size_t v = 0; v < mesh.vertices.size(); v += 5)
+		{
+			std::fprintf(file, "vt %.6f %.6f\n", mesh.vertices[v + 3], mesh.vertices[v + 4]);
+		}
+		for (size_t i = 0; i < mesh.indices.size(); i += 3)
+		{
+			uint32_t a = mesh.indices[i] + 1;
+			uint32_t b = mesh.indices[i + 1] + 1;
+			uint32_t c = mesh.indices[i + 2] + 1;
+			std::fprintf(file, "f %u/%u %u/%u %u/%u\n", a, a, b, b, c, c);
+		}
+		return (std::fclose(file) == 0);
+	}
+
+	void appendU32(std::vector<unsigned char> &out, uint32_t value)
+	{
+		for (int i = 0; i < 4; i++)
+		{
+			out.push_back((unsigned char)(value >> (i * 8)));
+		}
+	}
+
+	bool writeGlb(const std::string &path, const MeshData &mesh)
+	{
+		size_t vertexCount = mesh.vertices.size() / 5;
+		std::vector<float> positions;
+		std::vector<float> texcoords;
+		positions.reserve(vertexCount * 3);
+		texcoords.reserve(vertexCount * 2);
+		for (size_t v = 0; v < mesh.vertices.size(); v += 5)
+		{
+			positions.insert(positions.end(), mesh.vertices.begin() + v, mesh.vertices.begin() + v + 3);
+			// glTF 의 v 는 이미지 위쪽이 0
+			texcoords.push_back(mesh.vertices[v + 3]);
+			texcoords.push_back(1.0f - mesh.vertices[v + 4]);
+		}
+		size_t positionBytes = positions.size() * sizeof(float);
+		size_t texcoordBytes = texcoords.size() * sizeof(float);
+		size_t indexBytes = mesh.indices.size() * sizeof(uint32_t);
+		std::string json = "{\"asset\":{\"version\":\"2.0\"},\"scene\":0,\"scenes\":[{\"nodes\":[0]}],\"nodes\":[{\"mesh\":0}],"
+			"\"meshes\":[{\"primitives\":[{\"attributes\":{\"POSITION\":0,\"TEXCOORD_0\":1},\"indices\":2}]}],"
+			"\"buffers\":[{\"byteLength\":" + std::to_string(positionBytes + texcoordBytes + indexBytes) + "}],"
+			"\"bufferViews\":[{\"buffer\":0,\"byteOffset\":0,\"byteLength\":" + std::to_string(positionBytes) + "},"
+			"{\"buffer\":0,\"byteOffset\":" + std::to_string(positionBytes) + ",\"byteLength\":" + std::to_string(texcoordBytes) + "},"
+			"{\"buffer\":0,\"byteOffset\":" + std::to_string(positionBytes + texcoordBytes) + ",\"byteLength\":" + std::to_string(indexBytes) + "}],"
+			"\"accessors\":[{\"bufferView\":0,\"componentType\":5126,\"count\":" + std::to_string(vertexCount) + ",\"type\":\"VEC3\"},"
+			"{\"bufferView\":1,\"componentType\":5126,\"count\":" + std::to_string(vertexCount) + ",\"type\":\"VEC2\"},"
+			"{\"bufferView\":2,\"componentType\":5125,\"count\":" + std::to_string(mesh.indices.size()) + ",\"type\":\"SCALAR\"}]}";
+		// 청크는 4바이트 경계에 맞춘다, JSON 은 공백으로 채운다
+		while (json.size() % 4 != 0)
+		{
+			json.push_back(' ');
+		}
+		size_t binBytes = positionBytes + texcoordBytes + indexBytes;
+		std::vector<unsigned char> header;
+		appendU32(header, 0x46546C67);
+		appendU32(header, 2);
+		appendU32(header, (uint32_t)(12 + 8 + json.size() + 8 + binBytes));
+		appendU32(header, (uint32_t)json.size());
+		appendU32(header, 0x4E4F534A);
+		header.insert(header.end(), json.begin(), json.end());
+		appendU32(header, (uint32_t)binBytes);
+		appendU32(header, 0x004E4942);
+		FILE *file = std::fopen(path.c_str(), "wb");
+		if (file == NULL)
+		{
+			return (false);
+		}
+		std::fwrite(header.data(), 1, header.size(), file);
+		std::fwrite(positions.data(), 1, positionBytes, file);
+		std::fwrite(texcoords.data(), 1, texcoordBytes, file);
+		std::fwrite(mesh.indices.data(), 1, indexBytes, file);
+		return (std::fclose(file) == 0);
+	}
+
+	using BenchmarkLayout = VertexLayout<Position3f, TexCoord2f>;
+
+	void printResult(const char *name, double megabytes, double seconds, size_t triangles)
+	{
+		std::cout << std::setw(24) << std::left << name << std::right << std::fixed << std::setprecision(1)
+			<< std::setw(8) << megabytes << " MB " << std::setw(9) << seconds * 1000.0 << " ms "
+			<< std::setw(9) << megabytes / seconds << " MB/s " << std::setw(8) << triangles / seconds / 1e6 << " Mtri/s" << std::endl;
+	}
+
+	// 가장 빠른 시간으로 처리량을 계산한다, 첫 번째 실행에서 파일이 페이지 캐시에 올라가므로 디스크 속도가 아닌 파싱 속도를 본다
+	void measure(const char *name, const std::string &path, unsigned int threadCount)
+	{
+		double best = 1e30;
+		size_t triangles = 0;
+		for (int repeat = 0; repeat < REPEAT; repeat++)
+		{
+			MeshData mesh;
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			if (!loadModel(path, mesh, threadCount))
+			{
+				return;
+			}
+			best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+			triangles = mesh.indices.size() / 3;
+		}
+		printResult(name, std::filesystem::file_size(path) / (1024.0 * 1024.0), best, triangles);
+	}
+
+	// 원본 크기 / 수정 시간 확인 + 캐시 매핑 + 검증 + 정점 / 인덱스 복사(glBufferSubData 대신) 시간, 실행할 때와 같은 경로다
+	void measureCache(const std::string &sourcePath, const std::string &directory, const MeshData &mesh)
+	{
+		MeshCache cache(directory);
+		MeshView view = {};
+		view.vertices = mesh.vertices.data();
+		view.vertexCount = mesh.vertices.size() / 5;
+		view.indices = mesh.indices.data();
+		view.indexCount = mesh.indices.size();
+		view.lods[0] = {0, (unsigned int)mesh.indices.size(), 0.0f};
+		view.lodCount = 1;
+		if (!cache.store<BenchmarkLayout>(sourcePath, view))
+		{
+			std::cout << "Failed to write mesh cache" << std::endl;
+			return;
+		}
+		std::vector<float> vertices(mesh.vertices.size());
+		std::vector<uint32_t> indices(mesh.indices.size());
+		double best = 1e30;
+		for (int repeat = 0; repeat < REPEAT; repeat++)
+		{
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			CachedMesh cached;
+			if (!cache.load<BenchmarkLayout>(sourcePath, cached))
+			{
+				std::cout << "Failed to read mesh cache" << std::endl;
+				return;
+			}
+			std::memcpy(vertices.data(), cached.view.vertices, cached.view.vertexCount * BenchmarkLayout::stride);
+			std::memcpy(indices.data(), cached.view.indices, cached.view.indexCount * sizeof(uint32_t));
+			best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+		}
+		double megabytes = (vertices.size() * sizeof(float) + indices.size() * sizeof(uint32_t)) / (1024.0 * 1024.0);
+		printResult("Mesh cache (GLB source)", megabytes, best, indices.size() / 3);
+	}
+}
+
+void runLoaderBenchmark()
+{
+	MeshData grid = generateGrid(GRID_SIZE);
+	std::filesystem::path directory = std::filesystem::temp_directory_path();
+	std::string objPath = (directory / "loader_benchmark.obj").string();
+	std::string glbPath = (directory / "loader_benchmark.glb").string();
+	std::cout << "Writing " << grid.indices.size() / 3 << " triangles to " << directory.string() << std::endl;
+	if (!writeObj(objPath, grid) || !writeGlb(glbPath, grid))
+	{
+		std::cout << "Failed to write benchmark models" << std::endl;
+		return;
+	}
+
+	unsigned int cores = std::max(std::thread::hardware_concurrency(), 1u);
+	measure("OBJ, 1 thread", objPath, 1);
+	measure(("OBJ, " + std::to_string(cores) + " threads").c_str(), objPath, cores);
+	measure("GLB", glbPath, 0);
+	std::string cacheDirectory = (directory / "loader_benchmark_cache/").string();
+	measureCache(glbPath, cacheDirectory, grid);
+
+	std::error_code error;
+	std::filesystem::remove_all(cacheDirectory, error);
+	std::filesystem::remove(objPath, error);
+	std::filesystem::remove(glbPath, error);
+}
@@ -0,0 +1,8 @@
+#ifndef LOADER_BENCHMARK_H
+#define LOADER_BENCHMARK_H
+
+// 큰 격자 메쉬를 OBJ 와 GLB 파일로 임시 디렉터리에 만들고, 모델 로더로 읽는 처리량(MB/s, 삼각형/s) 을 측정해서 출력한다
+// OBJ 는 스레드 1개와 코어 수만큼으로 각각 측정해서 병렬 파싱의 효과를 비교한다. GL 컨텍스트 없이 CPU 에서만 실행된다
+void runLoaderBenchmark();
+
+#endif
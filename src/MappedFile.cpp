@@ -0,0 +1,115 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+	#define WIN32_LEAN_AND_MEAN
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+MappedFile::MappedFile() : data(NULL), size(0), file(INVALID_HANDLE_VALUE), mapping(NULL)
+{
+}
+#else
+MappedFile::MappedFile() : data(NULL), size(0), file(-1)
+{
+}
+#endif
+
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+bool MappedFile::open(const std::string &path, bool sequential)
+{
+	close();
+#ifdef _WIN32
+	file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, sequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return (false);
+	}
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+	{
+		close();
+		return (false);
+	}
+	mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mapping == NULL)
+	{
+		close();
+		return (false);
+	}
+	data = (const unsigned char *)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	size = (size_t)fileSize.QuadPart;
+#else
+	file = ::open(path.c_str(), O_RDONLY);
+	if (file < 0)
+	{
+		return (false);
+	}
+	struct stat status;
+	if (fstat(file, &status) != 0 || status.st_size == 0)
+	{
+		close();
+		return (false);
+	}
+	size = (size_t)status.st_size;
+	void *mapped = mmap(NULL, size, PROT_READ, MAP_PRIVATE, file, 0);
+	if (mapped == MAP_FAILED)
+	{
+		close();
+		return (false);
+	}
+	// 처음부터 끝까지 한 번 읽으므로 미리 읽기(readahead) 를 크게 하도록 알린다
+	if (sequential)
+	{
+		madvise(mapped, size, MADV_SEQUENTIAL);
+	}
+	data = (const unsigned char *)mapped;
+#endif
+	if (data == NULL)
+	{
+		close();
+		return (false);
+	}
+	return (true);
+}
+
+void MappedFile::close()
+{
+#ifdef _WIN32
+	if (data != NULL)
+	{
+		UnmapViewOfFile(data);
+	}
+	if (mapping != NULL)
+	{
+		CloseHandle(mapping);
+		mapping = NULL;
+	}
+	if (file != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(file);
+		file = INVALID_HANDLE_VALUE;
+	}
+#else
+	if (data != NULL)
+	{
+		munmap((void *)data, size);
+	}
+	if (file >= 0)
+	{
+		::close(file);
+		file = -1;
+	}
+#endif
+	data = NULL;
+	size = 0;
+}
@@ -0,0 +1,49 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+// 파일 전체를 읽기 전용으로 메모리에 매핑한다, 읽는 만큼만 운영체제가 페이지를 올리므로 큰 파일을 복사하지 않고 바로 파싱할 수 있다
+// Windows 에서는 CreateFileMapping, 그 외에는 mmap 을 사용한다
+class MappedFile
+{
+	private:
+		const unsigned char *data;
+		size_t size;
+#ifdef _WIN32
+		void *file;
+		void *mapping;
+#else
+		int file;
+#endif
+
+	public:
+		MappedFile();
+		~MappedFile();
+
+		MappedFile(const MappedFile &) = delete;
+		MappedFile &operator=(const MappedFile &) = delete;
+
+		// 이미 열려 있으면 닫고 새로 연다, 실패하면 false
+		// sequential 이면 처음부터 끝까지 읽는다고 알려서 미리 읽기를 크게 하고, 아니면 접근한 페이지 근처만 읽게 둔다
+		bool open(const std::string &path, bool sequential = true);
+		void close();
+
+		bool isOpen() const
+		{
+			return (data != NULL);
+		}
+
+		const unsigned char *getData() const
+		{
+			return (data);
+		}
+
+		size_t getSize() const
+		{
+			return (size);
+		}
+};
+
+#endif
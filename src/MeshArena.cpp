@@ -0,0 +1,210 @@
+#include "MeshArena.h"
+#include "MeshSimplifier.h"
+
+#include <glm/gtc/constants.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+MeshData generateSphereMesh(float radius, int rings, int segments)
+{
+	MeshData mesh;
+	for (int ring = 0; ring <= rings; ring++)
+	{
+		float theta = glm::pi<float>() * ring / rings;
+		for (int segment = 0; segment <= segments; segment++)
+		{
+			float phi = 2.0f * glm::pi<float>() * segment / segments;
+			mesh.vertices.push_back(radius * std::sin(theta) * std::cos(phi));
+			mesh.vertices.push_back(radius * std::cos(theta));
+			mesh.vertices.push_back(radius * std::sin(theta) * std::sin(phi));
+			mesh.vertices.push_back((float)segment / segments);
+			mesh.vertices.push_back((float)ring / rings);
+		}
+	}
+	for (int ring = 0; ring < rings; ring++)
+	{
+		for (int segment = 0; segment < segments; segment++)
+		{
+			uint32_t a = (uint32_t)(ring * (segments + 1) + segment);
+			uint32_t b = a + (uint32_t)(segments + 1);
+			// 극점에서는 사각형 하나가 삼각형 하나가 된다
+			if (ring != 0)
+			{
+				mesh.indices.insert(mesh.indices.end(), {a, a + 1, b});
+			}
+			if (ring != rings - 1)
+			{
+				mesh.indices.insert(mesh.indices.end(), {a + 1, b + 1, b});
+			}
+		}
+	}
+	return (mesh);
+}
+
+MeshArena::MeshArena(size_t floatsPerVertex) : floatsPerVertex(floatsPerVertex), vertexTotal(0), indexTotal(0), VAO(0), VBO(0), EBO(0)
+{
+}
+
+MeshArena::~MeshArena()
+{
+	clear();
+}
+
+void MeshArena::clear()
+{
+	if (VAO != 0)
+	{
+		glDeleteVertexArrays(1, &VAO);
+		glDeleteBuffers(1, &VBO);
+		glDeleteBuffers(1, &EBO);
+		VAO = 0;
+		VBO = 0;
+		EBO = 0;
+	}
+}
+
+unsigned int MeshArena::add(const MeshData &mesh, unsigned int maxLods)
+{
+	MeshView view;
+	view.vertexCount = mesh.vertices.size() / floatsPerVertex;
+	view.radius = 0.0f;
+	for (size_t v = 0; v < mesh.vertices.size(); v += floatsPerVertex)
+	{
+		view.radius = std::max(view.radius, glm::length(glm::vec3(mesh.vertices[v], mesh.vertices[v + 1], mesh.vertices[v + 2])));
+	}
+
+	// 각 단계는 바로 앞 단계를 단순화해서 만들고, 오차는 앞 단계까지의 오차에 더해서 원본 기준으로 유지한다
+	std::vector<uint32_t> indices;
+	std::vector<uint32_t> level = mesh.indices;
+	float error = 0.0f;
+	view.lodCount = 0;
+	maxLods = std::min(maxLods, MeshInfo::MAX_LODS);
+	while (true)
+	{
+		MeshLod &lod = view.lods[view.lodCount++];
+		lod.firstIndex = (unsigned int)indices.size();
+		lod.indexCount = (unsigned int)level.size();
+		lod.error = error;
+		indices.insert(indices.end(), level.begin(), level.end());
+		if (view.lodCount == maxLods || level.size() / 3 < MIN_LOD_TRIANGLES)
+		{
+			break;
+		}
+		size_t target = (size_t)(level.size() / 3 * LOD_REDUCTION) * 3;
+		float levelError;
+		std::vector<uint32_t> simplified = simplifyMesh(mesh.vertices.data(), floatsPerVertex, view.vertexCount, level, target, view.radius, levelError);
+		// 고정된 정점 때문에 거의 줄지 않으면 같은 단계를 하나 더 저장할 이유가 없다
+		if (simplified.size() > level.size() * 9 / 10)
+		{
+			break;
+		}
+		error += levelError;
+		level.swap(simplified);
+	}
+	ownedVertices.push_back(mesh.vertices);
+	ownedIndices.push_back(std::move(indices));
+	view.vertices = ownedVertices.back().data();
+	view.indices = ownedIndices.back().data();
+	view.indexCount = ownedIndices.back().size();
+	return (add(view));
+}
+
+unsigned int MeshArena::add(const MeshView &view)
+{
+	MeshInfo info;
+	info.baseVertex = (int)vertexTotal;
+	info.vertexCount = (unsigned int)view.vertexCount;
+	info.radius = view.radius;
+	info.lodCount = std::min(view.lodCount, MeshInfo::MAX_LODS);
+	for (unsigned int lod = 0; lod < info.lodCount; lod++)
+	{
+		info.lods[lod] = view.lods[lod];
+		info.lods[lod].firstIndex += (unsigned int)indexTotal;
+	}
+	vertexTotal += view.vertexCount;
+	indexTotal += view.indexCount;
+	views.push_back(view);
+	meshes.push_back(info);
+	return ((unsigned int)(meshes.size() - 1));
+}
+
+void MeshArena::createBuffers()
+{
+	clear();
+	glGenVertexArrays(1, &VAO);
+	glBindVertexArray(VAO);
+	glGenBuffers(1, &VBO);
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(vertexTotal * floatsPerVertex * sizeof(float)), NULL, GL_STATIC_DRAW);
+	glGenBuffers(1, &EBO);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)(indexTotal * sizeof(uint32_t)), NULL, GL_STATIC_DRAW);
+	// 블록을 원래 있던 메모리(매핑된 캐시 파일 포함) 에서 바로 올린다
+	size_t vertexOffset = 0;
+	size_t indexOffset = 0;
+	for (const MeshView &view : views)
+	{
+		size_t vertexBytes = view.vertexCount * floatsPerVertex * sizeof(float);
+		glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)vertexOffset, (GLsizeiptr)vertexBytes, view.vertices);
+		glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, (GLintptr)indexOffset, (GLsizeiptr)(view.indexCount * sizeof(uint32_t)), view.indices);
+		vertexOffset += vertexBytes;
+		indexOffset += view.indexCount * sizeof(uint32_t);
+	}
+}
+
+unsigned int MeshArena::selectLod(unsigned int mesh, float distance, float pixelsPerUnit, float pixelError, float hysteresis, unsigned int currentLod) const
+{
+	const MeshInfo &info = meshes[mesh];
+	// 카메라가 구 안에 있으면 가장 자세한 단계
+	if (distance <= 0.0f)
+	{
+		return (0);
+	}
+	for (unsigned int lod = info.lodCount - 1; lod > 0; lod--)
+	{
+		float limit = lod > currentLod ? pixelError * (1.0f - hysteresis) : pixelError;
+		if (info.lods[lod].error * pixelsPerUnit <= limit * distance)
+		{
+			return (lod);
+		}
+	}
+	return (0);
+}
+
+MeshDraw MeshArena::makeDraw(unsigned int mesh, unsigned int lod, const glm::mat4 &model) const
+{
+	const MeshInfo &info = meshes[mesh];
+	MeshDraw draw;
+	draw.model = model;
+	draw.firstIndex = info.lods[lod].firstIndex;
+	draw.indexCount = info.lods[lod].indexCount;
+	draw.baseVertex = info.baseVertex;
+	return (draw);
+}
+
+void MeshArena::bind() const
+{
+	glBindVertexArray(VAO);
+}
+
+void MeshArena::draw(const MeshDraw &draw) const
+{
+	glDrawElementsBaseVertex(GL_TRIANGLES, (GLsizei)draw.indexCount, GL_UNSIGNED_INT, (void *)(draw.firstIndex * sizeof(uint32_t)), draw.baseVertex);
+}
+
+void MeshArena::printStats() const
+{
+	for (size_t i = 0; i < meshes.size(); i++)
+	{
+		const MeshInfo &info = meshes[i];
+		std::cout << "Mesh " << i << ": " << info.vertexCount << " vertices, LOD triangles";
+		for (unsigned int lod = 0; lod < info.lodCount; lod++)
+		{
+			std::cout << " " << info.lods[lod].indexCount / 3 << " (error " << info.lods[lod].error << ")";
+		}
+		std::cout << std::endl;
+	}
+	std::cout << "Mesh arena: " << vertexTotal * floatsPerVertex * sizeof(float) / 1024.0 << " KB vertices, " << indexTotal * sizeof(uint32_t) / 1024.0 << " KB indices" << std::endl;
+}
@@ -0,0 +1,141 @@
+#ifndef MESH_ARENA_H
+#define MESH_ARENA_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+// 메쉬 하나의 상세도 단계, 정점은 모든 단계가 같이 쓰고 인덱스 범위만 다르다
+struct MeshLod
+{
+	unsigned int firstIndex;
+	unsigned int indexCount;
+	// simplifyMesh 가 돌려준 오차(quadric 비용의 제곱근, 물체 좌표계 단위), 화면에 투영한 오차로 단계를 고른다
+	float error;
+};
+
+struct MeshInfo
+{
+	static constexpr unsigned int MAX_LODS = 6;
+
+	int baseVertex;
+	unsigned int vertexCount;
+	// 물체 좌표계 원점을 중심으로 하는 바운딩 구의 반지름
+	float radius;
+	MeshLod lods[MAX_LODS];
+	unsigned int lodCount;
+};
+
+// 그리기 명령 하나, 렌더 스레드는 이 값만으로 그린다
+struct MeshDraw
+{
+	glm::mat4 model;
+	unsigned int firstIndex;
+	unsigned int indexCount;
+	int baseVertex;
+};
+
+// 메쉬 아레나의 메쉬를 그리는 물체 하나, lod 는 지난 프레임에 고른 단계로 히스테리시스에 사용한다
+struct MeshInstance
+{
+	unsigned int mesh;
+	glm::dvec3 position;
+	unsigned int lod;
+};
+
+// 정점 배열과 인덱스 배열로 된 메쉬, 정점은 floatsPerVertex 개의 float 이고 앞의 3개가 위치다
+struct MeshData
+{
+	std::vector<float> vertices;
+	std::vector<uint32_t> indices;
+};
+
+// LOD 까지 만들어진 메쉬 하나의 정점 / 인덱스 블록, lods 의 firstIndex 는 indices 의 시작 기준이다
+// 데이터는 가리키기만 하므로, 캐시 파일을 매핑한 메모리를 복사하지 않고 GPU 버퍼로 올릴 수 있다
+struct MeshView
+{
+	const float *vertices;
+	size_t vertexCount;
+	const uint32_t *indices;
+	size_t indexCount;
+	MeshLod lods[MeshInfo::MAX_LODS];
+	unsigned int lodCount;
+	float radius;
+};
+
+// 위치 + 텍스처 좌표(5 float) 정점으로 된 UV 구, rings 는 위도 방향, segments 는 경도 방향 분할 수
+MeshData generateSphereMesh(float radius, int rings, int segments);
+
+// 여러 메쉬의 정점과 인덱스를 큰 버퍼 하나씩에 모아둔다, 메쉬를 바꿀 때 VAO / 버퍼를 다시 바인딩하지 않는다
+// 메쉬를 추가할 때 quadric 단순화로 LOD 단계를 만들고, 단계별 인덱스를 원본 인덱스 바로 뒤에 이어서 저장한다
+// 단계마다 삼각형 수를 LOD_REDUCTION 배로 줄이고, 더 줄지 않거나 MAX_LODS 개가 되면 멈춘다
+// 메쉬마다 정점 / 인덱스 블록을 기록해두고 upload 에서 추가한 순서대로 glBufferSubData 로 올린다
+class MeshArena
+{
+	private:
+		static constexpr float LOD_REDUCTION = 0.5f;
+		// 단계가 이보다 적은 삼각형을 가지면 더 만들지 않는다
+		static const size_t MIN_LOD_TRIANGLES = 32;
+
+		size_t floatsPerVertex;
+		// 메쉬마다 하나, LOD 의 firstIndex 는 메쉬의 인덱스 블록 기준
+		std::vector<MeshView> views;
+		std::vector<MeshInfo> meshes;
+		size_t vertexTotal;
+		size_t indexTotal;
+		// add 로 만든 메쉬의 데이터, 바깥 벡터가 커져도 안쪽 벡터의 데이터 주소는 바뀌지 않으므로 views 가 가리킬 수 있다
+		std::vector<std::vector<float>> ownedVertices;
+		std::vector<std::vector<uint32_t>> ownedIndices;
+
+		unsigned int VAO;
+		unsigned int VBO;
+		unsigned int EBO;
+
+		void createBuffers();
+
+	public:
+		explicit MeshArena(size_t floatsPerVertex);
+		~MeshArena();
+
+		MeshArena(const MeshArena &) = delete;
+		MeshArena &operator=(const MeshArena &) = delete;
+
+		// 메쉬를 추가하고 LOD 를 만든다, 반환값은 메쉬 번호. upload 전에 모두 추가해야 한다
+		unsigned int add(const MeshData &mesh, unsigned int maxLods = MeshInfo::MAX_LODS);
+		// LOD 까지 만들어진 메쉬를 복사하지 않고 추가한다, view 가 가리키는 데이터는 upload 가 끝날 때까지 유효해야 한다
+		unsigned int add(const MeshView &view);
+		// 메쉬의 블록, add(MeshData) 로 만든 메쉬는 언제나 유효하고 add(MeshView) 로 추가한 메쉬는 원래 데이터가 유효한 동안만 유효하다
+		const MeshView &getView(unsigned int mesh) const
+		{
+			return (views[mesh]);
+		}
+		// GL 버퍼를 만들고 Layout 으로 정점 속성을 설정한다, GL 컨텍스트가 있는 스레드에서 호출
+		template <typename Layout>
+		void upload()
+		{
+			static_assert(Layout::stride % sizeof(float) == 0, "Layout stride must be a whole number of floats");
+			createBuffers();
+			Layout::apply();
+			glBindVertexArray(0);
+		}
+
+		const MeshInfo &getMesh(unsigned int mesh) const
+		{
+			return (meshes[mesh]);
+		}
+
+		// 화면에 투영한 오차가 pixelError 픽셀 이하인 가장 거친 단계를 고른다
+		// pixelsPerUnit 은 거리 1 에서 길이 1 이 차지하는 픽셀 수, distance 는 카메라에서 바운딩 구 표면까지의 거리
+		// 경계에서 단계가 매 프레임 바뀌며 깜빡이지 않도록, 지금보다 거친 단계로 갈 때는 오차가 (1 - hysteresis) 배 이하여야 한다
+		unsigned int selectLod(unsigned int mesh, float distance, float pixelsPerUnit, float pixelError, float hysteresis, unsigned int currentLod) const;
+		MeshDraw makeDraw(unsigned int mesh, unsigned int lod, const glm::mat4 &model) const;
+		void bind() const;
+		void draw(const MeshDraw &draw) const;
+		// 메쉬별 단계 수와 단계마다 삼각형 수, 버퍼 크기를 출력한다
+		void printStats() const;
+		void clear();
+};
+
+#endif
@@ -0,0 +1,214 @@
+#include "MeshCache.h"
+#include "SourceStamp.h"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace
+{
+	const uint32_t CACHE_MAGIC = 0x434d5347; // "GSMC"
+	const uint32_t CACHE_VERSION = 2;
+	// 블록 시작을 캐시 라인에 맞춰서 매핑한 메모리에서 바로 복사할 때 정렬되지 않은 접근이 없게 한다
+	const uint64_t BLOB_ALIGNMENT = 64;
+
+	struct MeshCacheHeader
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint64_t sourceSize;
+		int64_t sourceTime;
+		uint64_t sourceHash;
+		uint32_t stride;
+		uint32_t attributeCount;
+		uint64_t vertexCount;
+		uint64_t indexCount;
+		uint32_t lodCount;
+		float radius;
+		uint64_t vertexOffset;
+		uint64_t indexOffset;
+		uint64_t lodOffset;
+		uint64_t fileSize;
+	};
+
+	// FNV-1a 64비트 해시
+	uint64_t fnv1a(const std::string &data, uint64_t hash = 0xcbf29ce484222325ULL)
+	{
+		for (unsigned char c : data)
+		{
+			hash ^= c;
+			hash *= 0x100000001b3ULL;
+		}
+		return (hash);
+	}
+
+	uint64_t alignBlob(uint64_t offset)
+	{
+		return ((offset + BLOB_ALIGNMENT - 1) / BLOB_ALIGNMENT * BLOB_ALIGNMENT);
+	}
+
+	bool sameAttributes(const VertexAttributeFormat *a, const VertexAttributeFormat *b, size_t count)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			if (a[i].type != b[i].type || a[i].components != b[i].components || a[i].normalized != b[i].normalized || a[i].integer != b[i].integer || a[i].offset != b[i].offset)
+			{
+				return (false);
+			}
+		}
+		return (true);
+	}
+
+	void writePadding(std::ofstream &file, uint64_t offset)
+	{
+		static const char zeros[BLOB_ALIGNMENT] = {};
+		file.write(zeros, (std::streamsize)(alignBlob(offset) - offset));
+	}
+}
+
+MeshCache::MeshCache(const std::string &directory) : directory(directory)
+{
+	std::error_code error;
+	std::filesystem::create_directories(directory, error);
+}
+
+std::string MeshCache::pathFor(const std::string &source) const
+{
+	char name[32];
+	std::snprintf(name, sizeof(name), "%016llx.mesh", (unsigned long long)fnv1a(source));
+	return (directory + name);
+}
+
+bool MeshCache::load(const std::string &source, const VertexAttributeFormat *attributes, size_t attributeCount, size_t stride, CachedMesh &mesh) const
+{
+	SourceStamp stamp;
+	std::string path = pathFor(source);
+	if (stride % sizeof(float) != 0 || !getSourceStamp(source, stamp) || !mesh.file.open(path))
+	{
+		return (false);
+	}
+	const unsigned char *data = mesh.file.getData();
+	size_t size = mesh.file.getSize();
+	MeshCacheHeader header;
+	if (size < sizeof(header))
+	{
+		mesh.file.close();
+		return (false);
+	}
+	std::memcpy(&header, data, sizeof(header));
+	// 블록 범위가 파일 안에 있는지 확인해서 잘렸거나 손상된 파일을 그대로 GPU 로 넘기지 않는다
+	bool valid = header.magic == CACHE_MAGIC && header.version == CACHE_VERSION && header.sourceSize == stamp.size
+		&& header.fileSize == size && header.stride == stride && header.attributeCount == attributeCount
+		&& sizeof(header) + attributeCount * sizeof(VertexAttributeFormat) <= size
+		&& header.lodCount > 0 && header.lodCount <= MeshInfo::MAX_LODS
+		&& header.vertexOffset % BLOB_ALIGNMENT == 0 && header.indexOffset % BLOB_ALIGNMENT == 0 && header.lodOffset % BLOB_ALIGNMENT == 0
+		&& header.vertexCount <= size / stride && header.vertexOffset <= size - header.vertexCount * stride
+		&& header.indexCount <= size / sizeof(uint32_t) && header.indexOffset <= size - header.indexCount * sizeof(uint32_t)
+		&& header.lodOffset <= size - header.lodCount * sizeof(MeshLod);
+	if (valid)
+	{
+		std::vector<VertexAttributeFormat> stored(attributeCount);
+		std::memcpy(stored.data(), data + sizeof(header), attributeCount * sizeof(VertexAttributeFormat));
+		valid = sameAttributes(stored.data(), attributes, attributeCount);
+	}
+	if (!valid)
+	{
+		mesh.file.close();
+		return (false);
+	}
+	// 크기가 같고 수정 시간만 다르면 (다시 체크아웃, 복사) 내용을 해시해서 확인한다
+	// 같으면 다음 실행에서 다시 해시하지 않도록 헤더의 시간을 갱신한다, 매핑을 닫아야 쓸 수 있는 플랫폼이 있으므로 닫고 다시 연다
+	if (header.sourceTime != stamp.modified)
+	{
+		mesh.file.close();
+		if (hashFileContents(source) != header.sourceHash)
+		{
+			return (false);
+		}
+		header.sourceTime = stamp.modified;
+		{
+			std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+			file.write((const char *)&header, sizeof(header));
+		}
+		if (!mesh.file.open(path) || mesh.file.getSize() != size)
+		{
+			mesh.file.close();
+			return (false);
+		}
+		data = mesh.file.getData();
+	}
+
+	MeshView &view = mesh.view;
+	view.vertices = (const float *)(data + header.vertexOffset);
+	view.vertexCount = (size_t)header.vertexCount;
+	view.indices = (const uint32_t *)(data + header.indexOffset);
+	view.indexCount = (size_t)header.indexCount;
+	view.lodCount = header.lodCount;
+	view.radius = header.radius;
+	std::memcpy(view.lods, data + header.lodOffset, header.lodCount * sizeof(MeshLod));
+	for (unsigned int lod = 0; lod < view.lodCount; lod++)
+	{
+		if (view.lods[lod].firstIndex > view.indexCount || view.lods[lod].indexCount > view.indexCount - view.lods[lod].firstIndex)
+		{
+			mesh.file.close();
+			return (false);
+		}
+	}
+	return (true);
+}
+
+bool MeshCache::store(const std::string &source, const VertexAttributeFormat *attributes, size_t attributeCount, size_t stride, const MeshView &view) const
+{
+	SourceStamp stamp;
+	if (view.lodCount == 0 || view.lodCount > MeshInfo::MAX_LODS || !getSourceStamp(source, stamp))
+	{
+		return (false);
+	}
+	MeshCacheHeader header = {};
+	header.magic = CACHE_MAGIC;
+	header.version = CACHE_VERSION;
+	header.sourceSize = stamp.size;
+	header.sourceTime = stamp.modified;
+	header.sourceHash = hashFileContents(source);
+	header.stride = (uint32_t)stride;
+	header.attributeCount = (uint32_t)attributeCount;
+	header.vertexCount = view.vertexCount;
+	header.indexCount = view.indexCount;
+	header.lodCount = view.lodCount;
+	header.radius = view.radius;
+	header.vertexOffset = alignBlob(sizeof(header) + attributeCount * sizeof(VertexAttributeFormat));
+	header.indexOffset = alignBlob(header.vertexOffset + view.vertexCount * stride);
+	header.lodOffset = alignBlob(header.indexOffset + view.indexCount * sizeof(uint32_t));
+	header.fileSize = header.lodOffset + view.lodCount * sizeof(MeshLod);
+
+	// 반쯤 쓰인 파일을 다른 프로세스가 읽지 않도록 임시 파일에 쓴 뒤 이름을 바꾼다
+	std::string path = pathFor(source);
+	std::string temporary = path + ".tmp";
+	bool written;
+	{
+		std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+		file.write((const char *)&header, sizeof(header));
+		file.write((const char *)attributes, (std::streamsize)(attributeCount * sizeof(VertexAttributeFormat)));
+		writePadding(file, sizeof(header) + attributeCount * sizeof(VertexAttributeFormat));
+		file.write((const char *)view.vertices, (std::streamsize)(view.vertexCount * stride));
+		writePadding(file, header.vertexOffset + view.vertexCount * stride);
+		file.write((const char *)view.indices, (std::streamsize)(view.indexCount * sizeof(uint32_t)));
+		writePadding(file, header.indexOffset + view.indexCount * sizeof(uint32_t));
+		file.write((const char *)view.lods, (std::streamsize)(view.lodCount * sizeof(MeshLod)));
+		written = (bool)file;
+	}
+	std::error_code error;
+	if (written)
+	{
+		std::filesystem::rename(temporary, path, error);
+	}
+	// 쓰기나 이름 바꾸기에 실패하면 임시 파일을 남기지 않는다
+	if (!written || error)
+	{
+		std::filesystem::remove(temporary, error);
+		return (false);
+	}
+	return (true);
+}
@@ -0,0 +1,52 @@
+#ifndef MESH_CACHE_H
+#define MESH_CACHE_H
+
+#include "MappedFile.h"
+#include "MeshArena.h"
+#include "VertexLayout.h"
+
+#include <cstdint>
+#include <string>
+
+// 캐시 파일에서 읽은 메쉬, view 는 file 을 매핑한 메모리를 가리키므로 MeshArena::upload 가 끝날 때까지 살아 있어야 한다
+struct CachedMesh
+{
+	MappedFile file;
+	MeshView view;
+};
+
+// 가져오기(import)와 LOD 생성이 끝난 메쉬를 GPU 버퍼에 올릴 형식 그대로 디스크에 저장해서 다음 실행부터 파싱과 단순화를 건너뛴다
+// 파일은 헤더, 정점 형식, 64바이트 정렬된 정점 / 인덱스 / LOD 블록 순서이고, 읽을 때는 매핑한 메모리를 그대로 glBufferSubData 에 넘긴다
+// 캐시 파일은 원본 경로로 찾고, 헤더에 원본의 크기 / 수정 시간 / 내용 해시를 기록한다
+// 크기와 수정 시간이 같으면 원본을 읽지 않고 바로 사용하고, 시간만 다르면 내용을 해시해서 같을 때만 사용한다
+// 원본이 바뀌었거나 정점 형식 / 버전이 다르면 없는 것으로 본다
+class MeshCache
+{
+	private:
+		std::string directory;
+
+		std::string pathFor(const std::string &source) const;
+
+	public:
+		MeshCache(const std::string &directory = "./mesh_cache/");
+
+		// 캐시가 있고 원본과 형식이 맞으면 mesh 를 채우고 true
+		bool load(const std::string &source, const VertexAttributeFormat *attributes, size_t attributeCount, size_t stride, CachedMesh &mesh) const;
+		bool store(const std::string &source, const VertexAttributeFormat *attributes, size_t attributeCount, size_t stride, const MeshView &view) const;
+
+		template <typename Layout>
+		bool load(const std::string &source, CachedMesh &mesh) const
+		{
+			static constexpr auto attributes = Layout::describe();
+			return (load(source, attributes.data(), attributes.size(), Layout::stride, mesh));
+		}
+
+		template <typename Layout>
+		bool store(const std::string &source, const MeshView &view) const
+		{
+			static constexpr auto attributes = Layout::describe();
+			return (store(source, attributes.data(), attributes.size(), Layout::stride, view));
+		}
+};
+
+#endif
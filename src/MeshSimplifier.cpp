@@ -0,0 +1,280 @@
+#include "MeshSimplifier.h"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_set>
+
+namespace
+{
+	// 평면들까지의 거리 제곱의 합을 나타내는 대칭 4x4 행렬, 위쪽 삼각형 10개 성분만 저장한다
+	// 합치는 동안 값이 커지므로 double 로 계산한다
+	struct Quadric
+	{
+		double a2, ab, ac, ad;
+		double b2, bc, bd;
+		double c2, cd;
+		double d2;
+
+		Quadric() : a2(0.0), ab(0.0), ac(0.0), ad(0.0), b2(0.0), bc(0.0), bd(0.0), c2(0.0), cd(0.0), d2(0.0)
+		{
+		}
+
+		void addPlane(double a, double b, double c, double d)
+		{
+			a2 += a * a;
+			ab += a * b;
+			ac += a * c;
+			ad += a * d;
+			b2 += b * b;
+			bc += b * c;
+			bd += b * d;
+			c2 += c * c;
+			cd += c * d;
+			d2 += d * d;
+		}
+
+		void add(const Quadric &other)
+		{
+			a2 += other.a2;
+			ab += other.ab;
+			ac += other.ac;
+			ad += other.ad;
+			b2 += other.b2;
+			bc += other.bc;
+			bd += other.bd;
+			c2 += other.c2;
+			cd += other.cd;
+			d2 += other.d2;
+		}
+
+		// 점 p 에서 모든 평면까지의 거리 제곱의 합
+		double evaluate(const glm::vec3 &p) const
+		{
+			double x = p.x;
+			double y = p.y;
+			double z = p.z;
+			double result = a2 * x * x + b2 * y * y + c2 * z * z + d2
+				+ 2.0 * (ab * x * y + ac * x * z + bc * y * z + ad * x + bd * y + cd * z);
+			return (std::max(result, 0.0));
+		}
+	};
+
+	struct Collapse
+	{
+		uint32_t from;
+		uint32_t to;
+		double cost;
+
+		bool operator<(const Collapse &other) const
+		{
+			return (cost < other.cost);
+		}
+	};
+
+	uint64_t edgeKey(uint32_t a, uint32_t b)
+	{
+		return (((uint64_t)a << 32) | b);
+	}
+
+	// 정점마다 그 정점을 쓰는 삼각형 목록, offsets[v] 부터 offsets[v + 1] 까지가 정점 v 의 삼각형이다
+	struct Adjacency
+	{
+		std::vector<uint32_t> offsets;
+		std::vector<uint32_t> triangles;
+
+		void build(const std::vector<uint32_t> &indices, size_t vertexCount)
+		{
+			offsets.assign(vertexCount + 1, 0);
+			for (uint32_t index : indices)
+			{
+				offsets[index + 1]++;
+			}
+			for (size_t v = 0; v < vertexCount; v++)
+			{
+				offsets[v + 1] += offsets[v];
+			}
+			triangles.resize(indices.size());
+			std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+			for (size_t i = 0; i < indices.size(); i++)
+			{
+				triangles[fill[indices[i]]++] = (uint32_t)(i / 3);
+			}
+		}
+	};
+
+	// from 을 to 로 옮겼을 때 from 주변의 삼각형이 뒤집히거나 거의 납작해지면 true
+	bool flipsTriangle(const std::vector<glm::vec3> &positions, const std::vector<uint32_t> &indices, const Adjacency &adjacency, uint32_t from, uint32_t to)
+	{
+		for (uint32_t k = adjacency.offsets[from]; k < adjacency.offsets[from + 1]; k++)
+		{
+			const uint32_t *triangle = &indices[adjacency.triangles[k] * 3];
+			if (triangle[0] == to || triangle[1] == to || triangle[2] == to)
+			{
+				// from 과 to 를 모두 쓰는 삼각형은 합치면 사라진다
+				continue;
+			}
+			glm::vec3 before[3];
+			glm::vec3 after[3];
+			for (int corner = 0; corner < 3; corner++)
+			{
+				before[corner] = positions[triangle[corner]];
+				after[corner] = triangle[corner] == from ? positions[to] : before[corner];
+			}
+			glm::vec3 normalBefore = glm::cross(before[1] - before[0], before[2] - before[0]);
+			glm::vec3 normalAfter = glm::cross(after[1] - after[0], after[2] - after[0]);
+			// 법선이 60도 넘게 돌아가면 뒤집힌 것으로 본다
+			if (glm::dot(normalBefore, normalAfter) <= 0.5f * glm::length(normalBefore) * glm::length(normalAfter))
+			{
+				return (true);
+			}
+		}
+		return (false);
+	}
+}
+
+std::vector<uint32_t> simplifyMesh(const float *vertices, size_t floatsPerVertex, size_t vertexCount, const std::vector<uint32_t> &indices, size_t targetIndexCount, float maxError, float &error)
+{
+	error = 0.0f;
+	std::vector<uint32_t> result(indices);
+	std::vector<glm::vec3> positions(vertexCount);
+	for (size_t v = 0; v < vertexCount; v++)
+	{
+		const float *vertex = vertices + v * floatsPerVertex;
+		positions[v] = glm::vec3(vertex[0], vertex[1], vertex[2]);
+	}
+
+	// 반대 방향 변이 없는 변은 경계, 그 양 끝 정점은 고정한다
+	std::vector<bool> locked(vertexCount, false);
+	std::unordered_set<uint64_t> edges;
+	edges.reserve(result.size());
+	for (size_t i = 0; i < result.size(); i += 3)
+	{
+		for (int corner = 0; corner < 3; corner++)
+		{
+			edges.insert(edgeKey(result[i + corner], result[i + (corner + 1) % 3]));
+		}
+	}
+	for (size_t i = 0; i < result.size(); i += 3)
+	{
+		for (int corner = 0; corner < 3; corner++)
+		{
+			uint32_t a = result[i + corner];
+			uint32_t b = result[i + (corner + 1) % 3];
+			if (edges.find(edgeKey(b, a)) == edges.end())
+			{
+				locked[a] = true;
+				locked[b] = true;
+			}
+		}
+	}
+
+	// 정점마다 주변 삼각형 평면의 quadric 을 더해둔다
+	std::vector<Quadric> quadrics(vertexCount);
+	for (size_t i = 0; i < result.size(); i += 3)
+	{
+		glm::vec3 p0 = positions[result[i]];
+		glm::vec3 normal = glm::cross(positions[result[i + 1]] - p0, positions[result[i + 2]] - p0);
+		float length = glm::length(normal);
+		if (length == 0.0f)
+		{
+			continue;
+		}
+		normal = normal / length;
+		Quadric plane;
+		plane.addPlane(normal.x, normal.y, normal.z, -glm::dot(normal, p0));
+		for (int corner = 0; corner < 3; corner++)
+		{
+			quadrics[result[i + corner]].add(plane);
+		}
+	}
+
+	double maxCost = (double)maxError * (double)maxError;
+	double worstCost = 0.0;
+	Adjacency adjacency;
+	std::vector<Collapse> collapses;
+	std::vector<uint32_t> remap(vertexCount);
+	std::vector<bool> touched(vertexCount);
+	while (result.size() > targetIndexCount)
+	{
+		adjacency.build(result, vertexCount);
+		collapses.clear();
+		for (size_t i = 0; i < result.size(); i += 3)
+		{
+			for (int corner = 0; corner < 3; corner++)
+			{
+				uint32_t a = result[i + corner];
+				uint32_t b = result[i + (corner + 1) % 3];
+				if (!locked[a])
+				{
+					collapses.push_back({a, b, quadrics[a].evaluate(positions[b])});
+				}
+				if (!locked[b])
+				{
+					collapses.push_back({b, a, quadrics[b].evaluate(positions[a])});
+				}
+			}
+		}
+		std::sort(collapses.begin(), collapses.end());
+
+		// 한 번에 하나씩 합치면 너무 느리므로, 서로 영향을 주지 않는 것끼리 비용이 낮은 순서로 한꺼번에 합친다
+		// 정점 하나를 합치면 삼각형이 두 개 정도 사라지므로 남은 삼각형 수의 절반까지만 합친다
+		size_t budget = std::max<size_t>((result.size() - targetIndexCount) / 6, 1);
+		size_t collapsed = 0;
+		for (uint32_t v = 0; v < vertexCount; v++)
+		{
+			remap[v] = v;
+		}
+		std::fill(touched.begin(), touched.end(), false);
+		for (const Collapse &collapse : collapses)
+		{
+			if (collapse.cost > maxCost || collapsed >= budget)
+			{
+				break;
+			}
+			if (touched[collapse.from] || touched[collapse.to])
+			{
+				continue;
+			}
+			if (flipsTriangle(positions, result, adjacency, collapse.from, collapse.to))
+			{
+				continue;
+			}
+			remap[collapse.from] = collapse.to;
+			quadrics[collapse.to].add(quadrics[collapse.from]);
+			worstCost = std::max(worstCost, collapse.cost);
+			collapsed++;
+			// from 주변 삼각형의 모양이 바뀌었으므로, 이번 단계에서는 그 삼각형의 정점을 더 건드리지 않는다
+			for (uint32_t k = adjacency.offsets[collapse.from]; k < adjacency.offsets[collapse.from + 1]; k++)
+			{
+				const uint32_t *triangle = &result[adjacency.triangles[k] * 3];
+				touched[triangle[0]] = true;
+				touched[triangle[1]] = true;
+				touched[triangle[2]] = true;
+			}
+		}
+		if (collapsed == 0)
+		{
+			break;
+		}
+
+		// 합친 정점으로 인덱스를 바꾸고, 두 정점이 같아져 납작해진 삼각형은 지운다
+		size_t write = 0;
+		for (size_t i = 0; i < result.size(); i += 3)
+		{
+			uint32_t a = remap[result[i]];
+			uint32_t b = remap[result[i + 1]];
+			uint32_t c = remap[result[i + 2]];
+			if (a != b && b != c && c != a)
+			{
+				result[write++] = a;
+				result[write++] = b;
+				result[write++] = c;
+			}
+		}
+		result.resize(write);
+	}
+	error = (float)std::sqrt(worstCost);
+	return (result);
+}
@@ -0,0 +1,18 @@
+#ifndef MESH_SIMPLIFIER_H
+#define MESH_SIMPLIFIER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// quadric error metric(QEM) 로 삼각형 메쉬를 단순화한다
+// 정점 하나를 이웃 정점으로 합치는(half-edge collapse) 방식이라 새 정점을 만들지 않고 인덱스만 새로 만든다
+// 그래서 모든 LOD 가 원본 정점 버퍼 하나를 같이 쓸 수 있고, 텍스처 좌표 같은 속성을 보간할 필요가 없다
+// 경계 변(다른 삼각형과 공유하지 않는 변) 위의 정점은 움직이지 않는다, 텍스처 좌표가 갈라지는 이음새(seam) 도 인덱스로 보면 경계이므로 함께 고정된다
+// vertices 는 floatsPerVertex 개의 float 로 된 정점 배열이고 앞의 3개가 위치다
+// 인덱스 수가 targetIndexCount 이하가 되거나, 더 합치면 오차가 maxError 를 넘거나, 합칠 수 있는 정점이 없으면 멈춘다
+// 오차는 합친 collapse 의 quadric 비용(정점이 모아온 원래 삼각형 평면들까지 거리의 제곱합) 중 가장 큰 값의 제곱근이고, error 에 돌려준다
+// 제곱합이므로 옮긴 정점이 그 평면 중 어느 하나에서 벗어난 거리보다 작지 않은 상한이다 (위치와 같은 단위, 표면 사이의 실제 최대 거리는 아니다)
+std::vector<uint32_t> simplifyMesh(const float *vertices, size_t floatsPerVertex, size_t vertexCount, const std::vector<uint32_t> &indices, size_t targetIndexCount, float maxError, float &error);
+
+#endif
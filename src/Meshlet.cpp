@@ -0,0 +1,349 @@
+#include "Meshlet.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+// SIMD 경로는 컴파일 옵션으로 선택한다 (CMake 의 ENABLE_AVX2 옵션 참고)
+#if defined(__AVX2__)
+	#define MESHLET_AVX2
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define MESHLET_SSE2
+#endif
+
+#if defined(MESHLET_AVX2)
+	#include <immintrin.h>
+#elif defined(MESHLET_SSE2)
+	#include <emmintrin.h>
+#endif
+
+namespace
+{
+	// 한 번에 검사하는 meshlet 수, SoA 배열의 길이는 항상 이 값의 배수다
+	const size_t LANES = 8;
+	const uint32_t UNUSED = 0xffffffffu;
+}
+
+MeshletMesh::MeshletMesh(size_t floatsPerVertex) : floatsPerVertex(floatsPerVertex), VAO(0), VBO(0), EBO(0)
+{
+}
+
+MeshletMesh::~MeshletMesh()
+{
+	clear();
+}
+
+void MeshletMesh::clear()
+{
+	if (VAO != 0)
+	{
+		glDeleteVertexArrays(1, &VAO);
+		glDeleteBuffers(1, &VBO);
+		glDeleteBuffers(1, &EBO);
+		VAO = 0;
+		VBO = 0;
+		EBO = 0;
+	}
+}
+
+void MeshletMesh::build(const MeshData &mesh)
+{
+	vertices = mesh.vertices;
+	indices.clear();
+	meshlets.clear();
+	size_t vertexCount = mesh.vertices.size() / floatsPerVertex;
+	size_t triangleCount = mesh.indices.size() / 3;
+	std::vector<glm::vec3> positions(vertexCount);
+	for (size_t v = 0; v < vertexCount; v++)
+	{
+		positions[v] = glm::vec3(mesh.vertices[v * floatsPerVertex], mesh.vertices[v * floatsPerVertex + 1], mesh.vertices[v * floatsPerVertex + 2]);
+	}
+
+	// 정점마다 그 정점을 쓰는 삼각형 목록
+	std::vector<uint32_t> offsets(vertexCount + 1, 0);
+	for (uint32_t index : mesh.indices)
+	{
+		offsets[index + 1]++;
+	}
+	for (size_t v = 0; v < vertexCount; v++)
+	{
+		offsets[v + 1] += offsets[v];
+	}
+	std::vector<uint32_t> adjacency(mesh.indices.size());
+	std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+	for (size_t i = 0; i < mesh.indices.size(); i++)
+	{
+		adjacency[fill[mesh.indices[i]]++] = (uint32_t)(i / 3);
+	}
+
+	// 이미 meshlet 에 들어간 삼각형, 지금 만드는 meshlet 에서 정점의 번호(없으면 UNUSED)
+	std::vector<bool> emitted(triangleCount, false);
+	std::vector<uint32_t> local(vertexCount, UNUSED);
+	std::vector<uint32_t> meshletVertices;
+	size_t nextSeed = 0;
+	uint32_t seed = UNUSED;
+	while (true)
+	{
+		// 이웃이 없으면 아직 쓰지 않은 첫 삼각형에서 새로 시작한다
+		if (seed == UNUSED)
+		{
+			while (nextSeed < triangleCount && emitted[nextSeed])
+			{
+				nextSeed++;
+			}
+			if (nextSeed == triangleCount)
+			{
+				break;
+			}
+			seed = (uint32_t)nextSeed;
+		}
+		Meshlet meshlet;
+		meshlet.firstIndex = (unsigned int)indices.size();
+		meshlet.triangleCount = 0;
+		meshletVertices.clear();
+		uint32_t triangle = seed;
+		seed = UNUSED;
+		while (triangle != UNUSED)
+		{
+			const uint32_t *corners = &mesh.indices[triangle * 3];
+			for (int corner = 0; corner < 3; corner++)
+			{
+				if (local[corners[corner]] == UNUSED)
+				{
+					local[corners[corner]] = (uint32_t)meshletVertices.size();
+					meshletVertices.push_back(corners[corner]);
+				}
+			}
+			indices.insert(indices.end(), corners, corners + 3);
+			emitted[triangle] = true;
+			meshlet.triangleCount++;
+			if (meshlet.triangleCount == MAX_TRIANGLES)
+			{
+				break;
+			}
+
+			// meshlet 의 정점을 쓰는 삼각형 중 새 정점이 가장 적게 필요한 것을 다음으로 고른다, 그래야 meshlet 이 둥글게 자란다
+			triangle = UNUSED;
+			int bestNew = 4;
+			for (uint32_t vertex : meshletVertices)
+			{
+				for (uint32_t k = offsets[vertex]; k < offsets[vertex + 1]; k++)
+				{
+					uint32_t candidate = adjacency[k];
+					if (emitted[candidate])
+					{
+						continue;
+					}
+					const uint32_t *candidateCorners = &mesh.indices[candidate * 3];
+					int newVertices = (local[candidateCorners[0]] == UNUSED) + (local[candidateCorners[1]] == UNUSED) + (local[candidateCorners[2]] == UNUSED);
+					if (newVertices < bestNew)
+					{
+						bestNew = newVertices;
+						triangle = candidate;
+					}
+				}
+			}
+			if (triangle != UNUSED && meshletVertices.size() + bestNew > MAX_VERTICES)
+			{
+				// 가득 찼으면 그 이웃 삼각형에서 다음 meshlet 을 시작한다
+				seed = triangle;
+				triangle = UNUSED;
+			}
+		}
+
+		// 바운딩 구는 정점 박스의 중심을 기준으로 한다
+		Aabb box;
+		for (uint32_t vertex : meshletVertices)
+		{
+			box.grow(positions[vertex]);
+			local[vertex] = UNUSED;
+		}
+		meshlet.vertexCount = (unsigned int)meshletVertices.size();
+		meshlet.center = box.center();
+		meshlet.radius = 0.0f;
+		for (uint32_t vertex : meshletVertices)
+		{
+			meshlet.radius = std::max(meshlet.radius, glm::length(positions[vertex] - meshlet.center));
+		}
+
+		// 원뿔 축은 법선의 평균, 퍼진 정도는 축과 가장 많이 벌어진 법선으로 정한다
+		std::vector<glm::vec3> normals;
+		glm::vec3 axis(0.0f);
+		for (unsigned int i = meshlet.firstIndex; i < meshlet.firstIndex + meshlet.triangleCount * 3; i += 3)
+		{
+			glm::vec3 p0 = positions[indices[i]];
+			glm::vec3 normal = glm::cross(positions[indices[i + 1]] - p0, positions[indices[i + 2]] - p0);
+			float length = glm::length(normal);
+			if (length > 0.0f)
+			{
+				normals.push_back(normal / length);
+				axis = axis + normals.back();
+			}
+		}
+		float axisLength = glm::length(axis);
+		meshlet.coneAxis = axisLength > 0.0f ? axis / axisLength : glm::vec3(0.0f, 0.0f, 1.0f);
+		float minDot = axisLength > 0.0f ? 1.0f : -1.0f;
+		for (const glm::vec3 &normal : normals)
+		{
+			minDot = std::min(minDot, glm::dot(normal, meshlet.coneAxis));
+		}
+		meshlet.coneCutoff = minDot <= 0.0f ? 2.0f : std::sqrt(1.0f - minDot * minDot);
+		meshlets.push_back(meshlet);
+	}
+
+	size_t padded = (meshlets.size() + LANES - 1) / LANES * LANES;
+	// 채워넣은 자리는 반지름이 음수라 어떤 프러스텀에도 들어가지 않는다
+	centerX.assign(padded, 0.0f);
+	centerY.assign(padded, 0.0f);
+	centerZ.assign(padded, 0.0f);
+	radii.assign(padded, -1e30f);
+	axisX.assign(padded, 0.0f);
+	axisY.assign(padded, 0.0f);
+	axisZ.assign(padded, 0.0f);
+	cutoffs.assign(padded, 2.0f);
+	for (size_t i = 0; i < meshlets.size(); i++)
+	{
+		centerX[i] = meshlets[i].center.x;
+		centerY[i] = meshlets[i].center.y;
+		centerZ[i] = meshlets[i].center.z;
+		radii[i] = meshlets[i].radius;
+		axisX[i] = meshlets[i].coneAxis.x;
+		axisY[i] = meshlets[i].coneAxis.y;
+		axisZ[i] = meshlets[i].coneAxis.z;
+		cutoffs[i] = meshlets[i].coneCutoff;
+	}
+}
+
+void MeshletMesh::createBuffers()
+{
+	clear();
+	glGenVertexArrays(1, &VAO);
+	glBindVertexArray(VAO);
+	glGenBuffers(1, &VBO);
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(vertices.size() * sizeof(float)), vertices.data(), GL_STATIC_DRAW);
+	glGenBuffers(1, &EBO);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)(indices.size() * sizeof(uint32_t)), indices.data(), GL_STATIC_DRAW);
+}
+
+size_t MeshletMesh::cull(const Frustum &frustum, const glm::vec3 &cameraPosition, FrameVector<IndexRange> &ranges) const
+{
+	size_t firstRange = ranges.size();
+	for (size_t base = 0; base < centerX.size(); base += LANES)
+	{
+		// 보이는 meshlet 의 비트가 켜진 마스크
+		// 프러스텀: 모든 평면에 대해 n·c + d >= -r
+		// 뒷면: 카메라에서 중심으로의 벡터 v 에 대해 v·axis >= cutoff * |v| + r 이면 구 안의 어느 점에서 봐도 모든 삼각형이 뒷면이다
+		unsigned int mask = 0;
+#if defined(MESHLET_AVX2)
+		__m256 cx = _mm256_loadu_ps(&centerX[base]);
+		__m256 cy = _mm256_loadu_ps(&centerY[base]);
+		__m256 cz = _mm256_loadu_ps(&centerZ[base]);
+		__m256 r = _mm256_loadu_ps(&radii[base]);
+		__m256 negativeR = _mm256_sub_ps(_mm256_setzero_ps(), r);
+		__m256 visible = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+		for (const glm::vec4 &plane : frustum.planes)
+		{
+			__m256 distance = _mm256_fmadd_ps(_mm256_set1_ps(plane.x), cx, _mm256_fmadd_ps(_mm256_set1_ps(plane.y), cy, _mm256_fmadd_ps(_mm256_set1_ps(plane.z), cz, _mm256_set1_ps(plane.w))));
+			visible = _mm256_and_ps(visible, _mm256_cmp_ps(distance, negativeR, _CMP_GE_OQ));
+		}
+		__m256 vx = _mm256_sub_ps(cx, _mm256_set1_ps(cameraPosition.x));
+		__m256 vy = _mm256_sub_ps(cy, _mm256_set1_ps(cameraPosition.y));
+		__m256 vz = _mm256_sub_ps(cz, _mm256_set1_ps(cameraPosition.z));
+		__m256 length = _mm256_sqrt_ps(_mm256_fmadd_ps(vx, vx, _mm256_fmadd_ps(vy, vy, _mm256_mul_ps(vz, vz))));
+		__m256 facing = _mm256_fmadd_ps(vx, _mm256_loadu_ps(&axisX[base]), _mm256_fmadd_ps(vy, _mm256_loadu_ps(&axisY[base]), _mm256_mul_ps(vz, _mm256_loadu_ps(&axisZ[base]))));
+		__m256 backface = _mm256_cmp_ps(facing, _mm256_fmadd_ps(_mm256_loadu_ps(&cutoffs[base]), length, r), _CMP_GE_OQ);
+		mask = (unsigned int)_mm256_movemask_ps(_mm256_andnot_ps(backface, visible));
+#elif defined(MESHLET_SSE2)
+		for (size_t half = 0; half < LANES; half += 4)
+		{
+			size_t i = base + half;
+			__m128 cx = _mm_loadu_ps(&centerX[i]);
+			__m128 cy = _mm_loadu_ps(&centerY[i]);
+			__m128 cz = _mm_loadu_ps(&centerZ[i]);
+			__m128 r = _mm_loadu_ps(&radii[i]);
+			__m128 negativeR = _mm_sub_ps(_mm_setzero_ps(), r);
+			__m128 visible = _mm_castsi128_ps(_mm_set1_epi32(-1));
+			for (const glm::vec4 &plane : frustum.planes)
+			{
+				__m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.x), cx), _mm_mul_ps(_mm_set1_ps(plane.y), cy)), _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.z), cz), _mm_set1_ps(plane.w)));
+				visible = _mm_and_ps(visible, _mm_cmpge_ps(distance, negativeR));
+			}
+			__m128 vx = _mm_sub_ps(cx, _mm_set1_ps(cameraPosition.x));
+			__m128 vy = _mm_sub_ps(cy, _mm_set1_ps(cameraPosition.y));
+			__m128 vz = _mm_sub_ps(cz, _mm_set1_ps(cameraPosition.z));
+			__m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)), _mm_mul_ps(vz, vz)));
+			__m128 facing = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, _mm_loadu_ps(&axisX[i])), _mm_mul_ps(vy, _mm_loadu_ps(&axisY[i]))), _mm_mul_ps(vz, _mm_loadu_ps(&axisZ[i])));
+			__m128 backface = _mm_cmpge_ps(facing, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&cutoffs[i]), length), r));
+			mask |= (unsigned int)_mm_movemask_ps(_mm_andnot_ps(backface, visible)) << half;
+		}
+#else
+		for (size_t lane = 0; lane < LANES; lane++)
+		{
+			size_t i = base + lane;
+			glm::vec3 center(centerX[i], centerY[i], centerZ[i]);
+			bool visible = true;
+			for (const glm::vec4 &plane : frustum.planes)
+			{
+				visible = visible && plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w >= -radii[i];
+			}
+			glm::vec3 v = center - cameraPosition;
+			bool backface = glm::dot(v, glm::vec3(axisX[i], axisY[i], axisZ[i])) >= cutoffs[i] * glm::length(v) + radii[i];
+			if (visible && !backface)
+			{
+				mask |= 1u << lane;
+			}
+		}
+#endif
+		while (mask != 0)
+		{
+			unsigned int lane = 0;
+			while ((mask & (1u << lane)) == 0)
+			{
+				lane++;
+			}
+			mask &= mask - 1;
+			const Meshlet &meshlet = meshlets[base + lane];
+			// 바로 앞 meshlet 도 보이면 구간을 이어붙인다
+			if (ranges.size() > firstRange && ranges.back().firstIndex + ranges.back().indexCount == meshlet.firstIndex)
+			{
+				ranges.back().indexCount += meshlet.triangleCount * 3;
+			}
+			else
+			{
+				ranges.push_back({meshlet.firstIndex, meshlet.triangleCount * 3});
+			}
+		}
+	}
+	return (ranges.size() - firstRange);
+}
+
+void MeshletMesh::bind() const
+{
+	glBindVertexArray(VAO);
+}
+
+void MeshletMesh::draw(const IndexRange *ranges, size_t count) const
+{
+	counts.resize(count);
+	offsets.resize(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		counts[i] = (GLsizei)ranges[i].indexCount;
+		offsets[i] = (const void *)(ranges[i].firstIndex * sizeof(uint32_t));
+	}
+	glMultiDrawElements(GL_TRIANGLES, counts.data(), GL_UNSIGNED_INT, offsets.data(), (GLsizei)count);
+}
+
+void MeshletMesh::printStats() const
+{
+	size_t vertexSum = 0;
+	for (const Meshlet &meshlet : meshlets)
+	{
+		vertexSum += meshlet.vertexCount;
+	}
+	std::cout << "Meshlets: " << meshlets.size() << " clusters for " << getTriangleCount() << " triangles, average " << (meshlets.empty() ? 0.0 : (double)getTriangleCount() / meshlets.size())
+		<< " triangles / " << (meshlets.empty() ? 0.0 : (double)vertexSum / meshlets.size()) << " vertices per cluster" << std::endl;
+}
@@ -0,0 +1,116 @@
+#ifndef MESHLET_H
+#define MESHLET_H
+
+#include "Bounds.h"
+#include "FrameArena.h"
+#include "MeshArena.h"
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+// 삼각형 몇십 개로 된 작은 덩어리(meshlet, cluster), 인덱스 버퍼에서 연속된 구간 하나를 차지한다
+struct Meshlet
+{
+	// 정점을 모두 감싸는 바운딩 구
+	glm::vec3 center;
+	float radius;
+	// 삼각형 법선이 모여있는 원뿔, 모든 법선과 축 사이의 각을 a 라고 하면 coneCutoff = sin(a)
+	// 법선이 반구 이상 퍼져 있으면 coneCutoff 는 1 보다 크게 두어 뒷면 검사를 항상 통과하게 한다
+	glm::vec3 coneAxis;
+	float coneCutoff;
+	unsigned int firstIndex;
+	unsigned int triangleCount;
+	unsigned int vertexCount;
+};
+
+// 인덱스 버퍼의 구간 하나
+struct IndexRange
+{
+	unsigned int firstIndex;
+	unsigned int indexCount;
+};
+
+// 물체 하나의 meshlet 그리기 명령, 보이는 meshlet 구간은 FramePacket::meshletRanges 의 [firstRange, firstRange + rangeCount) 에 있다
+struct MeshletDraw
+{
+	glm::mat4 model;
+	unsigned int firstRange;
+	unsigned int rangeCount;
+};
+
+// 삼각형이 많은 메쉬를 meshlet 으로 나누고, 물체 단위보다 잘게 프러스텀 / 뒷면 컬링한다
+// 물체가 화면에 걸치거나 카메라를 향하지 않는 면이 많으면 그 부분의 삼각형은 제출하지 않는다
+// meshlet 은 인덱스 버퍼에서 연속되게 배치하므로, 보이는 meshlet 이 이어지면 구간 하나로 합쳐서 glMultiDrawElements 로 그린다
+// 컬링은 meshlet 8개(AVX2) 또는 4개(SSE2) 씩 한 번에 검사한다 (CMake 의 ENABLE_AVX2 옵션 참고)
+class MeshletMesh
+{
+	private:
+		size_t floatsPerVertex;
+		std::vector<float> vertices;
+		std::vector<uint32_t> indices;
+		std::vector<Meshlet> meshlets;
+		// SIMD 로 검사하기 위해 meshlet 바운딩 구와 원뿔을 성분별 배열(SoA) 로 따로 저장한다, 길이는 8 의 배수
+		std::vector<float> centerX;
+		std::vector<float> centerY;
+		std::vector<float> centerZ;
+		std::vector<float> radii;
+		std::vector<float> axisX;
+		std::vector<float> axisY;
+		std::vector<float> axisZ;
+		std::vector<float> cutoffs;
+		// glMultiDrawElements 에 넘길 배열, 그릴 때마다 다시 채운다
+		mutable std::vector<GLsizei> counts;
+		mutable std::vector<const void *> offsets;
+
+		unsigned int VAO;
+		unsigned int VBO;
+		unsigned int EBO;
+
+		void createBuffers();
+
+	public:
+		// meshlet 하나의 최대 정점 / 삼각형 수, 메쉬 셰이더에서 많이 쓰는 값과 같다
+		static const size_t MAX_VERTICES = 64;
+		static const size_t MAX_TRIANGLES = 124;
+
+		explicit MeshletMesh(size_t floatsPerVertex);
+		~MeshletMesh();
+
+		MeshletMesh(const MeshletMesh &) = delete;
+		MeshletMesh &operator=(const MeshletMesh &) = delete;
+
+		// 이웃한 삼각형을 모아 meshlet 을 만들고, meshlet 순서로 인덱스를 다시 배치한다
+		void build(const MeshData &mesh);
+		// GL 버퍼를 만들고 Layout 으로 정점 속성을 설정한다, GL 컨텍스트가 있는 스레드에서 호출
+		template <typename Layout>
+		void upload()
+		{
+			static_assert(Layout::stride % sizeof(float) == 0, "Layout stride must be a whole number of floats");
+			createBuffers();
+			Layout::apply();
+			glBindVertexArray(0);
+		}
+
+		// frustum 과 cameraPosition 은 메쉬 좌표계(물체의 원점 기준) 이어야 한다
+		// 보이는 meshlet 의 인덱스 구간을 ranges 에 추가하고, 추가한 구간 수를 반환한다
+		size_t cull(const Frustum &frustum, const glm::vec3 &cameraPosition, FrameVector<IndexRange> &ranges) const;
+		void bind() const;
+		void draw(const IndexRange *ranges, size_t count) const;
+		void printStats() const;
+		void clear();
+
+		size_t getMeshletCount() const
+		{
+			return (meshlets.size());
+		}
+
+		size_t getTriangleCount() const
+		{
+			return (indices.size() / 3);
+		}
+};
+
+#endif
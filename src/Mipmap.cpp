@@ -0,0 +1,417 @@
+#include "Mipmap.h"
+
+#include <algorithm>
+#include <cmath>
+
+// SIMD 경로는 컴파일 옵션으로 선택한다 (CMake 의 ENABLE_AVX2 옵션 참고)
+// x64 에서는 SSE2 가 항상 지원되므로 MSVC 처럼 __SSE2__ 를 정의하지 않는 컴파일러도 함께 처리
+#if defined(__AVX2__)
+	#define MIPMAP_AVX2
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define MIPMAP_SSE2
+#endif
+
+#if defined(MIPMAP_AVX2)
+	#include <immintrin.h>
+#elif defined(MIPMAP_SSE2)
+	#include <emmintrin.h>
+#endif
+
+namespace
+{
+	// Kaiser 필터의 탭 수, 축소 후 픽셀 기준 반지름 2 의 커널을 원본 픽셀 8 개로 샘플링한다
+	const int KAISER_TAPS = 8;
+	const int KAISER_FIRST_TAP = -3;
+	const float KAISER_WIDTH = 2.0f;
+	const float KAISER_ALPHA = 4.0f;
+
+	// 0차 변형 베셀 함수, Kaiser 윈도우 계산에 사용
+	float besselI0(float x)
+	{
+		float sum = 1.0f;
+		float term = 1.0f;
+		float halfX = x * 0.5f;
+		for (int i = 1; i < 32; ++i)
+		{
+			term *= (halfX / i) * (halfX / i);
+			sum += term;
+			if (term < sum * 1e-8f)
+			{
+				break;
+			}
+		}
+		return (sum);
+	}
+
+	float sinc(float x)
+	{
+		if (std::fabs(x) < 1e-6f)
+		{
+			return (1.0f);
+		}
+		const float pi = 3.14159265358979f;
+		return (std::sin(pi * x) / (pi * x));
+	}
+
+	// 2배 축소에 쓰이는 Kaiser 가중치, 출력 픽셀 중심에서 원본 픽셀 중심까지의 거리를 출력 픽셀 단위로 환산하여 계산한다
+	const float *kaiserWeights()
+	{
+		static const struct Weights
+		{
+			float w[KAISER_TAPS];
+
+			Weights()
+			{
+				float total = 0.0f;
+				for (int k = 0; k < KAISER_TAPS; ++k)
+				{
+					float d = ((KAISER_FIRST_TAP + k) - 0.5f) * 0.5f;
+					float t = d / KAISER_WIDTH;
+					float window = besselI0(KAISER_ALPHA * std::sqrt(std::max(0.0f, 1.0f - t * t))) / besselI0(KAISER_ALPHA);
+					w[k] = sinc(d) * window;
+					total += w[k];
+				}
+				for (int k = 0; k < KAISER_TAPS; ++k)
+				{
+					w[k] /= total;
+				}
+			}
+		} weights;
+		return (weights.w);
+	}
+
+	const float *srgbToLinearTable()
+	{
+		static const struct Table
+		{
+			float v[256];
+
+			Table()
+			{
+				for (int i = 0; i < 256; ++i)
+				{
+					float c = i / 255.0f;
+					v[i] = (c <= 0.04045f) ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+				}
+			}
+		} table;
+		return (table.v);
+	}
+
+	// 선형 값을 12비트로 양자화해서 sRGB 8비트 값으로 바꾸는 테이블, 0 근처에서도 오차가 1 LSB 이하이다
+	const int LINEAR_TO_SRGB_SIZE = 4096;
+
+	const unsigned char *linearToSrgbTable()
+	{
+		static const struct Table
+		{
+			unsigned char v[LINEAR_TO_SRGB_SIZE];
+
+			Table()
+			{
+				for (int i = 0; i < LINEAR_TO_SRGB_SIZE; ++i)
+				{
+					float l = i / (float)(LINEAR_TO_SRGB_SIZE - 1);
+					float s = (l <= 0.0031308f) ? l * 12.92f : 1.055f * std::pow(l, 1.0f / 2.4f) - 0.055f;
+					v[i] = (unsigned char)std::lround(std::min(std::max(s, 0.0f), 1.0f) * 255.0f);
+				}
+			}
+		} table;
+		return (table.v);
+	}
+
+	bool hasAlpha(int channels)
+	{
+		return (channels == 2 || channels == 4);
+	}
+
+	// 1~4 채널 8비트 이미지를 내부 작업용 RGBA float 이미지로 변환한다
+	// 색상 채널은 sRGB 라면 선형으로, 알파 채널은 항상 선형 값 그대로 사용
+	std::vector<float> toLinear(const unsigned char *data, int width, int height, int channels, bool sRGB)
+	{
+		const float *lut = srgbToLinearTable();
+		size_t count = (size_t)width * height;
+		std::vector<float> out(count * 4);
+		int colorChannels = hasAlpha(channels) ? channels - 1 : channels;
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			const unsigned char *src = data + i * channels;
+			float *dst = &out[i * 4];
+			for (int c = 0; c < 3; ++c)
+			{
+				unsigned char v = src[std::min(c, colorChannels - 1)];
+				dst[c] = sRGB ? lut[v] : v / 255.0f;
+			}
+			dst[3] = hasAlpha(channels) ? src[channels - 1] / 255.0f : 1.0f;
+		}
+		return (out);
+	}
+
+	unsigned char quantize(float v)
+	{
+		return ((unsigned char)std::lround(std::min(std::max(v, 0.0f), 1.0f) * 255.0f));
+	}
+
+	std::vector<unsigned char> fromLinear(const std::vector<float> &src, int width, int height, int channels, bool sRGB, float alphaScale)
+	{
+		const unsigned char *lut = linearToSrgbTable();
+		size_t count = (size_t)width * height;
+		std::vector<unsigned char> out(count * channels);
+		int colorChannels = hasAlpha(channels) ? channels - 1 : channels;
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			const float *s = &src[i * 4];
+			unsigned char *dst = &out[i * channels];
+			for (int c = 0; c < colorChannels; ++c)
+			{
+				if (sRGB)
+				{
+					float l = std::min(std::max(s[c], 0.0f), 1.0f);
+					dst[c] = lut[(int)(l * (LINEAR_TO_SRGB_SIZE - 1) + 0.5f)];
+				}
+				else
+				{
+					dst[c] = quantize(s[c]);
+				}
+			}
+			if (hasAlpha(channels))
+			{
+				dst[channels - 1] = quantize(s[3] * alphaScale);
+			}
+		}
+		return (out);
+	}
+
+	// 2x2 박스 필터, 홀수 크기에서는 마지막 행/열을 한 번 더 샘플링한다
+	void downsampleBox(const float *src, int sw, int sh, float *dst, int dw, int dh)
+	{
+		for (int dy = 0; dy < dh; ++dy)
+		{
+			const float *r0 = src + (size_t)std::min(2 * dy, sh - 1) * sw * 4;
+			const float *r1 = src + (size_t)std::min(2 * dy + 1, sh - 1) * sw * 4;
+			float *out = dst + (size_t)dy * dw * 4;
+			int dx = 0;
+
+#if defined(MIPMAP_AVX2)
+			// 출력 픽셀 2개(원본 4x2 픽셀)를 한 번에 처리
+			const __m256 quarter = _mm256_set1_ps(0.25f);
+			for (; 2 * dx + 3 < sw && dx + 1 < dw; dx += 2)
+			{
+				__m256 a = _mm256_add_ps(_mm256_loadu_ps(r0 + dx * 8), _mm256_loadu_ps(r1 + dx * 8));
+				__m256 b = _mm256_add_ps(_mm256_loadu_ps(r0 + dx * 8 + 8), _mm256_loadu_ps(r1 + dx * 8 + 8));
+				__m256 even = _mm256_permute2f128_ps(a, b, 0x20);
+				__m256 odd = _mm256_permute2f128_ps(a, b, 0x31);
+				_mm256_storeu_ps(out + dx * 4, _mm256_mul_ps(_mm256_add_ps(even, odd), quarter));
+			}
+#endif
+			for (; dx < dw; ++dx)
+			{
+				int x0 = std::min(2 * dx, sw - 1);
+				int x1 = std::min(2 * dx + 1, sw - 1);
+#if defined(MIPMAP_SSE2) || defined(MIPMAP_AVX2)
+				// AVX 경로와 덧셈 순서를 맞춰서 빌드 옵션에 관계없이 같은 결과가 나오게 한다
+				__m128 sum = _mm_add_ps(_mm_add_ps(_mm_loadu_ps(r0 + x0 * 4), _mm_loadu_ps(r1 + x0 * 4)),
+					_mm_add_ps(_mm_loadu_ps(r0 + x1 * 4), _mm_loadu_ps(r1 + x1 * 4)));
+				_mm_storeu_ps(out + dx * 4, _mm_mul_ps(sum, _mm_set1_ps(0.25f)));
+#else
+				for (int c = 0; c < 4; ++c)
+				{
+					out[dx * 4 + c] = ((r0[x0 * 4 + c] + r1[x0 * 4 + c]) + (r0[x1 * 4 + c] + r1[x1 * 4 + c])) * 0.25f;
+				}
+#endif
+			}
+		}
+	}
+
+	// Kaiser 필터의 가로 방향 축소, 가장자리는 clamp 로 처리
+	void kaiserHorizontal(const float *src, int sw, int height, float *dst, int dw)
+	{
+		const float *w = kaiserWeights();
+		for (int y = 0; y < height; ++y)
+		{
+			const float *row = src + (size_t)y * sw * 4;
+			float *out = dst + (size_t)y * dw * 4;
+			for (int dx = 0; dx < dw; ++dx)
+			{
+#if defined(MIPMAP_SSE2) || defined(MIPMAP_AVX2)
+				__m128 acc = _mm_setzero_ps();
+				for (int k = 0; k < KAISER_TAPS; ++k)
+				{
+					int x = std::min(std::max(2 * dx + KAISER_FIRST_TAP + k, 0), sw - 1);
+					acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(w[k]), _mm_loadu_ps(row + x * 4)));
+				}
+				_mm_storeu_ps(out + dx * 4, acc);
+#else
+				float acc[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+				for (int k = 0; k < KAISER_TAPS; ++k)
+				{
+					int x = std::min(std::max(2 * dx + KAISER_FIRST_TAP + k, 0), sw - 1);
+					for (int c = 0; c < 4; ++c)
+					{
+						acc[c] += w[k] * row[x * 4 + c];
+					}
+				}
+				for (int c = 0; c < 4; ++c)
+				{
+					out[dx * 4 + c] = acc[c];
+				}
+#endif
+			}
+		}
+	}
+
+	// Kaiser 필터의 세로 방향 축소, 행 단위로 연속된 float 를 한꺼번에 누적하므로 벡터화가 쉽다
+	void kaiserVertical(const float *src, int width, int sh, float *dst, int dh)
+	{
+		const float *w = kaiserWeights();
+		size_t rowFloats = (size_t)width * 4;
+		for (int dy = 0; dy < dh; ++dy)
+		{
+			const float *rows[KAISER_TAPS];
+			for (int k = 0; k < KAISER_TAPS; ++k)
+			{
+				rows[k] = src + (size_t)std::min(std::max(2 * dy + KAISER_FIRST_TAP + k, 0), sh - 1) * rowFloats;
+			}
+			float *out = dst + (size_t)dy * rowFloats;
+			size_t i = 0;
+#if defined(MIPMAP_AVX2)
+			for (; i + 8 <= rowFloats; i += 8)
+			{
+				__m256 acc = _mm256_setzero_ps();
+				for (int k = 0; k < KAISER_TAPS; ++k)
+				{
+					acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_set1_ps(w[k]), _mm256_loadu_ps(rows[k] + i)));
+				}
+				_mm256_storeu_ps(out + i, acc);
+			}
+#endif
+#if defined(MIPMAP_SSE2) || defined(MIPMAP_AVX2)
+			for (; i + 4 <= rowFloats; i += 4)
+			{
+				__m128 acc = _mm_setzero_ps();
+				for (int k = 0; k < KAISER_TAPS; ++k)
+				{
+					acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(w[k]), _mm_loadu_ps(rows[k] + i)));
+				}
+				_mm_storeu_ps(out + i, acc);
+			}
+#endif
+			for (; i < rowFloats; ++i)
+			{
+				float acc = 0.0f;
+				for (int k = 0; k < KAISER_TAPS; ++k)
+				{
+					acc += w[k] * rows[k][i];
+				}
+				out[i] = acc;
+			}
+		}
+	}
+
+	std::vector<float> downsample(const std::vector<float> &src, int sw, int sh, int dw, int dh, MipFilter filter)
+	{
+		std::vector<float> dst((size_t)dw * dh * 4);
+		if (filter == MipFilter::BOX)
+		{
+			downsampleBox(src.data(), sw, sh, dst.data(), dw, dh);
+			return (dst);
+		}
+
+		// 한 축이 이미 1 픽셀이면 그 축은 축소하지 않고 그대로 둔다
+		std::vector<float> tmp;
+		const float *horizontal = src.data();
+		if (sw > 1)
+		{
+			tmp.resize((size_t)dw * sh * 4);
+			kaiserHorizontal(src.data(), sw, sh, tmp.data(), dw);
+			horizontal = tmp.data();
+		}
+		if (sh > 1)
+		{
+			kaiserVertical(horizontal, dw, sh, dst.data(), dh);
+		}
+		else
+		{
+			std::copy(horizontal, horizontal + dst.size(), dst.begin());
+		}
+		return (dst);
+	}
+
+	float alphaCoverage(const std::vector<float> &pixels, float cutoff, float scale)
+	{
+		size_t count = pixels.size() / 4;
+		size_t covered = 0;
+		for (size_t i = 0; i < count; ++i)
+		{
+			if (pixels[i * 4 + 3] * scale > cutoff)
+			{
+				++covered;
+			}
+		}
+		return ((float)covered / (float)count);
+	}
+
+	// 원본 레벨과 같은 커버리지가 되도록 알파에 곱할 배율을 이분 탐색으로 찾는다
+	float findAlphaScale(const std::vector<float> &pixels, float cutoff, float targetCoverage)
+	{
+		float lo = 0.0f;
+		float hi = 4.0f;
+		float best = 1.0f;
+		float bestError = std::fabs(alphaCoverage(pixels, cutoff, 1.0f) - targetCoverage);
+		for (int i = 0; i < 10; ++i)
+		{
+			float mid = (lo + hi) * 0.5f;
+			float coverage = alphaCoverage(pixels, cutoff, mid);
+			float error = std::fabs(coverage - targetCoverage);
+			if (error < bestError)
+			{
+				best = mid;
+				bestError = error;
+			}
+			if (coverage < targetCoverage)
+			{
+				lo = mid;
+			}
+			else
+			{
+				hi = mid;
+			}
+		}
+		return (best);
+	}
+}
+
+std::vector<MipLevel> generateMipChain(const unsigned char *data, int width, int height, int channels, const MipOptions &options)
+{
+	std::vector<MipLevel> levels;
+	if (data == nullptr || width <= 0 || height <= 0 || channels < 1 || channels > 4)
+	{
+		return (levels);
+	}
+
+	// 레벨 0 은 원본 데이터를 그대로 사용
+	levels.push_back({width, height, std::vector<unsigned char>(data, data + (size_t)width * height * channels)});
+
+	// 축소는 항상 직전 레벨의 float 데이터로부터 진행하여 양자화 오차가 누적되지 않게 한다
+	std::vector<float> current = toLinear(data, width, height, channels, options.sRGB);
+	bool coverage = options.preserveAlphaCoverage && hasAlpha(channels);
+	float targetCoverage = coverage ? alphaCoverage(current, options.alphaCutoff, 1.0f) : 0.0f;
+
+	int w = width;
+	int h = height;
+	while (w > 1 || h > 1)
+	{
+		int nw = std::max(1, w / 2);
+		int nh = std::max(1, h / 2);
+		current = downsample(current, w, h, nw, nh, options.filter);
+		w = nw;
+		h = nh;
+
+		float alphaScale = coverage ? findAlphaScale(current, options.alphaCutoff, targetCoverage) : 1.0f;
+		levels.push_back({w, h, fromLinear(current, w, h, channels, options.sRGB, alphaScale)});
+	}
+	return (levels);
+}
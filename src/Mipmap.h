@@ -0,0 +1,35 @@
+#ifndef MIPMAP_H
+#define MIPMAP_H
+
+#include <vector>
+
+// 밉맵 축소에 사용할 필터 종류
+enum class MipFilter
+{
+	BOX,
+	KAISER,
+};
+
+struct MipOptions
+{
+	MipFilter filter = MipFilter::BOX;
+	// 색상 채널을 sRGB 로 저장된 값으로 보고, 선형 공간으로 변환한 뒤 평균을 낸다
+	bool sRGB = true;
+	// 알파 테스트(alpha cutoff) 를 사용하는 텍스처에서 밉 레벨이 내려가도 알파 커버리지가 유지되도록 알파를 보정한다
+	bool preserveAlphaCoverage = false;
+	float alphaCutoff = 0.5f;
+};
+
+// 밉 레벨 하나의 크기와 픽셀 데이터, 채널 수는 원본 이미지와 같다
+struct MipLevel
+{
+	int width;
+	int height;
+	std::vector<unsigned char> pixels;
+};
+
+// 원본 이미지(레벨 0) 부터 1x1 까지 전체 밉 체인을 CPU 에서 생성한다
+// glGenerateMipmap 과 달리 sRGB 를 고려하여 축소하므로 드라이버와 관계없이 같은 결과를 얻는다
+std::vector<MipLevel> generateMipChain(const unsigned char *data, int width, int height, int channels, const MipOptions &options = MipOptions());
+
+#endif
@@ -0,0 +1,1123 @@
+#include "ModelLoader.h"
+#include "MappedFile.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	const size_t FLOATS_PER_VERTEX = 5;
+	// 덩어리 하나의 최소 크기, 작은 파일은 스레드를 만드는 비용이 파싱보다 크다
+	const size_t MIN_CHUNK_BYTES = 1 << 20;
+	const int32_t NO_TEXCOORD = INT32_MIN;
+	const uint64_t EMPTY_KEY = ~0ull;
+
+	// count 개의 작업을 스레드 하나씩에 나눠서 실행하고 모두 끝날 때까지 기다린다, 마지막 작업은 호출한 스레드가 한다
+	template <typename Function>
+	void parallelFor(size_t count, Function function)
+	{
+		std::vector<std::thread> threads;
+		for (size_t i = 0; i + 1 < count; i++)
+		{
+			threads.emplace_back(function, i);
+		}
+		if (count > 0)
+		{
+			function(count - 1);
+		}
+		for (std::thread &thread : threads)
+		{
+			thread.join();
+		}
+	}
+
+	bool isDigit(char c)
+	{
+		return (c >= '0' && c <= '9');
+	}
+
+	const char *skipSpaces(const char *p, const char *end)
+	{
+		while (p < end && (*p == ' ' || *p == '\t'))
+		{
+			p++;
+		}
+		return (p);
+	}
+
+	const char *nextLine(const char *p, const char *end)
+	{
+		const char *newline = (const char *)std::memchr(p, '\n', (size_t)(end - p));
+		return (newline == NULL ? end : newline + 1);
+	}
+
+	double powerOfTen(int exponent)
+	{
+		static const double TABLE[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+		if (exponent >= 0 && exponent <= 22)
+		{
+			return (TABLE[exponent]);
+		}
+		if (exponent < 0 && exponent >= -22)
+		{
+			return (1.0 / TABLE[-exponent]);
+		}
+		return (std::pow(10.0, exponent));
+	}
+
+	// 매핑된 파일은 NUL 로 끝나지 않으므로 strtof 대신 end 까지만 읽는 파서를 쓴다, 로케일의 영향도 받지 않는다
+	// 유효 숫자는 18자리까지만 사용한다. 2^53 보다 작은 정수는 정확히 읽힌다
+	bool parseDouble(const char *&p, const char *end, double &value)
+	{
+		p = skipSpaces(p, end);
+		bool negative = false;
+		if (p < end && (*p == '-' || *p == '+'))
+		{
+			negative = *p == '-';
+			p++;
+		}
+		uint64_t mantissa = 0;
+		int digits = 0;
+		int exponent = 0;
+		bool any = false;
+		while (p < end && isDigit(*p))
+		{
+			if (digits < 18)
+			{
+				mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+				digits += mantissa != 0;
+			}
+			else
+			{
+				exponent++;
+			}
+			any = true;
+			p++;
+		}
+		if (p < end && *p == '.')
+		{
+			p++;
+			while (p < end && isDigit(*p))
+			{
+				if (digits < 18)
+				{
+					mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+					digits += mantissa != 0;
+					exponent--;
+				}
+				any = true;
+				p++;
+			}
+		}
+		if (!any)
+		{
+			return (false);
+		}
+		if (p < end && (*p == 'e' || *p == 'E'))
+		{
+			p++;
+			bool negativeExponent = false;
+			if (p < end && (*p == '-' || *p == '+'))
+			{
+				negativeExponent = *p == '-';
+				p++;
+			}
+			int e = 0;
+			while (p < end && isDigit(*p))
+			{
+				e = std::min(e * 10 + (*p - '0'), 1000);
+				p++;
+			}
+			exponent += negativeExponent ? -e : e;
+		}
+		double result = (double)mantissa * powerOfTen(exponent);
+		value = negative ? -result : result;
+		return (true);
+	}
+
+	bool parseFloat(const char *&p, const char *end, float &value)
+	{
+		double result;
+		if (!parseDouble(p, end, result))
+		{
+			return (false);
+		}
+		value = (float)result;
+		return (true);
+	}
+
+	bool parseInt(const char *&p, const char *end, int64_t &value)
+	{
+		bool negative = false;
+		if (p < end && (*p == '-' || *p == '+'))
+		{
+			negative = *p == '-';
+			p++;
+		}
+		if (p == end || !isDigit(*p))
+		{
+			return (false);
+		}
+		int64_t result = 0;
+		while (p < end && isDigit(*p))
+		{
+			result = std::min<int64_t>(result * 10 + (*p - '0'), INT32_MAX);
+			p++;
+		}
+		value = negative ? -result : result;
+		return (true);
+	}
+
+	// 면의 꼭짓점 하나, 양수 인덱스는 0 부터 시작하는 전체 번호로 바꿔두고
+	// 음수(상대) 인덱스는 이 덩어리 안에서 센 번호로 바꿔둔다 (덩어리 앞쪽을 가리키면 음수가 된다), 합칠 때 덩어리의 시작 번호를 더한다
+	struct ObjCorner
+	{
+		int32_t position;
+		int32_t texcoord;
+		bool positionRelative;
+		bool texcoordRelative;
+	};
+
+	struct ObjChunk
+	{
+		const char *begin;
+		const char *end;
+		std::vector<float> positions;
+		std::vector<float> texcoords;
+		// 삼각형마다 3개
+		std::vector<ObjCorner> corners;
+		// 앞 덩어리들의 v / vt 개수 합
+		size_t positionBase;
+		size_t texcoordBase;
+		// 같은 (v, vt) 조합을 합친 GPU 형식 정점과 덩어리 안의 인덱스
+		std::vector<float> vertices;
+		std::vector<uint32_t> indices;
+		size_t vertexBase;
+		size_t indexBase;
+		bool failed;
+	};
+
+	// "v", "v/vt", "v//vn", "v/vt/vn" 하나를 읽는다
+	bool parseCorner(const char *&p, const char *end, size_t positionCount, size_t texcoordCount, ObjCorner &corner)
+	{
+		int64_t index;
+		if (!parseInt(p, end, index) || index == 0)
+		{
+			return (false);
+		}
+		corner.positionRelative = index < 0;
+		corner.position = (int32_t)(index < 0 ? (int64_t)positionCount + index : index - 1);
+		corner.texcoord = NO_TEXCOORD;
+		corner.texcoordRelative = false;
+		if (p < end && *p == '/')
+		{
+			p++;
+			if (p < end && *p != '/')
+			{
+				if (!parseInt(p, end, index) || index == 0)
+				{
+					return (false);
+				}
+				corner.texcoordRelative = index < 0;
+				corner.texcoord = (int32_t)(index < 0 ? (int64_t)texcoordCount + index : index - 1);
+			}
+			if (p < end && *p == '/')
+			{
+				p++;
+				// 법선은 쓰지 않는다
+				int64_t normal;
+				parseInt(p, end, normal);
+			}
+		}
+		return (true);
+	}
+
+	void parseObjChunk(ObjChunk &chunk)
+	{
+		const char *p = chunk.begin;
+		const char *end = chunk.end;
+		while (p < end)
+		{
+			const char *line = skipSpaces(p, end);
+			const char *lineEnd = nextLine(line, end);
+			p = lineEnd;
+			if (lineEnd - line < 2)
+			{
+				continue;
+			}
+			if (line[0] == 'v' && (line[1] == ' ' || line[1] == '\t'))
+			{
+				const char *cursor = line + 1;
+				float xyz[3];
+				if (!parseFloat(cursor, lineEnd, xyz[0]) || !parseFloat(cursor, lineEnd, xyz[1]) || !parseFloat(cursor, lineEnd, xyz[2]))
+				{
+					chunk.failed = true;
+					return;
+				}
+				chunk.positions.insert(chunk.positions.end(), xyz, xyz + 3);
+			}
+			else if (line[0] == 'v' && line[1] == 't')
+			{
+				const char *cursor = line + 2;
+				float uv[2] = {0.0f, 0.0f};
+				if (!parseFloat(cursor, lineEnd, uv[0]))
+				{
+					chunk.failed = true;
+					return;
+				}
+				// 1차원 텍스처 좌표는 v 가 없다
+				parseFloat(cursor, lineEnd, uv[1]);
+				chunk.texcoords.insert(chunk.texcoords.end(), uv, uv + 2);
+			}
+			else if (line[0] == 'f' && (line[1] == ' ' || line[1] == '\t'))
+			{
+				// 부채꼴 삼각형화: 첫 꼭짓점, 직전 꼭짓점, 지금 꼭짓점
+				const char *cursor = skipSpaces(line + 1, lineEnd);
+				ObjCorner first;
+				ObjCorner previous;
+				int count = 0;
+				while (cursor < lineEnd && *cursor != '\r' && *cursor != '\n' && *cursor != '#')
+				{
+					ObjCorner corner;
+					if (!parseCorner(cursor, lineEnd, chunk.positions.size() / 3, chunk.texcoords.size() / 2, corner))
+					{
+						chunk.failed = true;
+						return;
+					}
+					if (count == 0)
+					{
+						first = corner;
+					}
+					else if (count >= 2)
+					{
+						chunk.corners.push_back(first);
+						chunk.corners.push_back(previous);
+						chunk.corners.push_back(corner);
+					}
+					previous = corner;
+					count++;
+					cursor = skipSpaces(cursor, lineEnd);
+				}
+			}
+		}
+	}
+
+	// 덩어리의 면을 전체 v / vt 번호로 바꾸고, 같은 (v, vt) 조합은 정점 하나로 합친다
+	// 합치는 표는 정점마다 노드를 만들지 않도록 배열 하나로 된 열린 주소법 해시 테이블을 쓴다
+	void buildObjVertices(ObjChunk &chunk, const std::vector<float> &positions, const std::vector<float> &texcoords)
+	{
+		size_t tableSize = 16;
+		while (tableSize < chunk.corners.size() * 2)
+		{
+			tableSize *= 2;
+		}
+		std::vector<std::pair<uint64_t, uint32_t>> table(tableSize, std::make_pair(EMPTY_KEY, 0u));
+		int64_t positionCount = (int64_t)(positions.size() / 3);
+		int64_t texcoordCount = (int64_t)(texcoords.size() / 2);
+		chunk.indices.reserve(chunk.corners.size());
+		for (size_t i = 0; i < chunk.corners.size(); i++)
+		{
+			const ObjCorner &corner = chunk.corners[i];
+			int64_t position = corner.position + (corner.positionRelative ? (int64_t)chunk.positionBase : 0);
+			int64_t texcoord = corner.texcoord;
+			if (texcoord != NO_TEXCOORD && corner.texcoordRelative)
+			{
+				texcoord += (int64_t)chunk.texcoordBase;
+			}
+			if (position < 0 || position >= positionCount || (texcoord != NO_TEXCOORD && (texcoord < 0 || texcoord >= texcoordCount)))
+			{
+				chunk.failed = true;
+				return;
+			}
+			uint64_t key = ((uint64_t)position << 32) | (texcoord == NO_TEXCOORD ? 0xffffffffull : (uint64_t)texcoord);
+			size_t slot = (size_t)((key * 0x9E3779B97F4A7C15ull) >> 20) & (tableSize - 1);
+			while (table[slot].first != EMPTY_KEY && table[slot].first != key)
+			{
+				slot = (slot + 1) & (tableSize - 1);
+			}
+			if (table[slot].first == EMPTY_KEY)
+			{
+				table[slot].first = key;
+				table[slot].second = (uint32_t)(chunk.vertices.size() / FLOATS_PER_VERTEX);
+				const float *xyz = &positions[(size_t)position * 3];
+				chunk.vertices.insert(chunk.vertices.end(), xyz, xyz + 3);
+				if (texcoord == NO_TEXCOORD)
+				{
+					chunk.vertices.push_back(0.0f);
+					chunk.vertices.push_back(0.0f);
+				}
+				else
+				{
+					chunk.vertices.push_back(texcoords[(size_t)texcoord * 2]);
+					chunk.vertices.push_back(texcoords[(size_t)texcoord * 2 + 1]);
+				}
+			}
+			chunk.indices.push_back(table[slot].second);
+		}
+	}
+
+	// glTF 의 JSON 청크를 읽기 위한 최소한의 JSON 파서
+	struct JsonValue
+	{
+		enum class Type
+		{
+			NUL,
+			BOOLEAN,
+			NUMBER,
+			STRING,
+			ARRAY,
+			OBJECT,
+		};
+
+		Type type = Type::NUL;
+		double number = 0.0;
+		bool boolean = false;
+		std::string string;
+		std::vector<JsonValue> items;
+		std::vector<std::pair<std::string, JsonValue>> members;
+
+		const JsonValue *find(const char *key) const
+		{
+			for (const std::pair<std::string, JsonValue> &member : members)
+			{
+				if (member.first == key)
+				{
+					return (&member.second);
+				}
+			}
+			return (NULL);
+		}
+
+		double getNumber(const char *key, double fallback) const
+		{
+			const JsonValue *value = find(key);
+			return (value != NULL && value->type == Type::NUMBER ? value->number : fallback);
+		}
+
+		// int 범위의 정수가 아니면(NaN, 무한대, 소수 포함) fallback
+		int getInt(const char *key, int fallback) const
+		{
+			double value = getNumber(key, fallback);
+			if (!(value >= (double)INT_MIN && value <= (double)INT_MAX) || value != std::floor(value))
+			{
+				return (fallback);
+			}
+			return ((int)value);
+		}
+
+		// 바이트 오프셋과 개수처럼 0 이상의 정수여야 하는 값, 아니면 fallback
+		uint64_t getUint(const char *key, uint64_t fallback) const
+		{
+			double value = getNumber(key, -1.0);
+			if (value < 0.0 || value >= 18446744073709551616.0 || value != std::floor(value))
+			{
+				return (fallback);
+			}
+			return ((uint64_t)value);
+		}
+
+		// 크기가 count 인 배열의 원소를 가리키는 번호, 0 이상 count 미만의 정수가 아니면 false
+		bool asIndex(size_t count, size_t &index) const
+		{
+			if (type != Type::NUMBER || !(number >= 0.0 && number < (double)count) || number != std::floor(number))
+			{
+				return (false);
+			}
+			index = (size_t)number;
+			return (true);
+		}
+
+		bool getIndex(const char *key, size_t count, size_t &index) const
+		{
+			const JsonValue *value = find(key);
+			return (value != NULL && value->asIndex(count, index));
+		}
+
+		size_t size() const
+		{
+			return (items.size());
+		}
+	};
+
+	class JsonParser
+	{
+		private:
+			const char *p;
+			const char *end;
+			int depth;
+
+			void skipWhitespace()
+			{
+				while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r'))
+				{
+					p++;
+				}
+			}
+
+			bool expect(const char *word)
+			{
+				size_t length = std::strlen(word);
+				if ((size_t)(end - p) < length || std::memcmp(p, word, length) != 0)
+				{
+					return (false);
+				}
+				p += length;
+				return (true);
+			}
+
+			bool parseString(std::string &out)
+			{
+				p++;
+				while (p < end && *p != '"')
+				{
+					if (*p == '\\' && p + 1 < end)
+					{
+						p++;
+						switch (*p)
+						{
+							case 'n':
+								out.push_back('\n');
+								break;
+							case 't':
+								out.push_back('\t');
+								break;
+							case 'r':
+								out.push_back('\r');
+								break;
+							case 'b':
+								out.push_back('\b');
+								break;
+							case 'f':
+								out.push_back('\f');
+								break;
+							case 'u':
+								// 필요한 키와 값은 모두 ASCII 이므로 유니코드 문자는 '?' 로 둔다
+								p += std::min<ptrdiff_t>(4, end - p - 1);
+								out.push_back('?');
+								break;
+							default:
+								out.push_back(*p);
+								break;
+						}
+					}
+					else
+					{
+						out.push_back(*p);
+					}
+					p++;
+				}
+				if (p == end)
+				{
+					return (false);
+				}
+				p++;
+				return (true);
+			}
+
+			bool parseValue(JsonValue &out)
+			{
+				skipWhitespace();
+				if (p == end || ++depth > 64)
+				{
+					return (false);
+				}
+				bool success = true;
+				if (*p == '{')
+				{
+					out.type = JsonValue::Type::OBJECT;
+					p++;
+					skipWhitespace();
+					if (p < end && *p == '}')
+					{
+						p++;
+					}
+					else
+					{
+						while (success)
+						{
+							skipWhitespace();
+							out.members.emplace_back();
+							success = p < end && *p == '"' && parseString(out.members.back().first);
+							skipWhitespace();
+							success = success && p < end && *p++ == ':' && parseValue(out.members.back().second);
+							skipWhitespace();
+							if (success && p < end && *p == ',')
+							{
+								p++;
+								continue;
+							}
+							success = success && p < end && *p++ == '}';
+							break;
+						}
+					}
+				}
+				else if (*p == '[')
+				{
+					out.type = JsonValue::Type::ARRAY;
+					p++;
+					skipWhitespace();
+					if (p < end && *p == ']')
+					{
+						p++;
+					}
+					else
+					{
+						while (success)
+						{
+							out.items.emplace_back();
+							success = parseValue(out.items.back());
+							skipWhitespace();
+							if (success && p < end && *p == ',')
+							{
+								p++;
+								continue;
+							}
+							success = success && p < end && *p++ == ']';
+							break;
+						}
+					}
+				}
+				else if (*p == '"')
+				{
+					out.type = JsonValue::Type::STRING;
+					success = parseString(out.string);
+				}
+				else if (*p == 't' || *p == 'f')
+				{
+					out.type = JsonValue::Type::BOOLEAN;
+					out.boolean = *p == 't';
+					success = expect(out.boolean ? "true" : "false");
+				}
+				else if (*p == 'n')
+				{
+					success = expect("null");
+				}
+				else
+				{
+					// byteOffset / byteLength / count 는 float 로 읽으면 2^24 를 넘는 값이 반올림되므로 double 로 읽는다
+					out.type = JsonValue::Type::NUMBER;
+					success = parseDouble(p, end, out.number);
+				}
+				depth--;
+				return (success);
+			}
+
+		public:
+			JsonParser(const char *text, size_t size) : p(text), end(text + size), depth(0)
+			{
+			}
+
+			bool parse(JsonValue &out)
+			{
+				return (parseValue(out));
+			}
+	};
+
+	// accessor 하나가 가리키는 BIN 청크 안의 데이터
+	struct AccessorView
+	{
+		const unsigned char *data;
+		size_t count;
+		size_t stride;
+		int componentType;
+		int components;
+		bool normalized;
+	};
+
+	const int GLTF_BYTE = 5120;
+	const int GLTF_UNSIGNED_BYTE = 5121;
+	const int GLTF_SHORT = 5122;
+	const int GLTF_UNSIGNED_SHORT = 5123;
+	const int GLTF_UNSIGNED_INT = 5125;
+	const int GLTF_FLOAT = 5126;
+	const int GLTF_TRIANGLES = 4;
+
+	size_t componentSize(int componentType)
+	{
+		switch (componentType)
+		{
+			case GLTF_BYTE:
+			case GLTF_UNSIGNED_BYTE:
+				return (1);
+			case GLTF_SHORT:
+			case GLTF_UNSIGNED_SHORT:
+				return (2);
+			case GLTF_UNSIGNED_INT:
+			case GLTF_FLOAT:
+				return (4);
+			default:
+				return (0);
+		}
+	}
+
+	int typeComponents(const std::string &type)
+	{
+		if (type == "SCALAR")
+		{
+			return (1);
+		}
+		if (type == "VEC2")
+		{
+			return (2);
+		}
+		if (type == "VEC3")
+		{
+			return (3);
+		}
+		if (type == "VEC4")
+		{
+			return (4);
+		}
+		return (0);
+	}
+
+	// index 는 accessor 번호 값(없으면 NULL), 범위를 벗어나는 accessor 는 false, sparse accessor 는 지원하지 않는다
+	bool getAccessor(const JsonValue &root, const unsigned char *bin, size_t binSize, const JsonValue *index, AccessorView &view)
+	{
+		const JsonValue *accessors = root.find("accessors");
+		const JsonValue *bufferViews = root.find("bufferViews");
+		size_t accessorIndex;
+		if (accessors == NULL || bufferViews == NULL || index == NULL || !index->asIndex(accessors->size(), accessorIndex))
+		{
+			return (false);
+		}
+		const JsonValue &accessor = accessors->items[accessorIndex];
+		size_t bufferViewIndex;
+		const JsonValue *type = accessor.find("type");
+		if (!accessor.getIndex("bufferView", bufferViews->size(), bufferViewIndex) || type == NULL || accessor.find("sparse") != NULL)
+		{
+			return (false);
+		}
+		const JsonValue &bufferView = bufferViews->items[bufferViewIndex];
+		// GLB 의 바이너리 청크는 buffer 0 하나뿐이다
+		const JsonValue *buffer = bufferView.find("buffer");
+		size_t bufferIndex;
+		if (buffer != NULL && !buffer->asIndex(1, bufferIndex))
+		{
+			return (false);
+		}
+		view.componentType = accessor.getInt("componentType", 0);
+		view.components = typeComponents(type->string);
+		const JsonValue *normalized = accessor.find("normalized");
+		view.normalized = normalized != NULL && normalized->boolean;
+		view.count = (size_t)accessor.getUint("count", 0);
+		size_t elementSize = componentSize(view.componentType) * (size_t)view.components;
+		view.stride = (size_t)bufferView.getUint("byteStride", 0);
+		if (view.stride == 0)
+		{
+			view.stride = elementSize;
+		}
+		uint64_t viewOffset = bufferView.getUint("byteOffset", 0);
+		uint64_t viewLength = bufferView.getUint("byteLength", 0);
+		uint64_t offset = accessor.getUint("byteOffset", 0);
+		// 값이 커도 덧셈 / 곱셈이 넘치지 않도록 빼는 방향으로 비교한다
+		if (elementSize == 0 || viewOffset > binSize || viewLength > binSize - viewOffset || offset > viewLength
+			|| (view.count > 0 && (elementSize > viewLength - offset || view.count - 1 > (viewLength - offset - elementSize) / view.stride)))
+		{
+			return (false);
+		}
+		view.data = bin + viewOffset + offset;
+		return (true);
+	}
+
+	float readComponent(const AccessorView &view, size_t element, int component)
+	{
+		const unsigned char *source = view.data + element * view.stride + componentSize(view.componentType) * (size_t)component;
+		switch (view.componentType)
+		{
+			case GLTF_FLOAT:
+			{
+				float value;
+				std::memcpy(&value, source, sizeof(float));
+				return (value);
+			}
+			case GLTF_UNSIGNED_BYTE:
+				return (view.normalized ? *source / 255.0f : (float)*source);
+			case GLTF_BYTE:
+				return (view.normalized ? std::max((signed char)*source / 127.0f, -1.0f) : (float)(signed char)*source);
+			case GLTF_UNSIGNED_SHORT:
+			{
+				uint16_t value;
+				std::memcpy(&value, source, sizeof(uint16_t));
+				return (view.normalized ? value / 65535.0f : (float)value);
+			}
+			case GLTF_SHORT:
+			{
+				int16_t value;
+				std::memcpy(&value, source, sizeof(int16_t));
+				return (view.normalized ? std::max(value / 32767.0f, -1.0f) : (float)value);
+			}
+			default:
+				return (0.0f);
+		}
+	}
+
+	uint32_t readIndex(const AccessorView &view, size_t element)
+	{
+		const unsigned char *source = view.data + element * view.stride;
+		if (view.componentType == GLTF_UNSIGNED_BYTE)
+		{
+			return (*source);
+		}
+		if (view.componentType == GLTF_UNSIGNED_SHORT)
+		{
+			uint16_t value;
+			std::memcpy(&value, source, sizeof(uint16_t));
+			return (value);
+		}
+		uint32_t value;
+		std::memcpy(&value, source, sizeof(uint32_t));
+		return (value);
+	}
+
+	glm::mat4 nodeMatrix(const JsonValue &node)
+	{
+		const JsonValue *matrix = node.find("matrix");
+		if (matrix != NULL && matrix->size() == 16)
+		{
+			// glTF 행렬은 열 우선(column-major) 으로 저장된다
+			glm::mat4 result;
+			for (int column = 0; column < 4; column++)
+			{
+				result[column] = glm::vec4((float)matrix->items[column * 4].number, (float)matrix->items[column * 4 + 1].number, (float)matrix->items[column * 4 + 2].number, (float)matrix->items[column * 4 + 3].number);
+			}
+			return (result);
+		}
+		glm::mat4 result(1.0f);
+		const JsonValue *translation = node.find("translation");
+		if (translation != NULL && translation->size() == 3)
+		{
+			result = glm::translate(result, glm::vec3((float)translation->items[0].number, (float)translation->items[1].number, (float)translation->items[2].number));
+		}
+		const JsonValue *rotation = node.find("rotation");
+		if (rotation != NULL && rotation->size() == 4)
+		{
+			// glTF 쿼터니언은 (x, y, z, w) 순서, glm::quat 생성자는 (w, x, y, z) 순서
+			result = result * glm::mat4_cast(glm::quat((float)rotation->items[3].number, (float)rotation->items[0].number, (float)rotation->items[1].number, (float)rotation->items[2].number));
+		}
+		const JsonValue *scale = node.find("scale");
+		if (scale != NULL && scale->size() == 3)
+		{
+			result = glm::scale(result, glm::vec3((float)scale->items[0].number, (float)scale->items[1].number, (float)scale->items[2].number));
+		}
+		return (result);
+	}
+
+	bool appendPrimitive(const JsonValue &root, const unsigned char *bin, size_t binSize, const JsonValue &primitive, const glm::mat4 &transform, MeshData &mesh)
+	{
+		if (primitive.getInt("mode", GLTF_TRIANGLES) != GLTF_TRIANGLES)
+		{
+			return (true);
+		}
+		const JsonValue *attributes = primitive.find("attributes");
+		AccessorView positions;
+		if (attributes == NULL || !getAccessor(root, bin, binSize, attributes->find("POSITION"), positions) || positions.components != 3)
+		{
+			return (false);
+		}
+		AccessorView texcoords;
+		bool hasTexcoords = attributes->find("TEXCOORD_0") != NULL;
+		if (hasTexcoords && (!getAccessor(root, bin, binSize, attributes->find("TEXCOORD_0"), texcoords) || texcoords.components != 2 || texcoords.count < positions.count))
+		{
+			return (false);
+		}
+		uint32_t baseVertex = (uint32_t)(mesh.vertices.size() / FLOATS_PER_VERTEX);
+		size_t start = mesh.vertices.size();
+		mesh.vertices.resize(start + positions.count * FLOATS_PER_VERTEX);
+		float *out = &mesh.vertices[start];
+		for (size_t v = 0; v < positions.count; v++)
+		{
+			glm::vec4 position = transform * glm::vec4(readComponent(positions, v, 0), readComponent(positions, v, 1), readComponent(positions, v, 2), 1.0f);
+			out[0] = position.x;
+			out[1] = position.y;
+			out[2] = position.z;
+			// glTF 의 텍스처 좌표는 이미지의 위쪽이 v = 0 이고, 텍스처는 뒤집어서 올리므로 v 를 뒤집는다
+			out[3] = hasTexcoords ? readComponent(texcoords, v, 0) : 0.0f;
+			out[4] = hasTexcoords ? 1.0f - readComponent(texcoords, v, 1) : 0.0f;
+			out += FLOATS_PER_VERTEX;
+		}
+		if (primitive.find("indices") == NULL)
+		{
+			for (uint32_t v = 0; v + 2 < positions.count; v += 3)
+			{
+				mesh.indices.insert(mesh.indices.end(), {baseVertex + v, baseVertex + v + 1, baseVertex + v + 2});
+			}
+			return (true);
+		}
+		AccessorView indices;
+		if (!getAccessor(root, bin, binSize, primitive.find("indices"), indices) || indices.components != 1)
+		{
+			return (false);
+		}
+		// 인덱스는 부호 없는 정수만 허용된다, readIndex 가 다른 형식을 32비트 정수로 읽지 않도록 여기서 거른다
+		if (indices.componentType != GLTF_UNSIGNED_BYTE && indices.componentType != GLTF_UNSIGNED_SHORT && indices.componentType != GLTF_UNSIGNED_INT)
+		{
+			return (false);
+		}
+		size_t first = mesh.indices.size();
+		mesh.indices.resize(first + indices.count / 3 * 3);
+		for (size_t i = 0; i < indices.count / 3 * 3; i++)
+		{
+			uint32_t index = readIndex(indices, i);
+			if (index >= positions.count)
+			{
+				return (false);
+			}
+			mesh.indices[first + i] = baseVertex + index;
+		}
+		return (true);
+	}
+
+	// index 는 nodes 배열의 번호 값(씬의 nodes 나 부모의 children 원소)
+	bool appendNode(const JsonValue &root, const unsigned char *bin, size_t binSize, const JsonValue &index, const glm::mat4 &parent, int depth, MeshData &mesh)
+	{
+		const JsonValue *nodes = root.find("nodes");
+		const JsonValue *meshes = root.find("meshes");
+		size_t nodeIndex;
+		// 노드 그래프에 순환이 있는 파일에서 멈추지 않도록 깊이를 제한한다
+		if (nodes == NULL || !index.asIndex(nodes->size(), nodeIndex) || depth > 64)
+		{
+			return (false);
+		}
+		const JsonValue &node = nodes->items[nodeIndex];
+		glm::mat4 transform = parent * nodeMatrix(node);
+		if (node.find("mesh") != NULL)
+		{
+			size_t meshIndex;
+			const JsonValue *primitives = meshes != NULL && node.getIndex("mesh", meshes->size(), meshIndex) ? meshes->items[meshIndex].find("primitives") : NULL;
+			if (primitives == NULL)
+			{
+				return (false);
+			}
+			for (const JsonValue &primitive : primitives->items)
+			{
+				if (!appendPrimitive(root, bin, binSize, primitive, transform, mesh))
+				{
+					return (false);
+				}
+			}
+		}
+		const JsonValue *children = node.find("children");
+		if (children != NULL)
+		{
+			for (const JsonValue &child : children->items)
+			{
+				if (!appendNode(root, bin, binSize, child, transform, depth + 1, mesh))
+				{
+					return (false);
+				}
+			}
+		}
+		return (true);
+	}
+
+	uint32_t readU32(const unsigned char *data)
+	{
+		// GLB 는 리틀 엔디언
+		return ((uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24));
+	}
+}
+
+bool loadObj(const char *text, size_t size, MeshData &mesh, unsigned int threadCount)
+{
+	if (threadCount == 0)
+	{
+		threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+	}
+	size_t chunkCount = std::max<size_t>(std::min<size_t>(threadCount, size / MIN_CHUNK_BYTES), 1);
+
+	// 줄 중간에서 끊기지 않도록 덩어리 경계를 다음 줄의 시작으로 옮긴다
+	std::vector<ObjChunk> chunks(chunkCount);
+	const char *end = text + size;
+	const char *begin = text;
+	for (size_t i = 0; i < chunkCount; i++)
+	{
+		const char *split = i + 1 == chunkCount ? end : nextLine(std::max(begin, text + size / chunkCount * (i + 1)), end);
+		chunks[i].begin = begin;
+		chunks[i].end = split;
+		chunks[i].failed = false;
+		begin = split;
+	}
+
+	// 1단계: 덩어리마다 v / vt / f 를 읽는다
+	parallelFor(chunkCount, [&](size_t i)
+	{
+		parseObjChunk(chunks[i]);
+	});
+
+	// v / vt 는 면이 어느 덩어리에 있든 참조할 수 있으므로 하나로 모은다
+	size_t positionTotal = 0;
+	size_t texcoordTotal = 0;
+	for (ObjChunk &chunk : chunks)
+	{
+		if (chunk.failed)
+		{
+			std::cout << "Failed to parse OBJ" << std::endl;
+			return (false);
+		}
+		chunk.positionBase = positionTotal / 3;
+		chunk.texcoordBase = texcoordTotal / 2;
+		positionTotal += chunk.positions.size();
+		texcoordTotal += chunk.texcoords.size();
+	}
+	std::vector<float> positions;
+	std::vector<float> texcoords;
+	positions.reserve(positionTotal);
+	texcoords.reserve(texcoordTotal);
+	for (ObjChunk &chunk : chunks)
+	{
+		positions.insert(positions.end(), chunk.positions.begin(), chunk.positions.end());
+		texcoords.insert(texcoords.end(), chunk.texcoords.begin(), chunk.texcoords.end());
+		std::vector<float>().swap(chunk.positions);
+		std::vector<float>().swap(chunk.texcoords);
+	}
+
+	// 2단계: 덩어리마다 GPU 형식 정점과 인덱스를 만든다, 덩어리 경계를 넘는 같은 정점은 합치지 않는다
+	parallelFor(chunkCount, [&](size_t i)
+	{
+		buildObjVertices(chunks[i], positions, texcoords);
+	});
+
+	// 3단계: 덩어리 결과를 mesh 의 끝에 이어붙인다, 각 덩어리가 쓸 위치가 정해져 있으므로 복사도 동시에 한다
+	size_t vertexTotal = mesh.vertices.size();
+	size_t indexTotal = mesh.indices.size();
+	for (ObjChunk &chunk : chunks)
+	{
+		if (chunk.failed)
+		{
+			std::cout << "OBJ face references a missing vertex" << std::endl;
+			return (false);
+		}
+		chunk.vertexBase = vertexTotal;
+		chunk.indexBase = indexTotal;
+		vertexTotal += chunk.vertices.size();
+		indexTotal += chunk.indices.size();
+	}
+	mesh.vertices.resize(vertexTotal);
+	mesh.indices.resize(indexTotal);
+	parallelFor(chunkCount, [&](size_t i)
+	{
+		const ObjChunk &chunk = chunks[i];
+		std::copy(chunk.vertices.begin(), chunk.vertices.end(), mesh.vertices.begin() + chunk.vertexBase);
+		uint32_t baseVertex = (uint32_t)(chunk.vertexBase / FLOATS_PER_VERTEX);
+		uint32_t *out = mesh.indices.data() + chunk.indexBase;
+		for (uint32_t index : chunk.indices)
+		{
+			*out++ = baseVertex + index;
+		}
+	});
+	return (true);
+}
+
+bool loadGlb(const unsigned char *data, size_t size, MeshData &mesh)
+{
+	const uint32_t GLB_MAGIC = 0x46546C67;
+	const uint32_t CHUNK_JSON = 0x4E4F534A;
+	const uint32_t CHUNK_BIN = 0x004E4942;
+	if (size < 20 || readU32(data) != GLB_MAGIC || readU32(data + 4) != 2 || readU32(data + 8) > size)
+	{
+		std::cout << "Not a glTF 2.0 binary file" << std::endl;
+		return (false);
+	}
+	size = readU32(data + 8);
+	size_t jsonLength = readU32(data + 12);
+	if (readU32(data + 16) != CHUNK_JSON || 20 + jsonLength > size)
+	{
+		std::cout << "GLB has no JSON chunk" << std::endl;
+		return (false);
+	}
+	const unsigned char *bin = NULL;
+	size_t binSize = 0;
+	// 청크는 4바이트 경계에 맞춰져 있다
+	size_t binHeader = 20 + (jsonLength + 3) / 4 * 4;
+	if (binHeader + 8 <= size && readU32(data + binHeader + 4) == CHUNK_BIN)
+	{
+		binSize = std::min<size_t>(readU32(data + binHeader), size - binHeader - 8);
+		bin = data + binHeader + 8;
+	}
+
+	JsonValue root;
+	JsonParser parser((const char *)data + 20, jsonLength);
+	if (!parser.parse(root) || root.type != JsonValue::Type::OBJECT)
+	{
+		std::cout << "Failed to parse glTF JSON" << std::endl;
+		return (false);
+	}
+
+	// 실패하면 mesh 를 원래대로 되돌린다
+	size_t vertexStart = mesh.vertices.size();
+	size_t indexStart = mesh.indices.size();
+	bool success = true;
+	const JsonValue *scenes = root.find("scenes");
+	if (scenes != NULL && scenes->size() > 0)
+	{
+		// 기본 씬이 없거나 범위를 벗어나면 첫 번째 씬을 읽는다
+		size_t scene;
+		if (!root.getIndex("scene", scenes->size(), scene))
+		{
+			scene = 0;
+		}
+		const JsonValue *roots = scenes->items[scene].find("nodes");
+		for (size_t i = 0; roots != NULL && i < roots->size() && success; i++)
+		{
+			success = appendNode(root, bin, binSize, roots->items[i], glm::mat4(1.0f), 0, mesh);
+		}
+	}
+	else
+	{
+		// 씬이 없으면 모든 메쉬를 변환 없이 읽는다
+		const JsonValue *meshes = root.find("meshes");
+		for (size_t i = 0; meshes != NULL && i < meshes->size() && success; i++)
+		{
+			const JsonValue *primitives = meshes->items[i].find("primitives");
+			for (size_t j = 0; primitives != NULL && j < primitives->size() && success; j++)
+			{
+				success = appendPrimitive(root, bin, binSize, primitives->items[j], glm::mat4(1.0f), mesh);
+			}
+		}
+	}
+	if (!success)
+	{
+		std::cout << "glTF mesh data is missing or out of range" << std::endl;
+		mesh.vertices.resize(vertexStart);
+		mesh.indices.resize(indexStart);
+		return (false);
+	}
+	return (true);
+}
+
+bool loadModel(const std::string &path, MeshData &mesh, unsigned int threadCount)
+{
+	MappedFile file;
+	if (!file.open(path))
+	{
+		std::cout << "Failed to open model: " << path << std::endl;
+		return (false);
+	}
+	std::string extension = path.substr(std::min(path.find_last_of('.'), path.size()));
+	std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c)
+	{
+		return ((char)std::tolower(c));
+	});
+	if (extension == ".obj")
+	{
+		return (loadObj((const char *)file.getData(), file.getSize(), mesh, threadCount));
+	}
+	if (extension == ".glb")
+	{
+		return (loadGlb(file.getData(), file.getSize(), mesh));
+	}
+	std::cout << "Unsupported model format: " << path << std::endl;
+	return (false);
+}
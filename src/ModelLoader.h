@@ -0,0 +1,22 @@
+#ifndef MODEL_LOADER_H
+#define MODEL_LOADER_H
+
+#include "MeshArena.h"
+
+#include <cstddef>
+#include <string>
+
+// 모델 파일을 읽어서 위치 + 텍스처 좌표(5 float, CubeLayout 과 같은 형식) 정점과 삼각형 인덱스를 mesh 뒤에 추가한다
+// 파일은 메모리에 매핑해서 복사 없이 파싱하고, 정점은 정점마다 객체를 만들지 않고 mesh 의 float 배열에 바로 쓴다
+// 확장자가 .obj 이면 OBJ, .glb 이면 glTF 2.0 바이너리로 읽는다. 실패하면 이유를 출력하고 false, mesh 는 바뀌지 않는다
+// threadCount 는 OBJ 파싱에 쓸 스레드 수, 0 이면 코어 수
+bool loadModel(const std::string &path, MeshData &mesh, unsigned int threadCount = 0);
+
+// OBJ 텍스트를 줄 단위로 나눈 덩어리로 여러 스레드에서 동시에 파싱한 뒤 합친다
+// v / vt / f 만 읽고, 다각형 면은 부채꼴로 삼각형화한다. 음수(상대) 인덱스도 지원한다
+bool loadObj(const char *text, size_t size, MeshData &mesh, unsigned int threadCount = 0);
+// glTF 2.0 바이너리(.glb), 기본 씬의 노드 변환을 정점에 적용하고 삼각형 목록(mode 4) primitive 만 읽는다
+// 정점 데이터는 GLB 안의 BIN 청크에 있어야 한다 (외부 .bin / data URI 는 지원하지 않는다)
+bool loadGlb(const unsigned char *data, size_t size, MeshData &mesh);
+
+#endif
@@ -0,0 +1,289 @@
+#include "OcclusionCuller.h"
+
+#include <algorithm>
+#include <cmath>
+
+// SIMD 경로는 컴파일 옵션으로 선택한다 (CMake 의 ENABLE_AVX2 옵션 참고)
+// OCCLUSION_NO_SIMD 를 정의하면 스칼라 경로로 빌드한다, 테스트에서 세 경로의 결과를 비교할 때 쓴다
+#if !defined(OCCLUSION_NO_SIMD)
+	#if defined(__AVX2__)
+		#define OCCLUSION_AVX2
+	#endif
+	#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+		#define OCCLUSION_SSE2
+	#endif
+#endif
+
+#if defined(OCCLUSION_AVX2)
+	#include <immintrin.h>
+#elif defined(OCCLUSION_SSE2)
+	#include <emmintrin.h>
+#endif
+
+namespace
+{
+	// 한 번에 처리하는 픽셀 수, 행의 길이는 항상 이 값의 배수다
+	const int LANES = 8;
+	// 이보다 가까운 w 는 근평면 뒤로 보고 잘라낸다
+	const float NEAR_W = 1e-4f;
+	const float EMPTY_DEPTH = 1e30f;
+
+	// 픽셀 중심 x 에서 edge 함수 값이 e = a * x + rowBase 인 세 변 모두 안쪽인 픽셀에, 평면 깊이 z = dzdx * x + zRow 를 더 가까우면 쓴다
+	// [x, x + LANES) 범위를 처리한다
+	void rasterizeSpan(float *row, int x, const float a[3], const float rowBase[3], float dzdx, float zRow)
+	{
+#if defined(OCCLUSION_AVX2)
+		__m256 px = _mm256_add_ps(_mm256_set1_ps((float)x + 0.5f), _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f));
+		__m256 zero = _mm256_setzero_ps();
+		__m256 inside = _mm256_cmp_ps(_mm256_fmadd_ps(_mm256_set1_ps(a[0]), px, _mm256_set1_ps(rowBase[0])), zero, _CMP_GE_OQ);
+		inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_fmadd_ps(_mm256_set1_ps(a[1]), px, _mm256_set1_ps(rowBase[1])), zero, _CMP_GE_OQ));
+		inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_fmadd_ps(_mm256_set1_ps(a[2]), px, _mm256_set1_ps(rowBase[2])), zero, _CMP_GE_OQ));
+		if (_mm256_movemask_ps(inside) == 0)
+		{
+			return;
+		}
+		__m256 z = _mm256_fmadd_ps(_mm256_set1_ps(dzdx), px, _mm256_set1_ps(zRow));
+		__m256 current = _mm256_loadu_ps(row + x);
+		_mm256_storeu_ps(row + x, _mm256_blendv_ps(current, _mm256_min_ps(current, z), inside));
+#elif defined(OCCLUSION_SSE2)
+		for (int half = 0; half < LANES; half += 4)
+		{
+			__m128 px = _mm_add_ps(_mm_set1_ps((float)(x + half) + 0.5f), _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f));
+			__m128 zero = _mm_setzero_ps();
+			__m128 inside = _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(a[0]), px), _mm_set1_ps(rowBase[0])), zero);
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(a[1]), px), _mm_set1_ps(rowBase[1])), zero));
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(a[2]), px), _mm_set1_ps(rowBase[2])), zero));
+			if (_mm_movemask_ps(inside) == 0)
+			{
+				continue;
+			}
+			__m128 z = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(dzdx), px), _mm_set1_ps(zRow));
+			__m128 current = _mm_loadu_ps(row + x + half);
+			__m128 closer = _mm_min_ps(current, z);
+			_mm_storeu_ps(row + x + half, _mm_or_ps(_mm_and_ps(inside, closer), _mm_andnot_ps(inside, current)));
+		}
+#else
+		for (int i = 0; i < LANES; i++)
+		{
+			float px = (float)(x + i) + 0.5f;
+			if (a[0] * px + rowBase[0] >= 0.0f && a[1] * px + rowBase[1] >= 0.0f && a[2] * px + rowBase[2] >= 0.0f)
+			{
+				row[x + i] = std::min(row[x + i], dzdx * px + zRow);
+			}
+		}
+#endif
+	}
+
+	// [x, x + LANES) 중 [minX, maxX] 안에 있고 깊이가 z 이상(더 멀거나 같은) 인 픽셀이 있는지
+	bool anyFartherInSpan(const float *row, int x, int minX, int maxX, float z)
+	{
+#if defined(OCCLUSION_AVX2)
+		__m256i lane = _mm256_add_epi32(_mm256_set1_epi32(x), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+		__m256i inRange = _mm256_andnot_si256(_mm256_or_si256(_mm256_cmpgt_epi32(_mm256_set1_epi32(minX), lane), _mm256_cmpgt_epi32(lane, _mm256_set1_epi32(maxX))), _mm256_set1_epi32(-1));
+		__m256 farther = _mm256_cmp_ps(_mm256_loadu_ps(row + x), _mm256_set1_ps(z), _CMP_GE_OQ);
+		return (_mm256_movemask_ps(_mm256_and_ps(farther, _mm256_castsi256_ps(inRange))) != 0);
+#elif defined(OCCLUSION_SSE2)
+		for (int half = 0; half < LANES; half += 4)
+		{
+			__m128i lane = _mm_add_epi32(_mm_set1_epi32(x + half), _mm_setr_epi32(0, 1, 2, 3));
+			__m128i outRange = _mm_or_si128(_mm_cmplt_epi32(lane, _mm_set1_epi32(minX)), _mm_cmpgt_epi32(lane, _mm_set1_epi32(maxX)));
+			__m128 farther = _mm_cmpge_ps(_mm_loadu_ps(row + x + half), _mm_set1_ps(z));
+			if (_mm_movemask_ps(_mm_andnot_ps(_mm_castsi128_ps(outRange), farther)) != 0)
+			{
+				return (true);
+			}
+		}
+		return (false);
+#else
+		for (int i = std::max(x, minX); i <= std::min(x + LANES - 1, maxX); i++)
+		{
+			if (row[i] >= z)
+			{
+				return (true);
+			}
+		}
+		return (false);
+#endif
+	}
+}
+
+OcclusionCuller::OcclusionCuller(int width, int height) : width(width), height(height), occluderTriangles(0)
+{
+	stride = (width + LANES - 1) / LANES * LANES;
+	depth.resize((size_t)stride * height);
+	clear();
+}
+
+void OcclusionCuller::clear()
+{
+	std::fill(depth.begin(), depth.end(), EMPTY_DEPTH);
+	occluderTriangles = 0;
+}
+
+void OcclusionCuller::addOccluder(const glm::mat4 &modelViewProjection, const glm::vec3 *positions, size_t vertexCount)
+{
+	for (size_t i = 0; i + 2 < vertexCount; i += 3)
+	{
+		clipAndRasterize(modelViewProjection * glm::vec4(positions[i], 1.0f), modelViewProjection * glm::vec4(positions[i + 1], 1.0f), modelViewProjection * glm::vec4(positions[i + 2], 1.0f));
+		occluderTriangles++;
+	}
+}
+
+void OcclusionCuller::clipAndRasterize(const glm::vec4 &c0, const glm::vec4 &c1, const glm::vec4 &c2)
+{
+	// 근평면(z = -w) 안쪽 거리, 양수면 안쪽
+	const glm::vec4 input[3] = {c0, c1, c2};
+	float distance[3];
+	int insideCount = 0;
+	for (int i = 0; i < 3; i++)
+	{
+		distance[i] = input[i].z + input[i].w;
+		if (distance[i] >= 0.0f)
+		{
+			insideCount++;
+		}
+	}
+	if (insideCount == 0)
+	{
+		return;
+	}
+
+	// 삼각형을 평면 하나로 자르면 꼭짓점이 최대 4개인 볼록 다각형이 된다
+	glm::vec4 clipped[4];
+	int clippedCount = 0;
+	if (insideCount == 3)
+	{
+		clipped[0] = c0;
+		clipped[1] = c1;
+		clipped[2] = c2;
+		clippedCount = 3;
+	}
+	else
+	{
+		for (int i = 0; i < 3; i++)
+		{
+			int j = (i + 1) % 3;
+			bool insideI = distance[i] >= 0.0f;
+			bool insideJ = distance[j] >= 0.0f;
+			if (insideI)
+			{
+				clipped[clippedCount++] = input[i];
+			}
+			if (insideI != insideJ)
+			{
+				float t = distance[i] / (distance[i] - distance[j]);
+				clipped[clippedCount++] = input[i] + (input[j] - input[i]) * t;
+			}
+		}
+	}
+
+	glm::vec3 screen[4];
+	for (int i = 0; i < clippedCount; i++)
+	{
+		float w = std::max(clipped[i].w, NEAR_W);
+		screen[i] = glm::vec3((clipped[i].x / w * 0.5f + 0.5f) * width, (clipped[i].y / w * 0.5f + 0.5f) * height, clipped[i].z / w);
+	}
+	for (int i = 1; i + 1 < clippedCount; i++)
+	{
+		rasterizeTriangle(screen[0], screen[i], screen[i + 1]);
+	}
+}
+
+void OcclusionCuller::rasterizeTriangle(const glm::vec3 &v0, const glm::vec3 &v1, const glm::vec3 &v2)
+{
+	float area = (v1.x - v0.x) * (v2.y - v0.y) - (v2.x - v0.x) * (v1.y - v0.y);
+	if (std::abs(area) < 1e-6f)
+	{
+		return;
+	}
+	// 뒷면도 그리기 위해 항상 반시계 방향으로 맞춘다
+	const glm::vec3 &p0 = v0;
+	const glm::vec3 &p1 = area > 0.0f ? v1 : v2;
+	const glm::vec3 &p2 = area > 0.0f ? v2 : v1;
+	area = std::abs(area);
+
+	int minX = std::max(0, (int)std::floor(std::min(std::min(p0.x, p1.x), p2.x)));
+	int maxX = std::min(width - 1, (int)std::ceil(std::max(std::max(p0.x, p1.x), p2.x)));
+	int minY = std::max(0, (int)std::floor(std::min(std::min(p0.y, p1.y), p2.y)));
+	int maxY = std::min(height - 1, (int)std::ceil(std::max(std::max(p0.y, p1.y), p2.y)));
+	if (minX > maxX || minY > maxY)
+	{
+		return;
+	}
+
+	// edge i 는 꼭짓점 i 맞은편 변, 값은 e = a * x + b * y + c 이고 안쪽에서 양수
+	const glm::vec3 *p[3] = {&p0, &p1, &p2};
+	float a[3];
+	float b[3];
+	float c[3];
+	for (int i = 0; i < 3; i++)
+	{
+		const glm::vec3 &from = *p[(i + 1) % 3];
+		const glm::vec3 &to = *p[(i + 2) % 3];
+		a[i] = from.y - to.y;
+		b[i] = to.x - from.x;
+		c[i] = from.x * to.y - from.y * to.x;
+	}
+	// 무게중심 좌표로 깊이 평면 z = dzdx * x + dzdy * y + z0 를 구한다
+	float dzdx = (a[0] * p0.z + a[1] * p1.z + a[2] * p2.z) / area;
+	float dzdy = (b[0] * p0.z + b[1] * p1.z + b[2] * p2.z) / area;
+	float z0 = (c[0] * p0.z + c[1] * p1.z + c[2] * p2.z) / area;
+
+	int startX = minX / LANES * LANES;
+	for (int y = minY; y <= maxY; y++)
+	{
+		float py = (float)y + 0.5f;
+		float rowBase[3] = {b[0] * py + c[0], b[1] * py + c[1], b[2] * py + c[2]};
+		float zRow = dzdy * py + z0;
+		float *row = depth.data() + (size_t)y * stride;
+		for (int x = startX; x <= maxX; x += LANES)
+		{
+			rasterizeSpan(row, x, a, rowBase, dzdx, zRow);
+		}
+	}
+}
+
+bool OcclusionCuller::isVisible(const glm::mat4 &viewProjection, const Aabb &box) const
+{
+	glm::vec2 screenMin(FLT_MAX);
+	glm::vec2 screenMax(-FLT_MAX);
+	float nearest = FLT_MAX;
+	for (int i = 0; i < 8; i++)
+	{
+		glm::vec3 corner((i & 1) ? box.max.x : box.min.x, (i & 2) ? box.max.y : box.min.y, (i & 4) ? box.max.z : box.min.z);
+		glm::vec4 clip = viewProjection * glm::vec4(corner, 1.0f);
+		if (clip.w <= NEAR_W || clip.z < -clip.w)
+		{
+			return (true);
+		}
+		glm::vec2 screen((clip.x / clip.w * 0.5f + 0.5f) * width, (clip.y / clip.w * 0.5f + 0.5f) * height);
+		screenMin = glm::min(screenMin, screen);
+		screenMax = glm::max(screenMax, screen);
+		nearest = std::min(nearest, clip.z / clip.w);
+	}
+
+	// 박스가 걸치는 픽셀에서 바깥쪽으로 한 픽셀씩 넓힌 범위
+	// 가리개는 픽셀 중심에서만 샘플링하므로, 중심이 덮인 픽셀도 중심에서 벗어난 부분은 비어 있을 수 있다
+	// 그 부분에 걸친 박스가 가려졌다고 판단하지 않도록, 가리개 가장자리 바깥쪽 이웃 픽셀까지 검사한다
+	int minX = std::max(0, (int)std::floor(screenMin.x) - 1);
+	int maxX = std::min(width - 1, (int)std::floor(screenMax.x) + 1);
+	int minY = std::max(0, (int)std::floor(screenMin.y) - 1);
+	int maxY = std::min(height - 1, (int)std::floor(screenMax.y) + 1);
+	if (minX > maxX || minY > maxY)
+	{
+		return (false);
+	}
+	int startX = minX / LANES * LANES;
+	for (int y = minY; y <= maxY; y++)
+	{
+		const float *row = depth.data() + (size_t)y * stride;
+		for (int x = startX; x <= maxX; x += LANES)
+		{
+			if (anyFartherInSpan(row, x, minX, maxX, nearest))
+			{
+				return (true);
+			}
+		}
+	}
+	return (false);
+}
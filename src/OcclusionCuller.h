@@ -0,0 +1,62 @@
+#ifndef OCCLUSION_CULLER_H
+#define OCCLUSION_CULLER_H
+
+#include "Bounds.h"
+
+#include <vector>
+
+// CPU 에서 가리개(occluder) 삼각형을 저해상도 깊이 버퍼에 그리고, 물체의 바운딩 박스를 그 버퍼와 비교해서
+// 완전히 가려진 물체를 그리기 명령을 만들기 전에 걸러낸다. GPU 의 깊이 테스트는 명령을 제출한 뒤에야 프래그먼트를 버리므로
+// 빽빽한 장면에서는 이 단계가 그리기 호출 수 자체를 줄인다
+// 깊이는 NDC z(-1 ~ 1) 로 저장하고 작을수록 가깝다. 버퍼의 행은 아래에서 위로(NDC y 와 같은 방향) 저장된다
+// 래스터화 / 검사의 안쪽 루프는 한 번에 8픽셀(AVX2) 또는 4픽셀(SSE2) 을 처리한다 (CMake 의 ENABLE_AVX2 옵션 참고)
+class OcclusionCuller
+{
+	private:
+		int width;
+		int height;
+		// SIMD 폭(8) 의 배수로 올린 한 행의 float 수
+		int stride;
+		std::vector<float> depth;
+		size_t occluderTriangles;
+
+		// 화면 좌표(x, y) 와 NDC z 로 변환된 삼각형 하나를 그린다
+		void rasterizeTriangle(const glm::vec3 &v0, const glm::vec3 &v1, const glm::vec3 &v2);
+		// 클립 공간 삼각형을 근평면으로 자른 뒤 화면 좌표로 바꿔서 그린다
+		void clipAndRasterize(const glm::vec4 &c0, const glm::vec4 &c1, const glm::vec4 &c2);
+
+	public:
+		OcclusionCuller(int width, int height);
+
+		// 프레임 시작 시 깊이 버퍼를 비운다
+		void clear();
+		// 삼각형 목록(정점 3개씩) 으로 된 가리개를 그린다, 뒷면도 그리므로 감기 순서는 상관없다
+		// 가리개는 화면을 많이 덮는 가까운 물체만 고르는 것이 좋다, 작은 물체는 그리는 비용에 비해 가리는 것이 거의 없다
+		void addOccluder(const glm::mat4 &modelViewProjection, const glm::vec3 *positions, size_t vertexCount);
+		// 박스의 화면 사각형(바깥쪽으로 한 픽셀 넓힌) 안에 박스의 가장 가까운 깊이보다 먼 픽셀이 하나라도 있으면 보인다
+		// 박스가 근평면에 걸치면 보수적으로 보인다고 판단한다
+		bool isVisible(const glm::mat4 &viewProjection, const Aabb &box) const;
+
+		int getWidth() const
+		{
+			return (width);
+		}
+
+		int getHeight() const
+		{
+			return (height);
+		}
+
+		size_t getOccluderTriangleCount() const
+		{
+			return (occluderTriangles);
+		}
+
+		// 디버깅용, 깊이 버퍼의 (x, y) 값
+		float getDepth(int x, int y) const
+		{
+			return (depth[(size_t)y * stride + x]);
+		}
+};
+
+#endif
@@ -0,0 +1,176 @@
+#include "RenderThread.h"
+
+#include <chrono>
+#include <iostream>
+
+namespace
+{
+	double elapsedSeconds(std::chrono::steady_clock::time_point start)
+	{
+		return (std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+	}
+}
+
+CameraLatch::CameraLatch() : inputTime(0.0), valid(false)
+{
+}
+
+void CameraLatch::publish(const glm::quat &orientation, double inputTime)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	this->orientation = orientation;
+	if (this->inputTime == 0.0)
+	{
+		this->inputTime = inputTime;
+	}
+	valid = true;
+}
+
+bool CameraLatch::consume(glm::quat &orientation, double &inputTime)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	if (!valid)
+	{
+		return (false);
+	}
+	orientation = this->orientation;
+	inputTime = this->inputTime;
+	this->inputTime = 0.0;
+	return (true);
+}
+
+RenderThread::RenderThread(GLFWwindow *window) : window(window), frameArena(2, FRAME_ARENA_SIZE), packets{FramePacket(frameArena.getFrame(0)), FramePacket(frameArena.getFrame(1))}, writeIndex(0), readyIndex(-1), readingIndex(-1), stopping(false), swapInterval(1), appliedSwapInterval(-2), framesRendered(0), producerWaitSeconds(0.0), consumerWaitSeconds(0.0), frameTimes("Frame time"), inputLatency("Input to swap latency"), lastSwapTime(0.0)
+{
+}
+
+RenderThread::~RenderThread()
+{
+	stop();
+}
+
+void RenderThread::start(std::function<double(const FramePacket &)> renderFrame)
+{
+	if (thread.joinable())
+	{
+		return;
+	}
+	this->renderFrame = renderFrame;
+	stopping = false;
+	// 컨텍스트는 한 번에 한 스레드에서만 current 일 수 있다
+	glfwMakeContextCurrent(NULL);
+	thread = std::thread(&RenderThread::run, this);
+}
+
+FramePacket &RenderThread::beginFrame()
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	std::unique_lock<std::mutex> lock(mutex);
+	condition.wait(lock, [this]()
+	{
+		return (readingIndex != writeIndex && readyIndex != writeIndex);
+	});
+	producerWaitSeconds += elapsedSeconds(start);
+	lock.unlock();
+	packets[writeIndex].reset();
+	return (packets[writeIndex]);
+}
+
+void RenderThread::submit()
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	std::unique_lock<std::mutex> lock(mutex);
+	// 이전 패킷을 렌더 스레드가 가져갈 때까지 기다린다, 패킷을 건너뛰지 않고 메인 스레드가 두 프레임 이상 앞서가지 않게 한다
+	condition.wait(lock, [this]()
+	{
+		return (readyIndex == -1 || stopping);
+	});
+	producerWaitSeconds += elapsedSeconds(start);
+	readyIndex = writeIndex;
+	writeIndex ^= 1;
+	condition.notify_all();
+}
+
+void RenderThread::setSwapInterval(int interval)
+{
+	swapInterval = interval;
+}
+
+void RenderThread::stop()
+{
+	if (!thread.joinable())
+	{
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	condition.notify_all();
+	thread.join();
+	glfwMakeContextCurrent(window);
+}
+
+void RenderThread::printStats()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	if (framesRendered == 0)
+	{
+		return;
+	}
+	std::cout << "RenderThread: " << framesRendered << " frames, main thread waited " << producerWaitSeconds * 1000.0 / framesRendered << " ms/frame, render thread waited " << consumerWaitSeconds * 1000.0 / framesRendered << " ms/frame" << std::endl;
+	frameTimes.print();
+	inputLatency.print();
+	frameArena.printStats();
+}
+
+void RenderThread::run()
+{
+	glfwMakeContextCurrent(window);
+	while (true)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			condition.wait(lock, [this]()
+			{
+				return (readyIndex != -1 || stopping);
+			});
+			consumerWaitSeconds += elapsedSeconds(start);
+			if (readyIndex == -1)
+			{
+				break;
+			}
+			readingIndex = readyIndex;
+			readyIndex = -1;
+		}
+		condition.notify_all();
+
+		int interval = swapInterval;
+		if (interval != appliedSwapInterval)
+		{
+			glfwSwapInterval(interval);
+			appliedSwapInterval = interval;
+		}
+		double inputTime = renderFrame(packets[readingIndex]);
+		glfwSwapBuffers(window);
+		// 스왑이 끝난 시점을 화면에 표시된 시점으로 본다 (실제 스캔아웃은 디스플레이에 따라 더 늦을 수 있다)
+		double swapTime = glfwGetTime();
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			readingIndex = -1;
+			framesRendered++;
+			if (lastSwapTime > 0.0)
+			{
+				frameTimes.add((swapTime - lastSwapTime) * 1000.0);
+			}
+			if (inputTime > 0.0)
+			{
+				inputLatency.add((swapTime - inputTime) * 1000.0);
+			}
+			lastSwapTime = swapTime;
+		}
+		condition.notify_all();
+	}
+	glfwMakeContextCurrent(NULL);
+}
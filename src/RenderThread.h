@@ -0,0 +1,97 @@
+#ifndef RENDER_THREAD_H
+#define RENDER_THREAD_H
+
+#include "Camera.h"
+#include "FramePacket.h"
+#include "FrameStats.h"
+
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// late latch 용 카메라 방향 저장소
+// 메인 스레드가 입력을 처리할 때마다 최신 방향을 올려두고, 렌더 스레드는 패킷의 방향 대신 그리기 직전에 이 값을 가져간다
+// 메인 스레드는 한 프레임 앞서 있으므로 렌더 스레드가 보는 방향은 패킷보다 한 프레임 더 최신이다
+// 모델 행렬이 패킷의 카메라 위치를 기준으로 만들어져 있으므로 위치는 바꾸지 않고 방향만 가져간다
+class CameraLatch
+{
+	private:
+		std::mutex mutex;
+		glm::quat orientation;
+		double inputTime;
+		bool valid;
+
+	public:
+		CameraLatch();
+
+		// inputTime 은 이번 방향에 처음 반영된 입력의 시간, 없으면 0
+		void publish(const glm::quat &orientation, double inputTime);
+		// 가장 최근 방향과, 지난번 consume 이후 반영된 입력 중 가장 오래된 것의 시간을 가져온다. 올라온 방향이 없으면 false
+		bool consume(glm::quat &orientation, double &inputTime);
+};
+
+// GL 컨텍스트를 소유하고 GL 호출과 glfwSwapBuffers 를 전담하는 스레드
+// 패킷은 두 개를 번갈아 사용해서, 렌더 스레드가 프레임 N 을 제출하는 동안 메인 스레드가 프레임 N+1 을 시뮬레이션한다
+// 메인 스레드는 최대 한 프레임까지만 앞서가므로 입력 지연이 늘어나지 않는다
+class RenderThread
+{
+	private:
+		// 패킷 하나의 프레임 할당기 시작 크기, 모자라면 알아서 늘어난다
+		static const size_t FRAME_ARENA_SIZE = 256 * 1024;
+
+		GLFWwindow *window;
+		std::function<double(const FramePacket &)> renderFrame;
+		// 패킷마다 하나씩, 렌더 스레드가 읽고 있는 패킷의 메모리를 메인 스레드가 덮어쓰지 않는다
+		FrameArena frameArena;
+		FramePacket packets[2];
+		// 메인 스레드가 채우는 패킷
+		int writeIndex;
+		// 제출되었지만 렌더 스레드가 아직 가져가지 않은 패킷, 없으면 -1
+		int readyIndex;
+		// 렌더 스레드가 그리고 있는 패킷, 없으면 -1
+		int readingIndex;
+		bool stopping;
+		// 요청된 스왑 간격, 렌더 스레드가 다음 프레임을 그리기 전에 적용한다 (컨텍스트가 있는 스레드에서만 설정할 수 있다)
+		std::atomic<int> swapInterval;
+		int appliedSwapInterval;
+		std::mutex mutex;
+		std::condition_variable condition;
+		std::thread thread;
+
+		unsigned long long framesRendered;
+		// 메인 스레드가 패킷이 비기를 기다린 시간, 렌더 스레드가 패킷을 기다린 시간
+		double producerWaitSeconds;
+		double consumerWaitSeconds;
+		// 스왑 간격과, 입력 시간에서 그 입력이 반영된 프레임의 glfwSwapBuffers 가 끝날 때까지의 시간
+		FrameStats frameTimes;
+		FrameStats inputLatency;
+		double lastSwapTime;
+
+		void run();
+
+	public:
+		RenderThread(GLFWwindow *window);
+		~RenderThread();
+
+		// 메인 스레드의 GL 컨텍스트를 놓고 렌더 스레드에서 다시 잡는다. 이후 GL 호출은 renderFrame 안에서만 해야 한다
+		// renderFrame 은 그 프레임에 반영한 입력의 시간(FramePacket::inputTime 또는 late latch 로 가져온 시간, 없으면 0) 을 반환한다
+		void start(std::function<double(const FramePacket &)> renderFrame);
+		// 다음에 채울 패킷, 렌더 스레드가 아직 그 패킷을 읽고 있으면 끝날 때까지 기다린다
+		// 패킷의 배열은 비어 있고 이전 프레임의 scratch 할당은 모두 무효가 된다
+		FramePacket &beginFrame();
+		// beginFrame 으로 채운 패킷을 렌더 스레드에 넘긴다
+		void submit();
+		// 0 이면 수직 동기화를 끄고, 1 이상이면 그만큼의 수직 동기화마다 스왑한다 (-1 은 adaptive vsync 를 지원하는 드라이버에서만)
+		void setSwapInterval(int interval);
+		// 제출된 패킷까지 그린 뒤 스레드를 멈추고 GL 컨텍스트를 메인 스레드로 되돌린다
+		void stop();
+		void printStats();
+};
+
+#endif
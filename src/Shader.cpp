@@ -1,35 +1,119 @@
 #include "Shader.h"
 
-Shader::Shader(const char *vertexPath, const char *fragmentPath)
+Shader::Shader(const char *vertexPath, const char *fragmentPath, const std::vector<std::string> &defines, ShaderCache *cache) : vertexPath(vertexPath), fragmentPath(fragmentPath), defines(defines), cache(cache), pendingID(0), ID(0)
 {
+	std::cout << "Vertex Shader Path: " << vertexPath << "\n";
+	std::cout << "Fragment Shader Path: " << fragmentPath << "\n";
+	ID = build();
+	if (ID == 0)
+	{
+		std::cout << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ" << std::endl;
+	}
+}
+
+const std::string &Shader::getVertexPath() const
+{
+	return (vertexPath);
+}
+
+const std::string &Shader::getFragmentPath() const
+{
+	return (fragmentPath);
+}
+
+const std::vector<std::string> &Shader::getSourceFiles() const
+{
+	return (sourceFiles);
+}
+
+bool Shader::rebuild()
+{
+	unsigned int program = build();
+	if (program == 0)
+	{
+		std::cout << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ" << std::endl;
+		return (false);
+	}
+	int success;
+	glGetProgramiv(program, GL_LINK_STATUS, &success);
+	if (!success)
+	{
+		// 컴파일에 실패하면 지금 사용 중인 프로그램을 그대로 유지한다
+		glDeleteProgram(program);
+		return (false);
+	}
+	// 다른 컨텍스트에서 만든 객체는 명령이 모두 끝난 뒤에야 메인 컨텍스트에서 안전하게 사용할 수 있다
+	glFinish();
+	unsigned int previous = pendingID.exchange(program);
+	if (previous != 0)
+	{
+		glDeleteProgram(previous);
+	}
+	return (true);
+}
+
+bool Shader::applyPendingReload()
+{
+	unsigned int program = pendingID.exchange(0);
+	if (program == 0)
+	{
+		return (false);
+	}
+	glDeleteProgram(ID);
+	ID = program;
+	return (true);
+}
+
+void Shader::clear()
+{
+	unsigned int program = pendingID.exchange(0);
+	if (program != 0)
+	{
+		glDeleteProgram(program);
+	}
+	if (ID != 0)
+	{
+		glDeleteProgram(ID);
+		ID = 0;
+	}
+}
+
+unsigned int Shader::build()
+{
+	// #include 와 permutation 정의를 펼친 최종 소스를 만든다
 	std::string vertexCode;
 	std::string fragmentCode;
-	std::ifstream vShaderFile;
-	std::ifstream fShaderFile;
+	std::vector<std::string> fragmentFiles;
+	if (!ShaderPreprocessor::process(vertexPath, defines, vertexCode, sourceFiles) || !ShaderPreprocessor::process(fragmentPath, defines, fragmentCode, fragmentFiles))
+	{
+		return (0);
+	}
+	sourceFiles.insert(sourceFiles.end(), fragmentFiles.begin(), fragmentFiles.end());
 
-	vShaderFile.exceptions (std::ifstream::failbit | std::ifstream::badbit);
-	fShaderFile.exceptions (std::ifstream::failbit | std::ifstream::badbit);
-	try
+	// 같은 소스로 링크해 둔 바이너리가 디스크 캐시에 있으면 컴파일을 건너뛴다
+	uint64_t hash = 0;
+	bool cached = cache != NULL && cache->isSupported();
+	if (cached)
 	{
-		std::cout << "Vertex Shader Path: " << vertexPath << "\n";
-		std::cout << "Fragment Shader Path: " << fragmentPath << "\n";
-
-		vShaderFile.open(vertexPath);
-		fShaderFile.open(fragmentPath);
-		std::cout << "file open success\n";
-		std::stringstream vShaderStream;
-		std::stringstream fShaderStream;
-		vShaderStream << vShaderFile.rdbuf();
-		fShaderStream << fShaderFile.rdbuf();
-		vShaderFile.close();
-		fShaderFile.close();
-		vertexCode = vShaderStream.str();
-		fragmentCode = fShaderStream.str();
+		hash = cache->hashSources(vertexCode, fragmentCode);
+		unsigned int program = cache->load(hash);
+		if (program != 0)
+		{
+			return (program);
+		}
 	}
-	catch(std::ifstream::failure e)
+	unsigned int program = compileProgram(vertexCode, fragmentCode, cached);
+	int success;
+	glGetProgramiv(program, GL_LINK_STATUS, &success);
+	if (cached && success)
 	{
-		std::cout << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ" << std::endl;
+		cache->store(hash, program);
 	}
+	return (program);
+}
+
+unsigned int Shader::compileProgram(const std::string &vertexCode, const std::string &fragmentCode, bool retrievable)
+{
 	const char *vShaderCode = vertexCode.c_str();
 	const char *fShaderCode = fragmentCode.c_str();
 
@@ -44,13 +128,19 @@ Shader::Shader(const char *vertexPath, const char *fragmentPath)
 	glShaderSource(fragment, 1, &fShaderCode, NULL);
 	glCompileShader(fragment);
 	checkCompileErrors(fragment, "FRAGMENT");
-	ID = glCreateProgram();
-	glAttachShader(ID, vertex);
-	glAttachShader(ID, fragment);
-	glLinkProgram(ID);
-	checkCompileErrors(ID, "PROGRAM");
+	unsigned int program = glCreateProgram();
+	glAttachShader(program, vertex);
+	glAttachShader(program, fragment);
+	// 링크 전에 설정해야 링크 후 glGetProgramBinary 로 바이너리를 얻을 수 있다
+	if (retrievable)
+	{
+		glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	}
+	glLinkProgram(program);
+	checkCompileErrors(program, "PROGRAM");
 	glDeleteShader(vertex);
 	glDeleteShader(fragment);
+	return (program);
 }
 
 void Shader::use()
@@ -58,6 +148,17 @@ void Shader::use()
 	glUseProgram(ID);
 }
 
+bool Shader::bindUniformBlock(const std::string &name, unsigned int binding) const
+{
+	unsigned int index = glGetUniformBlockIndex(ID, name.c_str());
+	if (index == GL_INVALID_INDEX)
+	{
+		return (false);
+	}
+	glUniformBlockBinding(ID, index, binding);
+	return (true);
+}
+
 void Shader::setBool(const std::string &name, bool value) const
 {
 	glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value);
@@ -119,7 +220,7 @@ void Shader::setMat4(const std::string &name, const glm::mat4 &mat) const
 }
 
 
-void Shader::checkCompileErrors(unsigned int shader, std::string type)
+bool Shader::checkCompileErrors(unsigned int shader, std::string type)
 {
 	int success;
 	char infoLog[1024];
@@ -141,4 +242,5 @@ void Shader::checkCompileErrors(unsigned int shader, std::string type)
 			std::cout<< "ERROR::PROGRAM_LINKING_ERROR of type: " << type << "\n" << infoLog << "\n -- --------------------------------------------------- -- " << std::endl;
 		}
 	}
+	return (success != 0);
 }
\ No newline at end of file
@@ -1,26 +1,58 @@
 #ifndef SHADER_H
 #define SHADER_H
 
+#include "ShaderCache.h"
+#include "ShaderPreprocessor.h"
+
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include <atomic>
 #include <string>
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <vector>
 
 class Shader
 {
 	private:
-		void checkCompileErrors(unsigned int shader, std::string type);
+		std::string vertexPath;
+		std::string fragmentPath;
+		// permutation 을 만드는 #define 목록, 전처리 단계에서 #version 바로 뒤에 삽입된다
+		std::vector<std::string> defines;
+		// #include 로 포함된 파일까지 포함한, 이 프로그램을 만드는 데 읽은 모든 파일
+		std::vector<std::string> sourceFiles;
+		// 프로그램 바이너리 디스크 캐시, NULL 이면 항상 소스에서 컴파일
+		ShaderCache *cache;
+		// 백그라운드에서 다시 컴파일된 프로그램, 메인 스레드가 프레임 사이에 ID 와 교체한다
+		std::atomic<unsigned int> pendingID;
+
+		// 전처리 후 디스크 캐시를 먼저 확인하고, 없으면 컴파일해서 캐시에 저장한다. 파일을 읽지 못하면 0
+		unsigned int build();
+		static bool checkCompileErrors(unsigned int shader, std::string type);
+		static unsigned int compileProgram(const std::string &vertexCode, const std::string &fragmentCode, bool retrievable);
 
 	public:
 		unsigned int ID;
 
-		Shader(const char *vertexPath, const char *fragmentPath);
+		Shader(const char *vertexPath, const char *fragmentPath, const std::vector<std::string> &defines = std::vector<std::string>(), ShaderCache *cache = NULL);
 		
+		const std::string &getVertexPath() const;
+		const std::string &getFragmentPath() const;
+		const std::vector<std::string> &getSourceFiles() const;
+		// 셰이더 파일을 다시 읽어서 새 프로그램을 만든다 (디스크 캐시도 함께 갱신). 성공하면 pendingID 에 저장하고, 실패하면 기존 프로그램을 그대로 둔다
+		// 현재 스레드에 (메인 컨텍스트와 공유된) GL 컨텍스트가 있어야 한다
+		bool rebuild();
+		// 다시 컴파일된 프로그램이 있으면 ID 와 교체하고 이전 프로그램을 삭제한다. 프레임 사이에 메인 스레드에서 호출
+		// 새 프로그램은 uniform 값이 초기화되어 있으므로, true 를 반환하면 호출한 쪽에서 uniform 을 다시 설정해야 한다
+		bool applyPendingReload();
+		// 프로그램과, 아직 교체하지 않은 다시 컴파일된 프로그램을 삭제한다. 감시 스레드를 멈춘 뒤 GL 컨텍스트가 있는 스레드에서 호출
+		void clear();
 		void use();
+		// 셰이더의 uniform block 을 binding 번호에 연결한다, 블록이 없으면(사용하지 않아 제거된 경우 포함) false
+		bool bindUniformBlock(const std::string &name, unsigned int binding) const;
 		void setBool(const std::string &name, bool value) const;
 		void setInt(const std::string &name, int value) const;
 		void setFloat(const std::string &name, float value) const;
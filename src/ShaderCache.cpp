@@ -0,0 +1,136 @@
+#include "ShaderCache.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+	const uint32_t CACHE_MAGIC = 0x42505347; // "GSPB"
+	const uint32_t CACHE_VERSION = 1;
+
+	struct CacheHeader
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint32_t format;
+		uint32_t length;
+	};
+
+	// FNV-1a 64비트 해시
+	uint64_t fnv1a(const std::string &data, uint64_t hash = 0xcbf29ce484222325ULL)
+	{
+		for (unsigned char c : data)
+		{
+			hash ^= c;
+			hash *= 0x100000001b3ULL;
+		}
+		return (hash);
+	}
+}
+
+ShaderCache::ShaderCache(const std::string &directory) : directory(directory), supported(false)
+{
+	// 프로그램 바이너리는 GL 4.1 코어 기능이고, 3.3 컨텍스트에서는 ARB_get_program_binary 확장으로 사용할 수 있다
+	GLint formats = 0;
+	if (GLAD_GL_VERSION_4_1 || GLAD_GL_ARB_get_program_binary)
+	{
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+	}
+	supported = formats > 0;
+	if (supported)
+	{
+		const char *renderer = (const char *)glGetString(GL_RENDERER);
+		const char *version = (const char *)glGetString(GL_VERSION);
+		driver = std::string(renderer ? renderer : "") + "|" + (version ? version : "");
+		std::error_code error;
+		std::filesystem::create_directories(directory, error);
+	}
+}
+
+bool ShaderCache::isSupported() const
+{
+	return (supported);
+}
+
+uint64_t ShaderCache::hashSources(const std::string &vertexCode, const std::string &fragmentCode) const
+{
+	uint64_t hash = fnv1a(driver);
+	hash = fnv1a(vertexCode, hash);
+	// 두 소스의 경계를 구분해서 "ab"+"c" 와 "a"+"bc" 가 같은 해시가 되지 않게 한다
+	hash = fnv1a(std::string(1, '\0'), hash);
+	return (fnv1a(fragmentCode, hash));
+}
+
+std::string ShaderCache::pathFor(uint64_t hash) const
+{
+	char name[32];
+	std::snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)hash);
+	return (directory + name);
+}
+
+unsigned int ShaderCache::load(uint64_t hash) const
+{
+	if (!supported)
+	{
+		return (0);
+	}
+	std::ifstream file(pathFor(hash), std::ios::binary);
+	CacheHeader header;
+	if (!file || !file.read((char *)&header, sizeof(header)) || header.magic != CACHE_MAGIC || header.version != CACHE_VERSION)
+	{
+		return (0);
+	}
+	std::vector<char> binary(header.length);
+	if (!file.read(binary.data(), binary.size()))
+	{
+		return (0);
+	}
+
+	unsigned int program = glCreateProgram();
+	glProgramBinary(program, (GLenum)header.format, binary.data(), (GLsizei)binary.size());
+	int success;
+	glGetProgramiv(program, GL_LINK_STATUS, &success);
+	if (!success)
+	{
+		// 드라이버 업데이트 등으로 바이너리가 거부되면 소스에서 다시 컴파일하도록 0 을 반환
+		glDeleteProgram(program);
+		return (0);
+	}
+	return (program);
+}
+
+void ShaderCache::store(uint64_t hash, unsigned int program) const
+{
+	if (!supported)
+	{
+		return;
+	}
+	GLint length = 0;
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0)
+	{
+		return;
+	}
+	std::vector<char> binary(length);
+	GLenum format;
+	glGetProgramBinary(program, length, &length, &format, binary.data());
+
+	// 다른 스레드(셰이더 감시 스레드)나 다른 프로세스가 반쯤 쓰인 파일을 읽지 않도록 임시 파일에 쓴 뒤 이름을 바꾼다
+	std::string path = pathFor(hash);
+	std::string temporary = path + ".tmp";
+	{
+		std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+		CacheHeader header = {CACHE_MAGIC, CACHE_VERSION, format, (uint32_t)length};
+		file.write((const char *)&header, sizeof(header));
+		file.write(binary.data(), length);
+		if (!file)
+		{
+			return;
+		}
+	}
+	std::error_code error;
+	std::filesystem::rename(temporary, path, error);
+}
@@ -0,0 +1,32 @@
+#ifndef SHADER_CACHE_H
+#define SHADER_CACHE_H
+
+#include <glad/glad.h>
+
+#include <cstdint>
+#include <string>
+
+// 링크된 프로그램 바이너리(glGetProgramBinary)를 디스크에 저장해서 다음 실행부터 컴파일을 건너뛴다
+// 키는 전처리가 끝난 셰이더 소스와 드라이버(GL_RENDERER, GL_VERSION) 의 해시이므로, 소스나 드라이버가 바뀌면 자동으로 무효화된다
+// load/store 는 파일 단위로만 동작하므로 셰이더 감시 스레드에서도 호출할 수 있다
+class ShaderCache
+{
+	private:
+		std::string directory;
+		std::string driver;
+		bool supported;
+
+		std::string pathFor(uint64_t hash) const;
+
+	public:
+		// GL 컨텍스트가 있는 스레드에서 생성해야 한다 (드라이버 정보 조회)
+		ShaderCache(const std::string &directory = "./shader_cache/");
+
+		bool isSupported() const;
+		uint64_t hashSources(const std::string &vertexCode, const std::string &fragmentCode) const;
+		// 캐시에 있으면 링크까지 끝난 프로그램을, 없거나 드라이버가 거부하면 0 을 반환
+		unsigned int load(uint64_t hash) const;
+		void store(uint64_t hash, unsigned int program) const;
+};
+
+#endif
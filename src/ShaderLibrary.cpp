@@ -0,0 +1,38 @@
+#include "ShaderLibrary.h"
+
+ShaderLibrary::ShaderLibrary(ShaderWatcher *watcher, const std::string &cacheDirectory) : cache(cacheDirectory), watcher(watcher)
+{
+}
+
+Shader &ShaderLibrary::get(const std::string &vertexPath, const std::string &fragmentPath, const std::vector<std::string> &defines)
+{
+	std::string key = vertexPath + "|" + fragmentPath + "|" + ShaderPreprocessor::permutationKey(defines);
+	auto found = permutations.find(key);
+	if (found != permutations.end())
+	{
+		return (*found->second);
+	}
+
+	std::unique_ptr<Shader> shader(new Shader(vertexPath.c_str(), fragmentPath.c_str(), defines, &cache));
+	Shader &result = *shader;
+	permutations.emplace(key, std::move(shader));
+	if (watcher != NULL)
+	{
+		watcher->watch(result);
+	}
+	return (result);
+}
+
+void ShaderLibrary::clear()
+{
+	for (auto &permutation : permutations)
+	{
+		permutation.second->clear();
+	}
+	permutations.clear();
+}
+
+size_t ShaderLibrary::size() const
+{
+	return (permutations.size());
+}
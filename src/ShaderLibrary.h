@@ -0,0 +1,33 @@
+#ifndef SHADER_LIBRARY_H
+#define SHADER_LIBRARY_H
+
+#include "Shader.h"
+#include "ShaderCache.h"
+#include "ShaderWatcher.h"
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 셰이더 permutation(같은 소스 + 서로 다른 #define 조합) 을 처음 요청될 때 컴파일하고 메모리에 보관한다
+// 머티리얼이 실제로 사용하는 조합만 컴파일되므로 셰이더 라이브러리가 커져도 시작 시간과 프로그램 수가 늘지 않는다
+// 컴파일된 프로그램은 ShaderCache 로 디스크에도 저장되어 다음 실행부터는 바이너리를 바로 불러온다
+class ShaderLibrary
+{
+	private:
+		ShaderCache cache;
+		ShaderWatcher *watcher;
+		std::unordered_map<std::string, std::unique_ptr<Shader>> permutations;
+
+	public:
+		// GL 컨텍스트가 있는 메인 스레드에서 생성, watcher 를 주면 새로 만든 permutation 을 핫 리로드 대상으로 등록한다
+		ShaderLibrary(ShaderWatcher *watcher = NULL, const std::string &cacheDirectory = "./shader_cache/");
+
+		Shader &get(const std::string &vertexPath, const std::string &fragmentPath, const std::vector<std::string> &defines = std::vector<std::string>());
+		// 모든 permutation 의 프로그램(교체를 기다리는 프로그램 포함) 을 삭제한다. glfwTerminate 전에, 감시 스레드를 멈춘 뒤 호출
+		void clear();
+		size_t size() const;
+};
+
+#endif
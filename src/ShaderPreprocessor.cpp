@@ -0,0 +1,172 @@
+#include "ShaderPreprocessor.h"
+#include "EmbeddedResources.h"
+
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+
+namespace
+{
+	// 순환 include 를 막기 위한 최대 깊이
+	const int MAX_INCLUDE_DEPTH = 32;
+
+	std::string trimLeft(const std::string &line)
+	{
+		size_t start = line.find_first_not_of(" \t");
+		return (start == std::string::npos ? std::string() : line.substr(start));
+	}
+
+	bool startsWithDirective(const std::string &line, const char *directive)
+	{
+		std::string trimmed = trimLeft(line);
+		if (trimmed.empty() || trimmed[0] != '#')
+		{
+			return (false);
+		}
+		return (trimLeft(trimmed.substr(1)).compare(0, std::char_traits<char>::length(directive), directive) == 0);
+	}
+
+	bool parseIncludeName(const std::string &line, std::string &name)
+	{
+		size_t open = line.find_first_of("\"<");
+		if (open == std::string::npos)
+		{
+			return (false);
+		}
+		size_t close = line.find_first_of("\">", open + 1);
+		if (close == std::string::npos)
+		{
+			return (false);
+		}
+		name = line.substr(open + 1, close - open - 1);
+		return (!name.empty());
+	}
+}
+
+bool ShaderPreprocessor::expand(const std::string &path, int depth, std::set<std::string> &included, std::vector<std::string> &files, std::string &out)
+{
+	if (depth > MAX_INCLUDE_DEPTH)
+	{
+		std::cout << "ERROR::SHADER::INCLUDE_DEPTH_EXCEEDED: " << path << std::endl;
+		return (false);
+	}
+	// 실행 파일에 포함된 셰이더를 먼저 사용하고, 디스크 오버라이드가 설정되어 있으면 디스크에서 읽는다
+	std::string source;
+	if (!readResource(path, source))
+	{
+		std::cout << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ: " << path << std::endl;
+		return (false);
+	}
+	std::istringstream file(source);
+	included.insert(path);
+	int sourceIndex = (int)files.size();
+	// 감시 대상이 되는 실제 디스크 경로를 기록한다
+	files.push_back(resolveResourcePath(path));
+	// 포함되는 파일에는 #version 이 없으므로 시작 부분에 바로 #line 을 넣어도 된다
+	if (depth > 0)
+	{
+		out += "#line 1 " + std::to_string(sourceIndex) + "\n";
+	}
+
+	std::string line;
+	int lineNumber = 0;
+	while (std::getline(file, line))
+	{
+		++lineNumber;
+		if (startsWithDirective(line, "include"))
+		{
+			std::string name;
+			if (!parseIncludeName(line, name))
+			{
+				std::cout << "ERROR::SHADER::INVALID_INCLUDE: " << path << "(" << lineNumber << ")" << std::endl;
+				return (false);
+			}
+			std::string includePath = SHADER_INCLUDE_DIR + name;
+			if (included.count(includePath) == 0)
+			{
+				if (!expand(includePath, depth + 1, included, files, out))
+				{
+					return (false);
+				}
+			}
+			// 포함한 파일이 끝나면 원래 파일의 다음 줄 번호로 되돌린다
+			out += "#line " + std::to_string(lineNumber + 1) + " " + std::to_string(sourceIndex) + "\n";
+			continue;
+		}
+		if (startsWithDirective(line, "pragma once"))
+		{
+			out += "\n";
+			continue;
+		}
+		out += line;
+		out += "\n";
+	}
+	return (true);
+}
+
+bool ShaderPreprocessor::process(const std::string &path, const std::vector<std::string> &defines, std::string &out, std::vector<std::string> &files)
+{
+	std::set<std::string> included;
+	std::string body;
+	files.clear();
+	if (!expand(path, 0, included, files, body))
+	{
+		return (false);
+	}
+
+	std::string defineBlock;
+	for (const std::string &define : defines)
+	{
+		size_t equals = define.find('=');
+		if (equals == std::string::npos)
+		{
+			defineBlock += "#define " + define + "\n";
+		}
+		else
+		{
+			defineBlock += "#define " + define.substr(0, equals) + " " + define.substr(equals + 1) + "\n";
+		}
+	}
+
+	// #version 은 반드시 첫 번째 지시문이어야 하므로 그 바로 다음 줄에 정의를 넣는다
+	size_t version = std::string::npos;
+	size_t lineStart = 0;
+	int versionLine = 0;
+	for (int lineNumber = 1; lineStart < body.size(); ++lineNumber)
+	{
+		size_t lineEnd = body.find('\n', lineStart);
+		if (startsWithDirective(body.substr(lineStart, lineEnd - lineStart), "version"))
+		{
+			version = lineEnd;
+			versionLine = lineNumber;
+			break;
+		}
+		if (lineEnd == std::string::npos)
+		{
+			break;
+		}
+		lineStart = lineEnd + 1;
+	}
+	if (version == std::string::npos)
+	{
+		out = defineBlock + "#line 1 0\n" + body;
+	}
+	else
+	{
+		defineBlock += "#line " + std::to_string(versionLine + 1) + " 0\n";
+		out = body.substr(0, version + 1) + defineBlock + body.substr(version + 1);
+	}
+	return (true);
+}
+
+std::string ShaderPreprocessor::permutationKey(std::vector<std::string> defines)
+{
+	std::sort(defines.begin(), defines.end());
+	std::string key;
+	for (const std::string &define : defines)
+	{
+		key += define;
+		key += ";";
+	}
+	return (key);
+}
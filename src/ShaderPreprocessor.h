@@ -0,0 +1,27 @@
+#ifndef SHADER_PREPROCESSOR_H
+#define SHADER_PREPROCESSOR_H
+
+#include <set>
+#include <string>
+#include <vector>
+
+// #include 가 참조하는 파일을 찾는 기본 디렉터리
+const char *const SHADER_INCLUDE_DIR = "./shader/";
+
+// GLSL 소스를 glShaderSource 에 넘기기 전에 전처리한다
+// - #include "file" 를 SHADER_INCLUDE_DIR 기준으로 찾아 펼친다 (같은 파일은 한 번만 포함, #pragma once 와 같은 동작)
+// - #version 바로 다음 줄에 defines 를 #define 으로 삽입한다 ("NAME" 또는 "NAME=VALUE")
+// - 각 파일의 시작과 끝에 #line 을 넣어서 컴파일 에러의 줄 번호가 원래 파일 기준이 되게 한다 (source string 번호 = files 의 인덱스)
+class ShaderPreprocessor
+{
+	private:
+		static bool expand(const std::string &path, int depth, std::set<std::string> &included, std::vector<std::string> &files, std::string &out);
+
+	public:
+		// files 에는 처리 중에 읽은 모든 파일의 디스크 경로가 들어간다 (핫 리로드에서 감시할 파일 목록)
+		static bool process(const std::string &path, const std::vector<std::string> &defines, std::string &out, std::vector<std::string> &files);
+		// 정의 목록을 정렬해서 하나의 문자열로 만든다, 순서가 달라도 같은 permutation 은 같은 키가 된다
+		static std::string permutationKey(std::vector<std::string> defines);
+};
+
+#endif
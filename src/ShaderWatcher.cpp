@@ -0,0 +1,255 @@
+#include "ShaderWatcher.h"
+
+#include <chrono>
+#include <iostream>
+
+#ifdef __linux__
+	#include <poll.h>
+	#include <sys/inotify.h>
+	#include <unistd.h>
+#endif
+
+namespace
+{
+	// 에디터는 파일 하나를 저장할 때도 여러 번 쓰기/이름 변경을 하므로, 이벤트가 잠잠해질 때까지 조금 기다렸다가 컴파일한다
+	const std::chrono::milliseconds SETTLE_DELAY(50);
+	const int POLL_INTERVAL_MS = 200;
+
+	std::string directoryOf(const std::string &path)
+	{
+		size_t slash = path.find_last_of("/\\");
+		return (slash == std::string::npos ? std::string(".") : path.substr(0, slash));
+	}
+
+	std::string fileNameOf(const std::string &path)
+	{
+		size_t slash = path.find_last_of("/\\");
+		return (slash == std::string::npos ? path : path.substr(slash + 1));
+	}
+}
+
+ShaderWatcher::ShaderWatcher(GLFWwindow *sharedContext) : shadersChanged(false), compileContext(NULL), running(false)
+{
+#ifdef __linux__
+	notifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+	// 창 힌트는 이전에 설정한 값(OpenGL 버전, 프로파일)이 그대로 유지되므로 보이지 않게만 바꿔서 만든다
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+	compileContext = glfwCreateWindow(1, 1, "shader compile context", NULL, sharedContext);
+	glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+	if (compileContext == NULL)
+	{
+		std::cout << "ShaderWatcher: failed to create shared context, hot reload disabled" << std::endl;
+	}
+#ifdef __linux__
+	if (notifyFd < 0)
+	{
+		std::cout << "ShaderWatcher: inotify_init1 failed, hot reload disabled" << std::endl;
+	}
+#endif
+}
+
+ShaderWatcher::~ShaderWatcher()
+{
+	stop();
+}
+
+void ShaderWatcher::watch(Shader &shader)
+{
+	std::lock_guard<std::mutex> lock(watchesMutex);
+	shaders.push_back(&shader);
+	shadersChanged = true;
+}
+
+void ShaderWatcher::start()
+{
+	if (compileContext == NULL || running)
+	{
+		return;
+	}
+#ifdef __linux__
+	if (notifyFd < 0)
+	{
+		return;
+	}
+#endif
+	running = true;
+	thread = std::thread(&ShaderWatcher::run, this);
+}
+
+void ShaderWatcher::stop()
+{
+	running = false;
+	if (thread.joinable())
+	{
+		thread.join();
+	}
+	if (compileContext != NULL)
+	{
+		glfwDestroyWindow(compileContext);
+		compileContext = NULL;
+	}
+#ifdef __linux__
+	// watch 는 fd 를 닫을 때 함께 제거된다
+	if (notifyFd >= 0)
+	{
+		close(notifyFd);
+		notifyFd = -1;
+		directoryWatches.clear();
+	}
+#endif
+}
+
+void ShaderWatcher::run()
+{
+	glfwMakeContextCurrent(compileContext);
+	while (running)
+	{
+		// 감시할 파일 목록은 매번 새로 만든다, 다시 컴파일하면서 #include 구성이 바뀌었을 수 있기 때문이다
+		// getSourceFiles 는 이 스레드의 rebuild 에서만 바뀌므로 잠금 없이 읽어도 된다
+		std::vector<Watch> watches;
+		{
+			std::lock_guard<std::mutex> lock(watchesMutex);
+			shadersChanged = false;
+			for (Shader *shader : shaders)
+			{
+				watches.push_back({shader, shader->getSourceFiles()});
+			}
+		}
+		std::vector<bool> changed = waitForChanges(watches);
+		rebuildChanged(watches, changed);
+	}
+	glfwMakeContextCurrent(NULL);
+}
+
+void ShaderWatcher::rebuildChanged(const std::vector<Watch> &watches, const std::vector<bool> &changed)
+{
+	for (size_t i = 0; i < watches.size(); ++i)
+	{
+		if (!changed[i])
+		{
+			continue;
+		}
+		std::cout << "Reloading shader: " << watches[i].shader->getVertexPath() << ", " << watches[i].shader->getFragmentPath() << std::endl;
+		if (!watches[i].shader->rebuild())
+		{
+			std::cout << "Shader reload failed, keeping the previous program" << std::endl;
+		}
+	}
+}
+
+#ifdef __linux__
+std::vector<bool> ShaderWatcher::waitForChanges(const std::vector<Watch> &watches)
+{
+	std::vector<bool> changed(watches.size(), false);
+
+	// 파일이 아니라 디렉터리를 감시한다, 에디터가 임시 파일에 쓰고 이름을 바꿔 저장하면 파일 감시는 끊어지기 때문이다
+	// fd 와 이미 추가한 watch 는 유지되므로, 새로 #include 된 파일의 디렉터리만 추가된다
+	for (const Watch &watch : watches)
+	{
+		for (const std::string &file : watch.files)
+		{
+			std::string directory = directoryOf(file);
+			if (directoryWatches.count(directory) != 0)
+			{
+				continue;
+			}
+			int wd = inotify_add_watch(notifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+			if (wd >= 0)
+			{
+				directoryWatches[directory] = wd;
+			}
+		}
+	}
+
+	bool any = false;
+	alignas(struct inotify_event) char buffer[4096];
+	while (running && (any || !shadersChanged))
+	{
+		struct pollfd pfd = {notifyFd, POLLIN, 0};
+		// 변경이 감지된 뒤에는 짧게 기다려서 연속된 이벤트를 한 번에 모은다
+		int timeout = any ? (int)SETTLE_DELAY.count() : POLL_INTERVAL_MS;
+		int ready = poll(&pfd, 1, timeout);
+		if (ready <= 0)
+		{
+			if (any)
+			{
+				break;
+			}
+			continue;
+		}
+		ssize_t length = read(notifyFd, buffer, sizeof(buffer));
+		for (ssize_t offset = 0; offset < length;)
+		{
+			const struct inotify_event *event = (const struct inotify_event *)(buffer + offset);
+			offset += sizeof(struct inotify_event) + event->len;
+			if (event->len == 0)
+			{
+				continue;
+			}
+			for (size_t i = 0; i < watches.size(); ++i)
+			{
+				for (const std::string &file : watches[i].files)
+				{
+					std::map<std::string, int>::const_iterator directory = directoryWatches.find(directoryOf(file));
+					if (directory != directoryWatches.end() && directory->second == event->wd && fileNameOf(file) == event->name)
+					{
+						changed[i] = true;
+						any = true;
+					}
+				}
+			}
+		}
+	}
+	return (changed);
+}
+#else
+std::vector<bool> ShaderWatcher::waitForChanges(const std::vector<Watch> &watches)
+{
+	std::vector<bool> changed(watches.size(), false);
+
+	// inotify 가 없는 플랫폼에서는 수정 시간을 주기적으로 비교한다
+	// 기준 시간은 호출 사이에도 유지하므로, 다시 컴파일하는 동안 저장된 파일도 다음 비교에서 바뀐 것으로 본다
+	// 처음 보는 파일은 현재 시간을 기준으로 기록만 한다
+	for (const Watch &watch : watches)
+	{
+		for (const std::string &file : watch.files)
+		{
+			if (modifiedTimes.count(file) == 0)
+			{
+				std::error_code error;
+				modifiedTimes[file] = std::filesystem::last_write_time(file, error);
+			}
+		}
+	}
+
+	bool any = false;
+	while (running && (any || !shadersChanged))
+	{
+		if (!any)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(POLL_INTERVAL_MS));
+		}
+		for (size_t i = 0; i < watches.size(); ++i)
+		{
+			for (const std::string &file : watches[i].files)
+			{
+				std::error_code error;
+				std::filesystem::file_time_type time = std::filesystem::last_write_time(file, error);
+				if (time != modifiedTimes[file])
+				{
+					modifiedTimes[file] = time;
+					changed[i] = true;
+					any = true;
+				}
+			}
+		}
+		if (any)
+		{
+			std::this_thread::sleep_for(SETTLE_DELAY);
+			break;
+		}
+	}
+	return (changed);
+}
+#endif
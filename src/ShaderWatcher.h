@@ -0,0 +1,64 @@
+#ifndef SHADER_WATCHER_H
+#define SHADER_WATCHER_H
+
+#include "Shader.h"
+
+#include <GLFW/glfw3.h>
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef __linux__
+	#include <filesystem>
+#endif
+
+// 셰이더 파일의 변경을 감시하고, 바뀌면 백그라운드 스레드에서 다시 컴파일한다
+// Linux 에서는 inotify 를 사용하고, 그 외의 플랫폼에서는 파일 수정 시간을 주기적으로 확인한다
+// 다시 컴파일된 프로그램은 Shader::applyPendingReload 로 메인 스레드에서 프레임 사이에 교체된다
+class ShaderWatcher
+{
+	private:
+		struct Watch
+		{
+			Shader *shader;
+			std::vector<std::string> files;
+		};
+
+		// watch() 는 감시 스레드가 실행 중일 때도 (ShaderLibrary 가 permutation 을 처음 만들 때) 호출될 수 있다
+		std::mutex watchesMutex;
+		std::vector<Shader *> shaders;
+		std::atomic<bool> shadersChanged;
+		// 메인 컨텍스트와 객체를 공유하는 보이지 않는 창, 감시 스레드에서 셰이더 컴파일에 사용한다
+		GLFWwindow *compileContext;
+		std::thread thread;
+		std::atomic<bool> running;
+		// 감시 상태는 waitForChanges 호출 사이에도 유지해서, 다시 컴파일하는 동안 저장된 변경도 다음 호출에서 감지한다
+#ifdef __linux__
+		int notifyFd;
+		// 디렉터리 경로와 inotify watch descriptor
+		std::map<std::string, int> directoryWatches;
+#else
+		// 마지막으로 확인한 파일별 수정 시간
+		std::map<std::string, std::filesystem::file_time_type> modifiedTimes;
+#endif
+
+		void run();
+		void rebuildChanged(const std::vector<Watch> &watches, const std::vector<bool> &changed);
+		std::vector<bool> waitForChanges(const std::vector<Watch> &watches);
+
+	public:
+		// 메인 스레드에서 생성해야 한다 (GLFW 창 생성은 메인 스레드에서만 가능)
+		ShaderWatcher(GLFWwindow *sharedContext);
+		~ShaderWatcher();
+
+		void watch(Shader &shader);
+		void start();
+		// 감시 스레드를 멈추고 공유 컨텍스트를 파괴한다. glfwTerminate 전에 메인 스레드에서 호출
+		void stop();
+};
+
+#endif
@@ -0,0 +1,52 @@
+#include "SourceStamp.h"
+#include "MappedFile.h"
+
+#include <cstring>
+#include <filesystem>
+
+bool getSourceStamp(const std::string &path, SourceStamp &stamp)
+{
+	std::error_code error;
+	uintmax_t size = std::filesystem::file_size(path, error);
+	if (error)
+	{
+		return (false);
+	}
+	std::filesystem::file_time_type modified = std::filesystem::last_write_time(path, error);
+	if (error)
+	{
+		return (false);
+	}
+	stamp.size = (uint64_t)size;
+	stamp.modified = (int64_t)modified.time_since_epoch().count();
+	return (true);
+}
+
+uint64_t hashFileContents(const std::string &path)
+{
+	MappedFile file;
+	if (!file.open(path))
+	{
+		return (0);
+	}
+	// FNV-1a 를 바이트 대신 8바이트 단위로 돌린다, 큰 파일도 디스크에서 읽는 속도에 가깝게 해시할 수 있다
+	const unsigned char *data = file.getData();
+	size_t size = file.getSize();
+	uint64_t hash = 0xcbf29ce484222325ULL ^ size;
+	size_t i = 0;
+	for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+	{
+		uint64_t word;
+		std::memcpy(&word, data + i, sizeof(word));
+		hash ^= word;
+		hash *= 0x100000001b3ULL;
+		hash ^= hash >> 32;
+	}
+	for (; i < size; i++)
+	{
+		hash ^= data[i];
+		hash *= 0x100000001b3ULL;
+	}
+	// 0 은 실패를 뜻하므로 피한다
+	return (hash != 0 ? hash : 1);
+}
@@ -0,0 +1,20 @@
+#ifndef SOURCE_STAMP_H
+#define SOURCE_STAMP_H
+
+#include <cstdint>
+#include <string>
+
+// 캐시를 만든 원본 파일의 크기와 수정 시간, 원본을 읽지 않고 캐시가 아직 유효한지 확인하는 데 쓴다
+// 둘 중 하나라도 다르면 hashFileContents 로 내용을 비교해서, 내용이 같은데 시간만 바뀐 경우(체크아웃, 복사)는 캐시를 계속 쓴다
+struct SourceStamp
+{
+	uint64_t size;
+	int64_t modified;
+};
+
+// 파일이 없으면 false
+bool getSourceStamp(const std::string &path, SourceStamp &stamp);
+// 파일 내용의 64비트 해시, 읽을 수 없으면 0
+uint64_t hashFileContents(const std::string &path);
+
+#endif
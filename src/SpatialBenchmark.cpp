@@ -0,0 +1,369 @@
+#include "SpatialBenchmark.h"
+#include "Bvh.h"
+#include "SpatialGrid.h"
+#include "OcclusionCuller.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	const size_t OBJECT_COUNTS[] = {10000, 100000, 1000000};
+	// 물체 하나가 차지하는 평균 부피, 물체 수가 늘어나면 장면도 같은 밀도로 커진다
+	const double VOLUME_PER_OBJECT = 64.0;
+	const int RAY_COUNT = 1000;
+	const int REPEAT = 5;
+	const size_t MOVING_OBJECT_COUNT = 100000;
+	const int MOVING_FRAMES = 20;
+	const float MOVING_SPEED = 0.5f;
+	const int SPHERE_QUERY_COUNT = 1000;
+	// 도시처럼 격자로 늘어선 건물(가리개) 과 그 사이의 작은 물체
+	const int BUILDING_ROWS = 20;
+	const float BUILDING_SPACING = 12.0f;
+	const size_t SMALL_OBJECT_COUNT = 100000;
+
+	double elapsedMilliseconds(std::chrono::steady_clock::time_point start)
+	{
+		return (std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+	}
+
+	// 반지름 0.5 ~ 1.5 의 구를 감싸는 박스를 정육면체 영역 안에 무작위로 흩뿌린다
+	std::vector<Aabb> randomScene(size_t count, float halfSize, std::mt19937 &random)
+	{
+		std::uniform_real_distribution<float> position(-halfSize, halfSize);
+		std::uniform_real_distribution<float> radius(0.5f, 1.5f);
+		std::vector<Aabb> bounds(count);
+		for (Aabb &box : bounds)
+		{
+			box = sphereBounds(glm::vec3(position(random), position(random), position(random)), radius(random));
+		}
+		return (bounds);
+	}
+
+	Frustum benchmarkFrustum(float halfSize)
+	{
+		// 장면 가장자리에서 중심을 바라보는 카메라, 앱과 같은 시야각 45도
+		glm::mat4 projection = glm::perspective(glm::radians(45.0f), 800.0f / 600.0f, 0.1f, halfSize * 2.0f);
+		glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 0.0f, halfSize), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+		return (Frustum::fromMatrix(projection * view));
+	}
+
+	// 한 변이 1 이고 원점이 중심인 큐브의 삼각형 목록
+	std::vector<glm::vec3> unitCubeTriangles()
+	{
+		const int faces[6][4] = {{0, 1, 3, 2}, {4, 6, 7, 5}, {0, 4, 5, 1}, {2, 3, 7, 6}, {0, 2, 6, 4}, {1, 5, 7, 3}};
+		std::vector<glm::vec3> triangles;
+		for (const int *face : faces)
+		{
+			const int order[6] = {0, 1, 2, 2, 3, 0};
+			for (int i : order)
+			{
+				int corner = face[i];
+				triangles.push_back(glm::vec3((corner & 1) ? 0.5f : -0.5f, (corner & 2) ? 0.5f : -0.5f, (corner & 4) ? 0.5f : -0.5f));
+			}
+		}
+		return (triangles);
+	}
+
+	void printRow(const char *label, double milliseconds)
+	{
+		std::cout << "  " << std::left << std::setw(24) << label << std::right << std::fixed << std::setprecision(3) << std::setw(10) << milliseconds << " ms" << std::endl;
+	}
+}
+
+void runBvhBenchmark()
+{
+	std::mt19937 random(1234);
+	for (size_t count : OBJECT_COUNTS)
+	{
+		float halfSize = (float)(std::cbrt(VOLUME_PER_OBJECT * count) * 0.5);
+		std::vector<Aabb> bounds = randomScene(count, halfSize, random);
+
+		Bvh bvh;
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		bvh.build(bounds);
+		double buildTime = elapsedMilliseconds(start);
+
+		// 모든 물체를 조금씩 움직인 뒤 refit
+		std::uniform_real_distribution<float> jitter(-0.25f, 0.25f);
+		std::vector<Aabb> moved = bounds;
+		for (Aabb &box : moved)
+		{
+			glm::vec3 offset(jitter(random), jitter(random), jitter(random));
+			box.min += offset;
+			box.max += offset;
+		}
+		start = std::chrono::steady_clock::now();
+		bvh.refit(moved);
+		double refitTime = elapsedMilliseconds(start);
+
+		Frustum frustum = benchmarkFrustum(halfSize);
+
+		std::vector<uint32_t> visible;
+		visible.reserve(count);
+		double cullTime = 0.0;
+		for (int i = 0; i < REPEAT; i++)
+		{
+			visible.clear();
+			start = std::chrono::steady_clock::now();
+			bvh.cullFrustum(frustum, visible);
+			cullTime += elapsedMilliseconds(start);
+		}
+		size_t visibleCount = visible.size();
+
+		// 비교 대상: 모든 물체를 하나씩 검사
+		double linearTime = 0.0;
+		for (int i = 0; i < REPEAT; i++)
+		{
+			visible.clear();
+			start = std::chrono::steady_clock::now();
+			for (uint32_t object = 0; object < (uint32_t)moved.size(); object++)
+			{
+				if (frustum.intersects(moved[object]))
+				{
+					visible.push_back(object);
+				}
+			}
+			linearTime += elapsedMilliseconds(start);
+		}
+
+		std::uniform_real_distribution<float> direction(-1.0f, 1.0f);
+		std::vector<Ray> rays;
+		rays.reserve(RAY_COUNT);
+		for (int i = 0; i < RAY_COUNT; i++)
+		{
+			rays.push_back(Ray(glm::vec3(0.0f), glm::normalize(glm::vec3(direction(random), direction(random), direction(random)))));
+		}
+		int hits = 0;
+		start = std::chrono::steady_clock::now();
+		for (const Ray &ray : rays)
+		{
+			uint32_t object;
+			float distance;
+			if (bvh.raycast(ray, halfSize * 2.0f, object, distance))
+			{
+				hits++;
+			}
+		}
+		double rayTime = elapsedMilliseconds(start);
+
+		std::cout << "BVH " << count << " objects, " << bvh.getNodeCount() << " nodes, " << visibleCount << " visible (linear " << visible.size() << "), " << hits << "/" << RAY_COUNT << " rays hit" << std::endl;
+		printRow("build", buildTime);
+		printRow("refit", refitTime);
+		printRow("cull frustum", cullTime / REPEAT);
+		printRow("cull linear", linearTime / REPEAT);
+		printRow("raycast x1000", rayTime);
+	}
+}
+
+void runGridBenchmark()
+{
+	std::mt19937 random(5678);
+	size_t count = MOVING_OBJECT_COUNT;
+	float halfSize = (float)(std::cbrt(VOLUME_PER_OBJECT * count) * 0.5);
+	std::uniform_real_distribution<float> position(-halfSize, halfSize);
+	std::uniform_real_distribution<float> radius(0.5f, 1.5f);
+	std::uniform_real_distribution<float> direction(-1.0f, 1.0f);
+	std::vector<glm::vec3> centers(count);
+	std::vector<float> radii(count);
+	std::vector<glm::vec3> velocities(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		centers[i] = glm::vec3(position(random), position(random), position(random));
+		radii[i] = radius(random);
+		velocities[i] = glm::normalize(glm::vec3(direction(random), direction(random), direction(random))) * MOVING_SPEED;
+	}
+	std::vector<glm::vec3> queryCenters(SPHERE_QUERY_COUNT);
+	for (glm::vec3 &center : queryCenters)
+	{
+		center = glm::vec3(position(random), position(random), position(random));
+	}
+	Frustum frustum = benchmarkFrustum(halfSize);
+
+	// 셀이 너무 작으면 셀 수와 셀 이동이 늘어나고, 너무 크면 구 질의가 검사하는 물체가 늘어난다
+	// 이 밀도에서는 가장 큰 물체 지름(3) 의 2~3배가 갱신과 질의 비용의 합이 가장 작았다
+	SpatialGrid grid(8.0f);
+	std::vector<SpatialGrid::Handle> handles(count);
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < count; i++)
+	{
+		handles[i] = grid.insert(centers[i], radii[i]);
+	}
+	double insertTime = elapsedMilliseconds(start);
+
+	std::vector<Aabb> bounds(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		bounds[i] = sphereBounds(centers[i], radii[i]);
+	}
+	Bvh refitted;
+	refitted.build(bounds);
+	Bvh rebuilt;
+
+	double gridUpdate = 0.0;
+	double gridQuery = 0.0;
+	double rebuildUpdate = 0.0;
+	double rebuildQuery = 0.0;
+	double refitUpdate = 0.0;
+	double refitQuery = 0.0;
+	size_t gridVisible = 0;
+	size_t rebuildVisible = 0;
+	size_t neighbours = 0;
+	std::vector<SpatialGrid::Handle> gridResult;
+	std::vector<uint32_t> bvhResult;
+	for (int frame = 0; frame < MOVING_FRAMES; frame++)
+	{
+		// 모든 물체가 한 프레임만큼 움직이고, 장면 밖으로 나가면 반대쪽 벽에서 튕긴다
+		for (size_t i = 0; i < count; i++)
+		{
+			centers[i] += velocities[i];
+			for (int a = 0; a < 3; a++)
+			{
+				if (std::abs(centers[i][a]) > halfSize)
+				{
+					velocities[i][a] = -velocities[i][a];
+				}
+			}
+			bounds[i] = sphereBounds(centers[i], radii[i]);
+		}
+
+		start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < count; i++)
+		{
+			grid.move(handles[i], centers[i], radii[i]);
+		}
+		gridUpdate += elapsedMilliseconds(start);
+		gridResult.clear();
+		start = std::chrono::steady_clock::now();
+		grid.queryFrustum(frustum, gridResult);
+		gridVisible = gridResult.size();
+		for (const glm::vec3 &center : queryCenters)
+		{
+			gridResult.clear();
+			grid.querySphere(center, 4.0f, gridResult);
+			neighbours += gridResult.size();
+		}
+		gridQuery += elapsedMilliseconds(start);
+
+		start = std::chrono::steady_clock::now();
+		rebuilt.build(bounds);
+		rebuildUpdate += elapsedMilliseconds(start);
+		bvhResult.clear();
+		start = std::chrono::steady_clock::now();
+		rebuilt.cullFrustum(frustum, bvhResult);
+		rebuildQuery += elapsedMilliseconds(start);
+		rebuildVisible = bvhResult.size();
+
+		// refit 은 싸지만 처음 빌드한 배치에서 멀어질수록 노드가 커져서 질의가 느려진다
+		start = std::chrono::steady_clock::now();
+		refitted.refit(bounds);
+		refitUpdate += elapsedMilliseconds(start);
+		bvhResult.clear();
+		start = std::chrono::steady_clock::now();
+		refitted.cullFrustum(frustum, bvhResult);
+		refitQuery += elapsedMilliseconds(start);
+	}
+
+	std::cout << "Moving " << count << " objects for " << MOVING_FRAMES << " frames, " << grid.getCellCount() << " cells, " << gridVisible << " visible (BVH " << rebuildVisible << "), " << neighbours / (MOVING_FRAMES * SPHERE_QUERY_COUNT) << " neighbours per sphere query" << std::endl;
+	printRow("grid insert (once)", insertTime);
+	printRow("grid move", gridUpdate / MOVING_FRAMES);
+	printRow("grid cull + spheres", gridQuery / MOVING_FRAMES);
+	printRow("bvh rebuild", rebuildUpdate / MOVING_FRAMES);
+	printRow("bvh rebuild cull", rebuildQuery / MOVING_FRAMES);
+	printRow("bvh refit", refitUpdate / MOVING_FRAMES);
+	printRow("bvh refit cull", refitQuery / MOVING_FRAMES);
+}
+
+void runOcclusionBenchmark()
+{
+	std::mt19937 random(9012);
+	float halfSize = BUILDING_ROWS * BUILDING_SPACING * 0.5f;
+	std::vector<Aabb> buildings;
+	std::vector<glm::mat4> buildingModels;
+	std::uniform_real_distribution<float> buildingHeight(10.0f, 40.0f);
+	for (int z = 0; z < BUILDING_ROWS; z++)
+	{
+		for (int x = 0; x < BUILDING_ROWS; x++)
+		{
+			glm::vec3 size(8.0f, buildingHeight(random), 8.0f);
+			glm::vec3 center(-halfSize + (x + 0.5f) * BUILDING_SPACING, size.y * 0.5f, -halfSize + (z + 0.5f) * BUILDING_SPACING);
+			Aabb box;
+			box.min = center - size * 0.5f;
+			box.max = center + size * 0.5f;
+			buildings.push_back(box);
+			buildingModels.push_back(glm::scale(glm::translate(glm::mat4(1.0f), center), size));
+		}
+	}
+	std::uniform_real_distribution<float> position(-halfSize, halfSize);
+	std::uniform_real_distribution<float> height(0.5f, 30.0f);
+	std::vector<Aabb> objects(SMALL_OBJECT_COUNT);
+	for (Aabb &box : objects)
+	{
+		box = sphereBounds(glm::vec3(position(random), height(random), position(random)), 0.87f);
+	}
+	Bvh bvh;
+	bvh.build(objects);
+	std::vector<glm::vec3> cube = unitCubeTriangles();
+
+	// 거리 높이에서 도시 중심을 바라보는 카메라
+	glm::vec3 eye(0.0f, 2.0f, halfSize);
+	glm::mat4 projection = glm::perspective(glm::radians(45.0f), 1600.0f / 900.0f, 0.1f, halfSize * 2.0f);
+	glm::mat4 viewProjection = projection * glm::lookAt(eye, glm::vec3(0.0f, 2.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	Frustum frustum = Frustum::fromMatrix(viewProjection);
+
+	OcclusionCuller occlusion(320, 180);
+	std::vector<uint32_t> visible;
+	std::vector<std::pair<float, uint32_t>> occluders;
+	double rasterTime = 0.0;
+	double testTime = 0.0;
+	size_t frustumCount = 0;
+	size_t keptCount = 0;
+	for (int i = 0; i < REPEAT; i++)
+	{
+		visible.clear();
+		bvh.cullFrustum(frustum, visible);
+		frustumCount = visible.size();
+
+		// 가까운 건물부터 가리개로 쓴다
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		occluders.clear();
+		for (uint32_t b = 0; b < (uint32_t)buildings.size(); b++)
+		{
+			if (frustum.intersects(buildings[b]))
+			{
+				occluders.push_back(std::make_pair(glm::length(buildings[b].center() - eye), b));
+			}
+		}
+		std::sort(occluders.begin(), occluders.end());
+		occlusion.clear();
+		for (size_t o = 0; o < std::min<size_t>(occluders.size(), 64); o++)
+		{
+			occlusion.addOccluder(viewProjection * buildingModels[occluders[o].second], cube.data(), cube.size());
+		}
+		rasterTime += elapsedMilliseconds(start);
+
+		start = std::chrono::steady_clock::now();
+		keptCount = 0;
+		for (uint32_t object : visible)
+		{
+			if (occlusion.isVisible(viewProjection, objects[object]))
+			{
+				keptCount++;
+			}
+		}
+		testTime += elapsedMilliseconds(start);
+	}
+
+	std::cout << "Occlusion " << objects.size() << " objects, " << buildings.size() << " buildings, " << occlusion.getOccluderTriangleCount() << " occluder triangles, "
+		<< frustumCount << " after frustum, " << keptCount << " after occlusion" << std::endl;
+	printRow("raster occluders", rasterTime / REPEAT);
+	printRow("test boxes", testTime / REPEAT);
+}
@@ -0,0 +1,14 @@
+#ifndef SPATIAL_BENCHMARK_H
+#define SPATIAL_BENCHMARK_H
+
+// 공간 분할 구조의 빌드 / 갱신 / 질의 시간을 측정해서 출력한다, GL 컨텍스트 없이 CPU 에서만 실행된다
+// 물체 수를 바꿔가며(1만, 10만, 100만) 밀도가 같은 무작위 장면에서 측정하므로 크기에 따른 증가를 비교할 수 있다
+
+// BVH 빌드, refit, 프러스텀 컬링(전체 선형 검사와 비교), 광선 picking
+void runBvhBenchmark();
+// 10만 개의 물체가 매 프레임 움직일 때, 격자 갱신 + 질의와 BVH 재빌드 / refit + 질의의 프레임당 비용
+void runGridBenchmark();
+// 건물처럼 큰 가리개 사이에 작은 물체가 빽빽한 장면에서, 프러스텀 컬링 뒤 CPU 오클루전 컬링이 걸러내는 물체 수와 비용
+void runOcclusionBenchmark();
+
+#endif
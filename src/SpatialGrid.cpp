@@ -0,0 +1,206 @@
+#include "SpatialGrid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+SpatialGrid::SpatialGrid(float cellSize) : cellSize(cellSize), inverseCellSize(1.0f / cellSize), maxRadius(0.0f), freeList(INVALID_HANDLE), objectCount(0)
+{
+}
+
+glm::ivec3 SpatialGrid::cellCoordinate(const glm::vec3 &position) const
+{
+	return (glm::ivec3((int)std::floor(position.x * inverseCellSize), (int)std::floor(position.y * inverseCellSize), (int)std::floor(position.z * inverseCellSize)));
+}
+
+uint64_t SpatialGrid::cellKey(const glm::ivec3 &coordinate)
+{
+	// 축마다 21비트씩 담는다, 셀 좌표가 +-100만을 넘지 않는 한 겹치지 않는다
+	const uint64_t mask = (1u << 21) - 1;
+	return (((uint64_t)coordinate.x & mask) | (((uint64_t)coordinate.y & mask) << 21) | (((uint64_t)coordinate.z & mask) << 42));
+}
+
+uint32_t SpatialGrid::findOrCreateCell(const glm::ivec3 &coordinate)
+{
+	std::pair<std::unordered_map<uint64_t, uint32_t>::iterator, bool> found = cellLookup.emplace(cellKey(coordinate), (uint32_t)cells.size());
+	if (found.second)
+	{
+		Cell cell;
+		cell.coordinate = coordinate;
+		cells.push_back(cell);
+	}
+	return (found.first->second);
+}
+
+void SpatialGrid::addToCell(Handle handle, uint32_t cell)
+{
+	Object &object = objects[handle];
+	object.cell = cell;
+	object.indexInCell = (uint32_t)cells[cell].objects.size();
+	cells[cell].objects.push_back(handle);
+}
+
+void SpatialGrid::removeFromCell(Handle handle)
+{
+	Object &object = objects[handle];
+	Cell &cell = cells[object.cell];
+	// 마지막 물체를 빈 자리로 옮긴다
+	Handle last = cell.objects.back();
+	cell.objects[object.indexInCell] = last;
+	objects[last].indexInCell = object.indexInCell;
+	cell.objects.pop_back();
+	if (!cell.objects.empty())
+	{
+		return;
+	}
+
+	// 빈 셀은 마지막 셀과 자리를 바꿔서 지우고, 옮겨진 셀에 들어 있는 물체의 셀 번호를 고친다
+	uint32_t removed = object.cell;
+	uint32_t moved = (uint32_t)cells.size() - 1;
+	cellLookup.erase(cellKey(cell.coordinate));
+	if (removed != moved)
+	{
+		cells[removed] = std::move(cells[moved]);
+		cellLookup[cellKey(cells[removed].coordinate)] = removed;
+		for (Handle other : cells[removed].objects)
+		{
+			objects[other].cell = removed;
+		}
+	}
+	cells.pop_back();
+}
+
+SpatialGrid::Handle SpatialGrid::insert(const glm::vec3 &center, float radius)
+{
+	Handle handle;
+	if (freeList != INVALID_HANDLE)
+	{
+		handle = freeList;
+		freeList = objects[handle].indexInCell;
+	}
+	else
+	{
+		handle = (Handle)objects.size();
+		objects.push_back(Object());
+	}
+	objects[handle].center = center;
+	objects[handle].radius = radius;
+	maxRadius = std::max(maxRadius, radius);
+	addToCell(handle, findOrCreateCell(cellCoordinate(center)));
+	objectCount++;
+	return (handle);
+}
+
+void SpatialGrid::move(Handle handle, const glm::vec3 &center, float radius)
+{
+	Object &object = objects[handle];
+	object.center = center;
+	object.radius = radius;
+	maxRadius = std::max(maxRadius, radius);
+	// 대부분의 이동은 같은 셀 안에서 끝나므로 해시 조회 없이 좌표만 비교한다
+	glm::ivec3 coordinate = cellCoordinate(center);
+	if (coordinate == cells[object.cell].coordinate)
+	{
+		return;
+	}
+	removeFromCell(handle);
+	addToCell(handle, findOrCreateCell(coordinate));
+}
+
+void SpatialGrid::remove(Handle handle)
+{
+	removeFromCell(handle);
+	objects[handle].cell = INVALID_HANDLE;
+	objects[handle].indexInCell = freeList;
+	freeList = handle;
+	objectCount--;
+}
+
+void SpatialGrid::clear()
+{
+	objects.clear();
+	cells.clear();
+	cellLookup.clear();
+	freeList = INVALID_HANDLE;
+	objectCount = 0;
+	maxRadius = 0.0f;
+}
+
+template <typename Visit>
+void SpatialGrid::forEachCell(const glm::ivec3 &lo, const glm::ivec3 &hi, Visit visit) const
+{
+	double rangeCount = (double)(hi.x - lo.x + 1) * (double)(hi.y - lo.y + 1) * (double)(hi.z - lo.z + 1);
+	if (rangeCount > (double)cells.size())
+	{
+		for (const Cell &cell : cells)
+		{
+			if (cell.coordinate.x >= lo.x && cell.coordinate.x <= hi.x && cell.coordinate.y >= lo.y && cell.coordinate.y <= hi.y && cell.coordinate.z >= lo.z && cell.coordinate.z <= hi.z)
+			{
+				visit(cell);
+			}
+		}
+		return;
+	}
+	for (int z = lo.z; z <= hi.z; z++)
+	{
+		for (int y = lo.y; y <= hi.y; y++)
+		{
+			for (int x = lo.x; x <= hi.x; x++)
+			{
+				std::unordered_map<uint64_t, uint32_t>::const_iterator found = cellLookup.find(cellKey(glm::ivec3(x, y, z)));
+				if (found != cellLookup.end())
+				{
+					visit(cells[found->second]);
+				}
+			}
+		}
+	}
+}
+
+void SpatialGrid::queryFrustum(const Frustum &frustum, std::vector<Handle> &visible) const
+{
+	for (const Cell &cell : cells)
+	{
+		// 셀 안의 물체는 중심이 셀 안에 있고 반지름이 maxRadius 이하이므로, 셀을 maxRadius 만큼 넓힌 박스에 모두 들어간다
+		Aabb looseBounds;
+		looseBounds.min = glm::vec3(cell.coordinate) * cellSize - glm::vec3(maxRadius);
+		looseBounds.max = looseBounds.min + glm::vec3(cellSize + 2.0f * maxRadius);
+		unsigned int planeMask = FRUSTUM_ALL_PLANES;
+		Containment containment = frustum.classify(looseBounds, planeMask);
+		if (containment == Containment::OUTSIDE)
+		{
+			continue;
+		}
+		if (containment == Containment::INSIDE)
+		{
+			visible.insert(visible.end(), cell.objects.begin(), cell.objects.end());
+			continue;
+		}
+		for (Handle handle : cell.objects)
+		{
+			const Object &object = objects[handle];
+			if (frustum.intersectsSphere(object.center, object.radius))
+			{
+				visible.push_back(handle);
+			}
+		}
+	}
+}
+
+void SpatialGrid::querySphere(const glm::vec3 &center, float radius, std::vector<Handle> &result) const
+{
+	glm::vec3 reach(radius + maxRadius);
+	forEachCell(cellCoordinate(center - reach), cellCoordinate(center + reach), [&](const Cell &cell)
+	{
+		for (Handle handle : cell.objects)
+		{
+			const Object &object = objects[handle];
+			glm::vec3 offset = object.center - center;
+			float distance = radius + object.radius;
+			if (glm::dot(offset, offset) <= distance * distance)
+			{
+				result.push_back(handle);
+			}
+		}
+	});
+}
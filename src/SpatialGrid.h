@@ -0,0 +1,80 @@
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+#include "Bounds.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// 해시로 찾는 균일 격자(hashed uniform grid), 매 프레임 많은 물체가 움직이는 장면용 공간 색인
+// 물체는 중심점이 들어 있는 셀 하나에만 들어가고(loose), 질의할 때 가장 큰 반지름만큼 범위를 넓혀서 셀 경계에 걸친 물체를 놓치지 않는다
+// 그래서 물체가 움직여도 셀이 바뀔 때만 목록 두 개를 고치면 되고, 삽입 / 이동 / 삭제가 모두 평균 O(1) 이다
+// 반지름이 셀 크기보다 훨씬 큰 물체가 섞여 있으면 모든 질의가 넓어지므로 cellSize 는 물체 지름의 몇 배 정도로 잡는다
+class SpatialGrid
+{
+	public:
+		typedef uint32_t Handle;
+		static const Handle INVALID_HANDLE = 0xffffffffu;
+
+	private:
+		struct Object
+		{
+			glm::vec3 center;
+			float radius;
+			// 들어 있는 셀 번호와 그 셀 목록 안의 위치, 삭제된 슬롯은 cell 이 INVALID_HANDLE 이고 indexInCell 이 다음 빈 슬롯
+			uint32_t cell;
+			uint32_t indexInCell;
+		};
+
+		struct Cell
+		{
+			glm::ivec3 coordinate;
+			std::vector<Handle> objects;
+		};
+
+		float cellSize;
+		float inverseCellSize;
+		// 지금까지 들어온 가장 큰 반지름, 줄어들지 않는다
+		float maxRadius;
+		std::vector<Object> objects;
+		Handle freeList;
+		size_t objectCount;
+		// 비어 있지 않은 셀만 빽빽하게 유지한다, 빈 셀은 마지막 셀과 자리를 바꿔서 지운다
+		std::vector<Cell> cells;
+		std::unordered_map<uint64_t, uint32_t> cellLookup;
+
+		glm::ivec3 cellCoordinate(const glm::vec3 &position) const;
+		static uint64_t cellKey(const glm::ivec3 &coordinate);
+		uint32_t findOrCreateCell(const glm::ivec3 &coordinate);
+		void addToCell(Handle handle, uint32_t cell);
+		void removeFromCell(Handle handle);
+		// 셀 좌표 범위 [lo, hi] 를 직접 순회하는 것과 비어 있지 않은 셀 전체를 보는 것 중 싼 쪽을 고른다
+		template <typename Visit>
+		void forEachCell(const glm::ivec3 &lo, const glm::ivec3 &hi, Visit visit) const;
+
+	public:
+		explicit SpatialGrid(float cellSize);
+
+		Handle insert(const glm::vec3 &center, float radius);
+		void move(Handle handle, const glm::vec3 &center, float radius);
+		void remove(Handle handle);
+		void clear();
+
+		// 프러스텀과 겹치는 물체를 visible 에 추가한다, 셀이 프러스텀 안에 완전히 들어가면 셀 안의 물체는 검사하지 않는다
+		void queryFrustum(const Frustum &frustum, std::vector<Handle> &visible) const;
+		// 구와 겹치는 물체를 result 에 추가한다
+		void querySphere(const glm::vec3 &center, float radius, std::vector<Handle> &result) const;
+
+		size_t getObjectCount() const
+		{
+			return (objectCount);
+		}
+
+		size_t getCellCount() const
+		{
+			return (cells.size());
+		}
+};
+
+#endif
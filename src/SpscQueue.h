@@ -0,0 +1,63 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+
+// 생산자 스레드 하나, 소비자 스레드 하나가 락 없이 사용하는 고정 크기 원형 큐
+// 생산자는 tail 만, 소비자는 head 만 쓰므로 두 인덱스를 다른 캐시 라인에 두어 false sharing 을 피한다
+template <typename T, size_t Capacity>
+class SpscQueue
+{
+	static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+	private:
+		alignas(64) std::atomic<size_t> head;
+		alignas(64) std::atomic<size_t> tail;
+		alignas(64) T items[Capacity];
+
+	public:
+		SpscQueue() : head(0), tail(0)
+		{
+		}
+
+		SpscQueue(const SpscQueue &) = delete;
+		SpscQueue &operator=(const SpscQueue &) = delete;
+
+		// 생산자 스레드에서만 호출, 큐가 가득 차면 false
+		bool push(const T &item)
+		{
+			size_t t = tail.load(std::memory_order_relaxed);
+			if (t - head.load(std::memory_order_acquire) == Capacity)
+			{
+				return (false);
+			}
+			items[t & (Capacity - 1)] = item;
+			tail.store(t + 1, std::memory_order_release);
+			return (true);
+		}
+
+		// 소비자 스레드에서만 호출, 비어 있으면 NULL. 반환된 원소는 pop 전까지 유효하다
+		const T *front() const
+		{
+			size_t h = head.load(std::memory_order_relaxed);
+			if (h == tail.load(std::memory_order_acquire))
+			{
+				return (NULL);
+			}
+			return (&items[h & (Capacity - 1)]);
+		}
+
+		// 소비자 스레드에서만 호출, front 가 NULL 이 아닐 때만 호출해야 한다
+		void pop()
+		{
+			head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+		}
+
+		bool empty() const
+		{
+			return (head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire));
+		}
+};
+
+#endif
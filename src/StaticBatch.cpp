@@ -0,0 +1,173 @@
+#include "StaticBatch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <tuple>
+
+StaticBatch::StaticBatch(size_t floatsPerVertex, float chunkSize) : floatsPerVertex(floatsPerVertex), chunkSize(chunkSize), unbatchedBytes(0), VAO(0), VBO(0), EBO(0)
+{
+}
+
+StaticBatch::~StaticBatch()
+{
+	clear();
+}
+
+void StaticBatch::clear()
+{
+	if (VAO != 0)
+	{
+		glDeleteVertexArrays(1, &VAO);
+		glDeleteBuffers(1, &VBO);
+		glDeleteBuffers(1, &EBO);
+		VAO = 0;
+		VBO = 0;
+		EBO = 0;
+	}
+}
+
+void StaticBatch::add(const StaticMesh &mesh, unsigned int material, const glm::dvec3 &position, const glm::quat &rotation)
+{
+	instances.push_back({mesh, material, position, rotation});
+}
+
+const StaticBatch::IndexedMesh &StaticBatch::indexMesh(const StaticMesh &mesh, std::map<const float *, IndexedMesh> &cache) const
+{
+	std::map<const float *, IndexedMesh>::iterator found = cache.find(mesh.vertices);
+	if (found != cache.end())
+	{
+		return (found->second);
+	}
+	IndexedMesh &indexed = cache[mesh.vertices];
+	// 삼각형 목록에서 완전히 같은 정점(위치와 모든 속성) 을 하나로 합친다
+	std::map<std::vector<float>, uint32_t> unique;
+	for (size_t v = 0; v < mesh.vertexCount; v++)
+	{
+		std::vector<float> vertex(mesh.vertices + v * floatsPerVertex, mesh.vertices + (v + 1) * floatsPerVertex);
+		std::pair<std::map<std::vector<float>, uint32_t>::iterator, bool> inserted = unique.emplace(vertex, (uint32_t)(indexed.vertices.size() / floatsPerVertex));
+		if (inserted.second)
+		{
+			indexed.vertices.insert(indexed.vertices.end(), vertex.begin(), vertex.end());
+		}
+		indexed.indices.push_back(inserted.first->second);
+	}
+	return (indexed);
+}
+
+void StaticBatch::build()
+{
+	chunks.clear();
+	vertices.clear();
+	indices.clear();
+	unbatchedBytes = 0;
+
+	// 머티리얼, 격자 칸 순서로 정렬해서 같은 덩어리의 물체가 연속되게 한다
+	typedef std::tuple<unsigned int, long long, long long, long long> ChunkKey;
+	std::vector<std::pair<ChunkKey, size_t>> order;
+	for (size_t i = 0; i < instances.size(); i++)
+	{
+		const glm::dvec3 &p = instances[i].position;
+		ChunkKey key(instances[i].material, (long long)std::floor(p.x / chunkSize), (long long)std::floor(p.y / chunkSize), (long long)std::floor(p.z / chunkSize));
+		order.push_back(std::make_pair(key, i));
+	}
+	std::sort(order.begin(), order.end());
+
+	std::map<const float *, IndexedMesh> meshes;
+	for (size_t i = 0; i < order.size(); i++)
+	{
+		const Instance &instance = instances[order[i].second];
+		if (i == 0 || order[i].first != order[i - 1].first)
+		{
+			Chunk chunk;
+			chunk.material = instance.material;
+			// 덩어리의 격자 칸 중심을 원점으로 삼는다
+			chunk.origin = glm::dvec3((double)std::get<1>(order[i].first) + 0.5, (double)std::get<2>(order[i].first) + 0.5, (double)std::get<3>(order[i].first) + 0.5) * (double)chunkSize;
+			chunk.firstIndex = (unsigned int)indices.size();
+			chunk.indexCount = 0;
+			chunk.instanceCount = 0;
+			chunks.push_back(chunk);
+		}
+		Chunk &chunk = chunks.back();
+		const IndexedMesh &mesh = indexMesh(instance.mesh, meshes);
+
+		uint32_t baseVertex = (uint32_t)(vertices.size() / floatsPerVertex);
+		glm::vec3 offset = glm::vec3(instance.position - chunk.origin);
+		glm::mat3 rotation = glm::mat3_cast(instance.rotation);
+		for (size_t v = 0; v < mesh.vertices.size(); v += floatsPerVertex)
+		{
+			glm::vec3 position = rotation * glm::vec3(mesh.vertices[v], mesh.vertices[v + 1], mesh.vertices[v + 2]) + offset;
+			vertices.push_back(position.x);
+			vertices.push_back(position.y);
+			vertices.push_back(position.z);
+			// 위치 외의 속성(텍스처 좌표 등) 은 그대로 복사한다
+			vertices.insert(vertices.end(), mesh.vertices.begin() + v + 3, mesh.vertices.begin() + v + floatsPerVertex);
+			chunk.bounds.grow(glm::vec3(chunk.origin) + position);
+		}
+		for (uint32_t index : mesh.indices)
+		{
+			indices.push_back(baseVertex + index);
+		}
+		chunk.indexCount += (unsigned int)mesh.indices.size();
+		chunk.instanceCount++;
+		unbatchedBytes += sizeof(glm::mat4);
+	}
+	for (const std::pair<const float *const, IndexedMesh> &mesh : meshes)
+	{
+		unbatchedBytes += mesh.second.vertices.size() * sizeof(float) + mesh.second.indices.size() * sizeof(uint32_t);
+	}
+	instances.clear();
+}
+
+void StaticBatch::createBuffers()
+{
+	clear();
+	glGenVertexArrays(1, &VAO);
+	glBindVertexArray(VAO);
+	glGenBuffers(1, &VBO);
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(vertices.size() * sizeof(float)), vertices.data(), GL_STATIC_DRAW);
+	glGenBuffers(1, &EBO);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)(indices.size() * sizeof(uint32_t)), indices.data(), GL_STATIC_DRAW);
+}
+
+void StaticBatch::cull(const Frustum &frustum, const Camera &camera, FrameVector<StaticBatchDraw> &draws) const
+{
+	for (const Chunk &chunk : chunks)
+	{
+		if (!frustum.intersects(chunk.bounds))
+		{
+			continue;
+		}
+		StaticBatchDraw batch;
+		batch.model = glm::mat4(1.0f);
+		batch.model[3] = glm::vec4(camera.ToCameraRelative(chunk.origin), 1.0f);
+		batch.material = chunk.material;
+		batch.firstIndex = chunk.firstIndex;
+		batch.indexCount = chunk.indexCount;
+		draws.push_back(batch);
+	}
+}
+
+void StaticBatch::bind() const
+{
+	glBindVertexArray(VAO);
+}
+
+void StaticBatch::draw(const StaticBatchDraw &batch) const
+{
+	glDrawElements(GL_TRIANGLES, (GLsizei)batch.indexCount, GL_UNSIGNED_INT, (void *)(batch.firstIndex * sizeof(uint32_t)));
+}
+
+void StaticBatch::printStats() const
+{
+	size_t instanceCount = 0;
+	for (const Chunk &chunk : chunks)
+	{
+		instanceCount += chunk.instanceCount;
+	}
+	size_t batchedBytes = vertices.size() * sizeof(float) + indices.size() * sizeof(uint32_t);
+	std::cout << "Static batching: " << instanceCount << " objects in " << chunks.size() << " chunks (draw calls " << instanceCount << " -> " << chunks.size()
+		<< "), memory " << unbatchedBytes / 1024.0 << " KB -> " << batchedBytes / 1024.0 << " KB" << std::endl;
+}
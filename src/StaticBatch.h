@@ -0,0 +1,118 @@
+#ifndef STATIC_BATCH_H
+#define STATIC_BATCH_H
+
+#include "Bounds.h"
+#include "Camera.h"
+#include "FrameArena.h"
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+// 정점 배열 하나로 된 메쉬, 각 정점은 floatsPerVertex 개의 float 이고 앞의 3개가 위치다
+struct StaticMesh
+{
+	const float *vertices;
+	size_t vertexCount;
+};
+
+// 한 덩어리(chunk) 의 그리기 명령, 모델 행렬은 카메라 기준으로 덩어리 원점까지의 이동만 포함한다
+struct StaticBatchDraw
+{
+	glm::mat4 model;
+	unsigned int material;
+	unsigned int firstIndex;
+	unsigned int indexCount;
+};
+
+// 움직이지 않는 물체의 월드 변환을 정점에 미리 적용(bake) 해서 큰 VBO / IBO 하나로 합친다
+// 물체는 머티리얼과 공간(chunkSize 크기의 격자 칸) 으로 묶이고, 덩어리마다 연속된 인덱스 구간 하나가 된다
+// 그래서 물체마다 모델 행렬과 그리기 호출이 필요 없고, 덩어리 단위로 프러스텀 컬링할 수 있다
+// 정점 위치는 덩어리 원점 기준 float 로 저장하고 원점은 double 로 유지하므로, 카메라 기준 렌더링의 정밀도를 그대로 유지한다
+// 대신 같은 메쉬라도 물체 수만큼 정점을 복사하므로 메모리가 늘어난다 (printStats 참고)
+class StaticBatch
+{
+	private:
+		struct Instance
+		{
+			StaticMesh mesh;
+			unsigned int material;
+			glm::dvec3 position;
+			glm::quat rotation;
+		};
+
+		struct Chunk
+		{
+			unsigned int material;
+			glm::dvec3 origin;
+			// 월드 좌표계 바운딩 박스
+			Aabb bounds;
+			unsigned int firstIndex;
+			unsigned int indexCount;
+			size_t instanceCount;
+		};
+
+		// 중복 정점을 합친 메쉬, 같은 메쉬를 쓰는 물체가 여러 개여도 한 번만 만든다
+		struct IndexedMesh
+		{
+			std::vector<float> vertices;
+			std::vector<uint32_t> indices;
+		};
+
+		size_t floatsPerVertex;
+		float chunkSize;
+		std::vector<Instance> instances;
+		std::vector<Chunk> chunks;
+		std::vector<float> vertices;
+		std::vector<uint32_t> indices;
+		// 합치지 않고 그렸을 때 필요한 메모리, 메쉬마다 정점 한 벌과 물체마다 모델 행렬 하나
+		size_t unbatchedBytes;
+
+		unsigned int VAO;
+		unsigned int VBO;
+		unsigned int EBO;
+
+		const IndexedMesh &indexMesh(const StaticMesh &mesh, std::map<const float *, IndexedMesh> &cache) const;
+		void createBuffers();
+
+	public:
+		StaticBatch(size_t floatsPerVertex, float chunkSize);
+		~StaticBatch();
+
+		StaticBatch(const StaticBatch &) = delete;
+		StaticBatch &operator=(const StaticBatch &) = delete;
+
+		// mesh 의 정점 배열은 build 가 끝날 때까지 유효해야 한다
+		void add(const StaticMesh &mesh, unsigned int material, const glm::dvec3 &position, const glm::quat &rotation);
+		// 추가된 물체를 덩어리로 묶어서 정점과 인덱스를 만든다
+		void build();
+		// GL 버퍼를 만들고 Layout 으로 정점 속성을 설정한다, GL 컨텍스트가 있는 스레드에서 호출
+		template <typename Layout>
+		void upload()
+		{
+			static_assert(Layout::stride % sizeof(float) == 0, "Layout stride must be a whole number of floats");
+			createBuffers();
+			Layout::apply();
+			glBindVertexArray(0);
+		}
+
+		// 프러스텀과 겹치는 덩어리의 그리기 명령을 머티리얼 순서로 draws 에 추가한다, frustum 은 월드 좌표계
+		void cull(const Frustum &frustum, const Camera &camera, FrameVector<StaticBatchDraw> &draws) const;
+		// 합친 VAO 를 바인딩한다, 이후 draw 로 덩어리를 그린다
+		void bind() const;
+		void draw(const StaticBatchDraw &batch) const;
+		// 물체 수, 덩어리 수(그리기 호출 수), 합치기 전후의 메모리를 출력한다
+		void printStats() const;
+		void clear();
+
+		size_t getChunkCount() const
+		{
+			return (chunks.size());
+		}
+};
+
+#endif
@@ -0,0 +1,131 @@
+#include "Texture.h"
+
+#include "EmbeddedResources.h"
+#include "ImageDecoder.h"
+#include "TextureCache.h"
+
+#include <iostream>
+
+namespace
+{
+	GLenum formatFromChannels(int channels)
+	{
+		switch (channels)
+		{
+			case 1:
+				return (GL_RED);
+			case 2:
+				return (GL_RG);
+			case 3:
+				return (GL_RGB);
+			default:
+				return (GL_RGBA);
+		}
+	}
+}
+
+TextureData importTexture(const std::string &path, const MipOptions &options)
+{
+	// 캐시는 작업 디렉터리가 아니라 실행 파일(또는 LEARNOPENGL_RESOURCE_DIR) 옆에 둔다
+	static const TextureCache cache(resolveCachePath("texture_cache/"));
+	TextureData texture;
+	if (cache.load(path, options, texture))
+	{
+		return (texture);
+	}
+	texture.path = path;
+
+	// 포맷을 판별해서 큰 JPEG/PNG 는 SIMD 디코더로, 나머지는 stb_image 로 디코딩한다
+	DecodedImage image;
+	if (!ImageDecoderRegistry::instance().decodeFile(path, true, image))
+	{
+		std::cout << "Failed to load texture: " << path << std::endl;
+		return (texture);
+	}
+	texture.width = image.width;
+	texture.height = image.height;
+	texture.channels = image.channels;
+	texture.levels = generateMipChain(image.pixels.data(), image.width, image.height, image.channels, options);
+	// 저장한 캐시를 다시 매핑해서 메모리에 올려둔 전체 밉 체인을 해제한다, 큰 밉은 스트리밍할 때 캐시에서 읽는다
+	TextureData cached;
+	if (cache.store(path, options, texture) && cache.load(path, options, cached))
+	{
+		return (cached);
+	}
+	return (texture);
+}
+
+std::future<TextureData> importTextureAsync(const std::string &path, const MipOptions &options)
+{
+	return (std::async(std::launch::async, importTexture, path, options));
+}
+
+unsigned int uploadTexture(const TextureData &texture, int baseLevel)
+{
+	unsigned int id;
+	glGenTextures(1, &id);
+	glBindTexture(GL_TEXTURE_2D, id);
+
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	// 밉맵을 직접 올리므로 축소 필터는 밉맵 사이까지 선형 보간하는 트라이리니어 필터를 사용
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+	if ((int)texture.levels.size() <= baseLevel)
+	{
+		return (id);
+	}
+
+	// baseLevel 보다 큰 밉은 올리지 않고 GL_TEXTURE_BASE_LEVEL 로 샘플링 범위를 제한한다
+	// GL 텍스처의 레벨 번호는 CPU 밉 체인과 같게 유지해서, 나중에 큰 밉을 추가로 올릴 때 텍스처를 다시 만들 필요가 없다
+	GLint count = (GLint)texture.levels.size();
+	for (GLint level = baseLevel; level < count; ++level)
+	{
+		uploadTextureLevel(texture, level);
+	}
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, baseLevel);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, count - 1);
+	return (id);
+}
+
+const unsigned char *getLevelPixels(const TextureData &texture, int level)
+{
+	if (texture.mapped)
+	{
+		return (texture.mapped->getData() + texture.levelOffsets[level]);
+	}
+	return (texture.levels[level].pixels.data());
+}
+
+void uploadTextureLevel(const TextureData &texture, int level)
+{
+	uploadTextureLevel(texture, level, getLevelPixels(texture, level));
+}
+
+void uploadTextureLevel(const TextureData &texture, int level, const void *pixels)
+{
+	// 작은 밉 레벨은 행 크기가 4바이트 배수가 아닐 수 있으므로 정렬을 1 로 맞춘다
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	GLenum format = formatFromChannels(texture.channels);
+	const MipLevel &mip = texture.levels[level];
+	glTexImage2D(GL_TEXTURE_2D, level, format, mip.width, mip.height, 0, format, GL_UNSIGNED_BYTE, pixels);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+}
+
+size_t getLevelBytes(const TextureData &texture, int level)
+{
+	return ((size_t)texture.levels[level].width * texture.levels[level].height * texture.channels);
+}
+
+size_t estimateTextureBytes(const TextureData &texture, int baseLevel)
+{
+	// 3 채널 텍스처는 대부분의 드라이버가 4 바이트 텍셀로 저장한다
+	size_t texelBytes = (texture.channels == 3) ? 4 : (size_t)texture.channels;
+	size_t bytes = 0;
+	for (size_t level = baseLevel; level < texture.levels.size(); ++level)
+	{
+		bytes += (size_t)texture.levels[level].width * texture.levels[level].height * texelBytes;
+	}
+	return (bytes);
+}
@@ -0,0 +1,45 @@
+#ifndef TEXTURE_H
+#define TEXTURE_H
+
+#include "MappedFile.h"
+#include "Mipmap.h"
+
+#include <glad/glad.h>
+
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+// 디코딩과 밉 체인 생성까지 끝난, GPU 업로드 직전의 텍스처 데이터
+// 텍스처 캐시에서 읽었으면 levels 에는 크기만 있고 픽셀은 mapped 의 levelOffsets 위치에 있다, 접근할 때 getLevelPixels 를 사용
+struct TextureData
+{
+	std::string path;
+	int width = 0;
+	int height = 0;
+	int channels = 0;
+	std::vector<MipLevel> levels;
+	std::shared_ptr<MappedFile> mapped;
+	std::vector<size_t> levelOffsets;
+};
+
+// 이미지 디코딩 + CPU 밉맵 생성을 수행한다. GL 함수를 호출하지 않으므로 워커 스레드에서 실행해도 된다
+// 텍스처 캐시가 원본과 일치하면 디코딩 없이 캐시 파일을 매핑만 하고, 없으면 만든 밉 체인을 캐시에 저장한 뒤 매핑해서 돌려준다
+TextureData importTexture(const std::string &path, const MipOptions &options = MipOptions());
+// importTexture 를 워커 스레드에서 실행, 여러 텍스처를 동시에 임포트할 수 있다
+std::future<TextureData> importTextureAsync(const std::string &path, const MipOptions &options = MipOptions());
+// 미리 계산된 밉 레벨(baseLevel 부터 1x1 까지)을 업로드한 텍스처 객체를 만든다. GL 컨텍스트가 있는 스레드에서만 호출
+unsigned int uploadTexture(const TextureData &texture, int baseLevel = 0);
+// 밉 레벨의 픽셀 데이터, 매핑된 캐시라면 처음 접근할 때 해당 페이지만 디스크에서 읽힌다
+const unsigned char *getLevelPixels(const TextureData &texture, int level);
+// 현재 바인딩된 GL_TEXTURE_2D 에 밉 레벨 하나를 업로드한다
+void uploadTextureLevel(const TextureData &texture, int level);
+// pixels 는 CPU 메모리의 포인터, GL_PIXEL_UNPACK_BUFFER 가 바인딩되어 있으면 그 버퍼 안의 오프셋
+void uploadTextureLevel(const TextureData &texture, int level, const void *pixels);
+// 밉 레벨 하나의 픽셀 바이트 수 (행 사이 패딩 없음)
+size_t getLevelBytes(const TextureData &texture, int level);
+// baseLevel 부터 업로드했을 때 GPU 에서 차지할 메모리 추정치(바이트)
+size_t estimateTextureBytes(const TextureData &texture, int baseLevel = 0);
+
+#endif
@@ -0,0 +1,202 @@
+#include "TextureCache.h"
+#include "EmbeddedResources.h"
+#include "SourceStamp.h"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace
+{
+	const uint32_t CACHE_MAGIC = 0x43545347; // "GSTC"
+	const uint32_t CACHE_VERSION = 1;
+
+	struct TextureCacheHeader
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint64_t sourceSize;
+		int64_t sourceTime;
+		uint64_t sourceHash;
+		uint32_t width;
+		uint32_t height;
+		uint32_t channels;
+		uint32_t levelCount;
+		uint64_t fileSize;
+	};
+
+	// 밉 레벨 번호 순서로 저장한다, offset 은 파일 시작부터의 위치
+	struct TextureCacheLevel
+	{
+		uint32_t width;
+		uint32_t height;
+		uint64_t offset;
+		uint64_t bytes;
+	};
+
+	// FNV-1a 64비트 해시
+	uint64_t fnv1a(const std::string &data, uint64_t hash = 0xcbf29ce484222325ULL)
+	{
+		for (unsigned char c : data)
+		{
+			hash ^= c;
+			hash *= 0x100000001b3ULL;
+		}
+		return (hash);
+	}
+
+	bool readHeader(const std::string &path, TextureCacheHeader &header)
+	{
+		std::ifstream file(path, std::ios::binary);
+		file.read((char *)&header, sizeof(header));
+		return (file && header.magic == CACHE_MAGIC && header.version == CACHE_VERSION);
+	}
+
+	bool writeHeader(const std::string &path, const TextureCacheHeader &header)
+	{
+		std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+		file.write((const char *)&header, sizeof(header));
+		return ((bool)file);
+	}
+}
+
+TextureCache::TextureCache(const std::string &directory) : directory(directory)
+{
+	std::error_code error;
+	std::filesystem::create_directories(directory, error);
+}
+
+std::string TextureCache::pathFor(const std::string &source, const MipOptions &options) const
+{
+	// 같은 원본이라도 밉 옵션이 다르면 밉 체인이 다르므로 옵션까지 키에 넣는다
+	uint64_t hash = fnv1a(source);
+	char settings[64];
+	std::snprintf(settings, sizeof(settings), "|%d|%d|%d|%.4f", (int)options.filter, (int)options.sRGB, (int)options.preserveAlphaCoverage, options.alphaCutoff);
+	hash = fnv1a(settings, hash);
+	char name[32];
+	std::snprintf(name, sizeof(name), "%016llx.tex", (unsigned long long)hash);
+	return (directory + name);
+}
+
+bool TextureCache::load(const std::string &source, const MipOptions &options, TextureData &texture) const
+{
+	// 디코더와 같은 파일을 확인하도록 원본은 리소스 경로 규칙으로 찾는다, 캐시 키는 요청한 경로 그대로 쓴다
+	std::string sourceFile = resolveResourcePath(source);
+	SourceStamp stamp;
+	std::string path = pathFor(source, options);
+	TextureCacheHeader header;
+	if (!getSourceStamp(sourceFile, stamp) || !readHeader(path, header) || header.sourceSize != stamp.size)
+	{
+		return (false);
+	}
+	// 크기가 같고 수정 시간만 다르면 내용을 해시해서 확인한다, 같으면 다음 실행에서 해시하지 않도록 시간을 갱신한다
+	if (header.sourceTime != stamp.modified)
+	{
+		if (hashFileContents(sourceFile) != header.sourceHash)
+		{
+			return (false);
+		}
+		header.sourceTime = stamp.modified;
+		writeHeader(path, header);
+	}
+
+	std::shared_ptr<MappedFile> mapped = std::make_shared<MappedFile>();
+	if (!mapped->open(path, false))
+	{
+		return (false);
+	}
+	const unsigned char *data = mapped->getData();
+	size_t size = mapped->getSize();
+	// 레벨 범위가 파일 안에 있는지 확인해서 잘렸거나 손상된 파일을 그대로 GPU 로 넘기지 않는다
+	if (header.fileSize != size || header.channels < 1 || header.channels > 4 || header.levelCount == 0 || header.levelCount > 32
+		|| sizeof(header) + header.levelCount * sizeof(TextureCacheLevel) > size)
+	{
+		return (false);
+	}
+	std::vector<TextureCacheLevel> table(header.levelCount);
+	std::memcpy(table.data(), data + sizeof(header), header.levelCount * sizeof(TextureCacheLevel));
+
+	TextureData result;
+	result.path = source;
+	result.width = (int)header.width;
+	result.height = (int)header.height;
+	result.channels = (int)header.channels;
+	result.levels.resize(header.levelCount);
+	result.levelOffsets.resize(header.levelCount);
+	for (uint32_t level = 0; level < header.levelCount; level++)
+	{
+		const TextureCacheLevel &entry = table[level];
+		if (entry.bytes != (uint64_t)entry.width * entry.height * header.channels || entry.offset > size || entry.bytes > size - entry.offset)
+		{
+			return (false);
+		}
+		result.levels[level].width = (int)entry.width;
+		result.levels[level].height = (int)entry.height;
+		result.levelOffsets[level] = (size_t)entry.offset;
+	}
+	result.mapped = std::move(mapped);
+	texture = std::move(result);
+	return (true);
+}
+
+bool TextureCache::store(const std::string &source, const MipOptions &options, const TextureData &texture) const
+{
+	std::string sourceFile = resolveResourcePath(source);
+	SourceStamp stamp;
+	if (texture.levels.empty() || texture.mapped || !getSourceStamp(sourceFile, stamp))
+	{
+		return (false);
+	}
+	TextureCacheHeader header = {};
+	header.magic = CACHE_MAGIC;
+	header.version = CACHE_VERSION;
+	header.sourceSize = stamp.size;
+	header.sourceTime = stamp.modified;
+	header.sourceHash = hashFileContents(sourceFile);
+	header.width = (uint32_t)texture.width;
+	header.height = (uint32_t)texture.height;
+	header.channels = (uint32_t)texture.channels;
+	header.levelCount = (uint32_t)texture.levels.size();
+
+	// 작은 밉을 앞에 두어서 처음에 올리는 레벨들이 파일 앞쪽의 몇 페이지에 모이게 한다
+	std::vector<TextureCacheLevel> table(texture.levels.size());
+	uint64_t offset = sizeof(header) + table.size() * sizeof(TextureCacheLevel);
+	for (size_t level = table.size(); level-- > 0;)
+	{
+		table[level].width = (uint32_t)texture.levels[level].width;
+		table[level].height = (uint32_t)texture.levels[level].height;
+		table[level].offset = offset;
+		table[level].bytes = texture.levels[level].pixels.size();
+		offset += table[level].bytes;
+	}
+	header.fileSize = offset;
+
+	// 반쯤 쓰인 파일을 다른 프로세스가 읽지 않도록 임시 파일에 쓴 뒤 이름을 바꾼다
+	std::string path = pathFor(source, options);
+	std::string temporary = path + ".tmp";
+	bool written;
+	{
+		std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+		file.write((const char *)&header, sizeof(header));
+		file.write((const char *)table.data(), (std::streamsize)(table.size() * sizeof(TextureCacheLevel)));
+		for (size_t level = table.size(); level-- > 0;)
+		{
+			file.write((const char *)texture.levels[level].pixels.data(), (std::streamsize)texture.levels[level].pixels.size());
+		}
+		written = (bool)file;
+	}
+	std::error_code error;
+	if (written)
+	{
+		std::filesystem::rename(temporary, path, error);
+	}
+	// 쓰기나 이름 바꾸기에 실패하면 임시 파일을 남기지 않는다
+	if (!written || error)
+	{
+		std::filesystem::remove(temporary, error);
+		return (false);
+	}
+	return (true);
+}
@@ -0,0 +1,28 @@
+#ifndef TEXTURE_CACHE_H
+#define TEXTURE_CACHE_H
+
+#include "Texture.h"
+
+#include <string>
+
+// 디코딩과 밉 체인 생성이 끝난 텍스처를 디스크에 저장해서 다음 실행부터 디코딩을 건너뛴다
+// 파일은 헤더, 레벨 표, 가장 작은 밉부터 큰 밉 순서의 픽셀 블록이다. 읽을 때는 미리 읽기 없이 매핑만 하므로
+// 처음에 올리는 작은 밉이 있는 파일 앞부분만 디스크에서 읽히고, 큰 밉은 스트리밍으로 필요해질 때 읽힌다
+// 원본의 크기와 수정 시간이 같으면 원본을 읽지 않고, 시간만 다르면 내용 해시를 비교해서 같을 때 계속 사용한다
+class TextureCache
+{
+	private:
+		std::string directory;
+
+		std::string pathFor(const std::string &source, const MipOptions &options) const;
+
+	public:
+		TextureCache(const std::string &directory = "./texture_cache/");
+
+		// 캐시가 있고 원본과 일치하면 texture 를 매핑한 밉 레벨로 채우고 true
+		bool load(const std::string &source, const MipOptions &options, TextureData &texture) const;
+		// texture 는 밉 레벨 픽셀을 메모리에 가지고 있어야 한다
+		bool store(const std::string &source, const MipOptions &options, const TextureData &texture) const;
+};
+
+#endif
@@ -0,0 +1,374 @@
+#include "TextureManager.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+TextureManager::TextureManager(size_t budgetBytes) : budget(budgetBytes), totalResidentBytes(0), frame(1), overBudget(false), streamStopping(false)
+{
+}
+
+TextureManager::~TextureManager()
+{
+	// GL 객체는 clear 에서 지운다, 여기서는 워커 스레드만 멈춘다
+	stopStreamThread();
+}
+
+TextureHandle TextureManager::add(TextureData &&data)
+{
+	TextureHandle handle = (TextureHandle)entries.size();
+	Entry entry;
+	entry.data = std::move(data);
+	entry.id = 0;
+	entry.residentBase = (int)entry.data.levels.size();
+	entry.requestedBase = 0;
+	entry.minLod = 0.0f;
+	entry.generation = 0;
+	entry.streaming = false;
+	entry.residentBytes = 0;
+	entry.lastUsedFrame = 0;
+	entry.lruPosition = lru.insert(lru.begin(), handle);
+	entries.push_back(std::move(entry));
+
+	// 예산 검사는 endFrame 에서 한다, 추가만 하고 아직 사용하지 않은 텍스처도 LRU 순서에 따라 내려갈 수 있다
+	// 초기 로딩에서는 작은 밉만 올리므로 로딩 시간과 메모리가 전체 에셋 크기가 아니라 보이는 만큼에 비례한다
+	makeResident(entries.back(), lowestDroppableLevel(entries.back()));
+	return (handle);
+}
+
+void TextureManager::bind(TextureHandle handle, unsigned int unit)
+{
+	Entry &entry = entries[handle];
+	entry.lastUsedFrame = frame;
+	// LRU 리스트의 맨 앞으로 옮긴다, splice 는 노드만 옮기므로 iterator 가 그대로 유효하다
+	lru.splice(lru.begin(), lru, entry.lruPosition);
+
+	if (entry.id == 0)
+	{
+		makeResident(entry, lowestDroppableLevel(entry));
+	}
+	glActiveTexture(GL_TEXTURE0 + unit);
+	glBindTexture(GL_TEXTURE_2D, entry.id);
+}
+
+void TextureManager::requestBaseLevel(TextureHandle handle, int level)
+{
+	Entry &entry = entries[handle];
+	entry.requestedBase = std::min(std::max(level, 0), lowestDroppableLevel(entry));
+}
+
+void TextureManager::streamPending(size_t uploadBudgetBytes)
+{
+	finishJobs();
+	size_t uploaded = 0;
+	// 최근에 사용한 텍스처부터 처리한다
+	for (TextureHandle handle : lru)
+	{
+		Entry &entry = entries[handle];
+		if (entry.id == 0)
+		{
+			continue;
+		}
+		// 필요한 것보다 두 레벨 이상 크게 올라가 있으면 내린다, 한 레벨 차이는 카메라가 조금 움직일 때 반복해서 올리고 내리지 않도록 남겨둔다
+		if (entry.residentBase + 1 < entry.requestedBase)
+		{
+			makeResident(entry, entry.requestedBase);
+			continue;
+		}
+		if (entry.residentBase > entry.requestedBase)
+		{
+			if (entry.streaming)
+			{
+				continue;
+			}
+			size_t levelBytes = estimateTextureBytes(entry.data, entry.residentBase - 1) - entry.residentBytes;
+			if (uploaded > 0 && uploaded + levelBytes > uploadBudgetBytes)
+			{
+				continue;
+			}
+			queueLevel(handle, entry.residentBase - 1);
+			uploaded += levelBytes;
+		}
+		else if (entry.minLod > 0.0f)
+		{
+			entry.minLod = std::max(0.0f, entry.minLod - LOD_FADE_STEP);
+			beginUpload(entry.id);
+			glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_LOD, entry.minLod);
+			endUpload();
+		}
+	}
+}
+
+void TextureManager::endFrame()
+{
+	enforceBudget();
+	++frame;
+}
+
+void TextureManager::clear()
+{
+	// 워커 스레드가 모든 작업을 끝낸 뒤에 매핑을 풀고 PBO 를 지운다
+	stopStreamThread();
+	for (StreamJob &job : jobs)
+	{
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, job.buffer);
+		glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+		freeBuffers.push_back(job.buffer);
+	}
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	jobs.clear();
+	if (!freeBuffers.empty())
+	{
+		glDeleteBuffers((GLsizei)freeBuffers.size(), freeBuffers.data());
+		freeBuffers.clear();
+	}
+	for (Entry &entry : entries)
+	{
+		evict(entry);
+	}
+	entries.clear();
+	lru.clear();
+}
+
+void TextureManager::setBudget(size_t budgetBytes)
+{
+	budget = budgetBytes;
+	enforceBudget();
+}
+
+size_t TextureManager::getBudget() const
+{
+	return (budget);
+}
+
+size_t TextureManager::getResidentBytes() const
+{
+	return (totalResidentBytes);
+}
+
+int TextureManager::getResidentBaseLevel(TextureHandle handle) const
+{
+	return (entries[handle].residentBase);
+}
+
+const TextureData &TextureManager::getData(TextureHandle handle) const
+{
+	return (entries[handle].data);
+}
+
+void TextureManager::beginUpload(unsigned int id) const
+{
+	glActiveTexture(GL_TEXTURE0 + UPLOAD_TEXTURE_UNIT);
+	glBindTexture(GL_TEXTURE_2D, id);
+}
+
+void TextureManager::endUpload() const
+{
+	glBindTexture(GL_TEXTURE_2D, 0);
+	glActiveTexture(GL_TEXTURE0);
+}
+
+void TextureManager::makeResident(Entry &entry, int baseLevel)
+{
+	if (entry.data.levels.empty())
+	{
+		return;
+	}
+	// 밉 레벨 수가 바뀌면 텍스처 저장 공간 크기 자체가 달라지므로, 기존 텍스처는 지우고 새로 만들어서 메모리를 실제로 반환한다
+	if (entry.id != 0)
+	{
+		glDeleteTextures(1, &entry.id);
+	}
+	// uploadTexture 는 새 텍스처를 활성 유닛에 바인딩하므로 업로드 유닛에서 호출한다
+	beginUpload(0);
+	entry.id = uploadTexture(entry.data, baseLevel);
+	endUpload();
+	entry.residentBase = baseLevel;
+	entry.minLod = 0.0f;
+	entry.generation++;
+	totalResidentBytes -= entry.residentBytes;
+	entry.residentBytes = estimateTextureBytes(entry.data, baseLevel);
+	totalResidentBytes += entry.residentBytes;
+}
+
+void TextureManager::refine(Entry &entry, const void *pixels)
+{
+	// 텍스처를 다시 만들지 않고 바로 위 밉 레벨 하나만 추가로 올린 다음 GL_TEXTURE_BASE_LEVEL 을 낮춘다
+	// GL_TEXTURE_MIN_LOD 는 base level 기준의 값이므로 1 을 더해서 이전 레벨에 머물게 하고, streamPending 에서 서서히 0 까지 낮춘다
+	int level = entry.residentBase - 1;
+	entry.minLod += 1.0f;
+	beginUpload(entry.id);
+	uploadTextureLevel(entry.data, level, pixels);
+	glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_LOD, entry.minLod);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level);
+	endUpload();
+	entry.residentBase = level;
+	totalResidentBytes -= entry.residentBytes;
+	entry.residentBytes = estimateTextureBytes(entry.data, level);
+	totalResidentBytes += entry.residentBytes;
+}
+
+void TextureManager::queueLevel(TextureHandle handle, int level)
+{
+	Entry &entry = entries[handle];
+	size_t bytes = getLevelBytes(entry.data, level);
+	unsigned int buffer = 0;
+	if (freeBuffers.empty())
+	{
+		glGenBuffers(1, &buffer);
+	}
+	else
+	{
+		buffer = freeBuffers.back();
+		freeBuffers.pop_back();
+	}
+	// 이전 내용을 버리고 매핑해서 드라이버가 GPU 가 아직 읽고 있는 저장소를 기다리지 않게 한다
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+	glBufferData(GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr)bytes, NULL, GL_STREAM_DRAW);
+	void *destination = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, (GLsizeiptr)bytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	if (destination == NULL)
+	{
+		freeBuffers.push_back(buffer);
+		refine(entry, getLevelPixels(entry.data, level));
+		return;
+	}
+
+	jobs.emplace_back();
+	StreamJob &job = jobs.back();
+	job.handle = handle;
+	job.level = level;
+	job.generation = entry.generation;
+	job.buffer = buffer;
+	job.bytes = bytes;
+	job.mapped = entry.data.mapped;
+	job.source = getLevelPixels(entry.data, level);
+	job.destination = destination;
+	job.done.store(false);
+	entry.streaming = true;
+
+	std::lock_guard<std::mutex> lock(streamMutex);
+	if (!streamThread.joinable())
+	{
+		streamStopping = false;
+		streamThread = std::thread(&TextureManager::streamWorker, this);
+	}
+	streamQueue.push_back(&job);
+	streamCondition.notify_one();
+}
+
+void TextureManager::finishJobs()
+{
+	while (!jobs.empty() && jobs.front().done.load(std::memory_order_acquire))
+	{
+		StreamJob &job = jobs.front();
+		Entry &entry = entries[job.handle];
+		entry.streaming = false;
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, job.buffer);
+		// 매핑 중에 저장소가 손상되면(화면 모드 변경 등) false 가 되므로 그 결과는 버리고 다음에 다시 요청한다
+		bool intact = glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) == GL_TRUE;
+		// 작업 중에 텍스처를 다시 만들었거나 내렸으면 올릴 레벨이 더 이상 바로 위 레벨이 아니다
+		if (intact && entry.id != 0 && entry.generation == job.generation && entry.residentBase == job.level + 1)
+		{
+			refine(entry, (const void *)0);
+		}
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		freeBuffers.push_back(job.buffer);
+		jobs.pop_front();
+	}
+}
+
+void TextureManager::streamWorker()
+{
+	std::unique_lock<std::mutex> lock(streamMutex);
+	while (true)
+	{
+		streamCondition.wait(lock, [this]()
+		{
+			return (streamStopping || !streamQueue.empty());
+		});
+		// 멈출 때도 남은 작업은 모두 끝내서 GL 스레드가 매핑을 풀 수 있게 한다
+		if (streamQueue.empty())
+		{
+			return;
+		}
+		StreamJob *job = streamQueue.front();
+		streamQueue.pop_front();
+		lock.unlock();
+		std::memcpy(job->destination, job->source, job->bytes);
+		job->done.store(true, std::memory_order_release);
+		lock.lock();
+	}
+}
+
+void TextureManager::stopStreamThread()
+{
+	{
+		std::lock_guard<std::mutex> lock(streamMutex);
+		streamStopping = true;
+	}
+	streamCondition.notify_one();
+	if (streamThread.joinable())
+	{
+		streamThread.join();
+	}
+}
+
+void TextureManager::evict(Entry &entry)
+{
+	if (entry.id != 0)
+	{
+		glDeleteTextures(1, &entry.id);
+		entry.id = 0;
+	}
+	entry.residentBase = (int)entry.data.levels.size();
+	entry.generation++;
+	totalResidentBytes -= entry.residentBytes;
+	entry.residentBytes = 0;
+}
+
+int TextureManager::lowestDroppableLevel(const Entry &entry) const
+{
+	int level = 0;
+	int count = (int)entry.data.levels.size();
+	while (level + 1 < count && (entry.data.levels[level].width > MIN_RESIDENT_SIZE || entry.data.levels[level].height > MIN_RESIDENT_SIZE))
+	{
+		++level;
+	}
+	return (level);
+}
+
+void TextureManager::enforceBudget()
+{
+	// LRU 리스트의 뒤쪽(가장 오래 사용하지 않은 텍스처)부터 가장 큰 밉을 하나씩 떨어뜨리고,
+	// 작은 밉만 남으면 텍스처 전체를 내린다. 이번 프레임에 사용한 텍스처는 건드리지 않는다
+	auto it = lru.rbegin();
+	while (totalResidentBytes > budget && it != lru.rend())
+	{
+		Entry &entry = entries[*it];
+		if (entry.lastUsedFrame == frame)
+		{
+			break;
+		}
+		if (entry.id == 0)
+		{
+			++it;
+			continue;
+		}
+		if (entry.residentBase < lowestDroppableLevel(entry))
+		{
+			makeResident(entry, entry.residentBase + 1);
+		}
+		else
+		{
+			evict(entry);
+		}
+	}
+	// 사용 중인 텍스처만으로 예산을 넘는 경우, 매 프레임 출력하지 않도록 상태가 바뀔 때만 알린다
+	bool over = totalResidentBytes > budget;
+	if (over && !overBudget)
+	{
+		std::cout << "TextureManager: textures in use exceed the budget (" << totalResidentBytes << " / " << budget << " bytes)" << std::endl;
+	}
+	overBudget = over;
+}
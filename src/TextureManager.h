@@ -0,0 +1,137 @@
+#ifndef TEXTURE_MANAGER_H
+#define TEXTURE_MANAGER_H
+
+#include "Texture.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+typedef unsigned int TextureHandle;
+
+const size_t DEFAULT_TEXTURE_BUDGET = 256 * 1024 * 1024;
+// 한 프레임에 스트리밍으로 업로드할 최대 바이트 수, 최소 한 레벨은 항상 올린다
+const size_t DEFAULT_STREAM_UPLOAD_BUDGET = 4 * 1024 * 1024;
+// 새 밉이 올라왔을 때 GL_TEXTURE_MIN_LOD 를 프레임마다 이만큼씩 낮춰서 갑자기 선명해지지 않게 한다
+const float LOD_FADE_STEP = 0.125f;
+// 이 크기 이하의 밉만 남으면 더 이상 밉을 떨어뜨리지 않고 텍스처 전체를 내린다
+const int MIN_RESIDENT_SIZE = 32;
+
+// 텍스처의 GPU 상주(residency) 를 관리한다
+// 텍스처별 GPU 메모리를 추정해서 예산을 넘으면 가장 오래 사용되지 않은(LRU) 텍스처부터 큰 밉을 떨어뜨리고,
+// 다시 바인딩될 때 CPU 에 남겨둔 밉 체인으로부터 다시 올린다
+// 스트리밍으로 올리는 큰 밉은 워커 스레드가 캐시 파일에서 읽어 PBO 에 채우고, GL 스레드는 채워진 PBO 에서 업로드만 한다
+class TextureManager
+{
+	private:
+		struct Entry
+		{
+			TextureData data;
+			// GL 텍스처 객체, 상주하지 않으면 0
+			unsigned int id;
+			// 현재 GPU 에 올라가 있는 가장 큰 밉 레벨, 상주하지 않으면 data.levels.size()
+			int residentBase;
+			// 스트리밍으로 올려야 하는 가장 큰 밉 레벨
+			int requestedBase;
+			// 현재 GL_TEXTURE_MIN_LOD 값(base level 기준), 새 밉이 올라오면 1 씩 늘었다가 0 까지 서서히 내려간다
+			float minLod;
+			// makeResident / evict 할 때마다 늘어난다, 그 전에 시작한 스트리밍 결과는 버린다
+			uint64_t generation;
+			// 이 텍스처의 밉을 읽는 스트리밍 작업이 진행 중이면 true, 텍스처마다 한 번에 하나만 진행한다
+			bool streaming;
+			size_t residentBytes;
+			uint64_t lastUsedFrame;
+			std::list<TextureHandle>::iterator lruPosition;
+		};
+
+		// 밉 레벨 하나를 읽는 스트리밍 작업, GL 스레드가 매핑한 PBO 에 워커 스레드가 픽셀을 복사한다
+		// 매핑된 캐시 파일의 페이지를 디스크에서 읽는 비용은 워커 스레드가 지므로 프레임 시간이 읽기 속도에 묶이지 않는다
+		struct StreamJob
+		{
+			TextureHandle handle;
+			int level;
+			uint64_t generation;
+			unsigned int buffer;
+			size_t bytes;
+			// 작업이 끝날 때까지 캐시 파일의 매핑을 유지한다
+			std::shared_ptr<MappedFile> mapped;
+			const unsigned char *source;
+			void *destination;
+			std::atomic<bool> done;
+		};
+
+		// 업로드와 파라미터 변경에만 쓰는 텍스처 유닛, 그리는 쪽이 바인딩해둔 유닛의 텍스처를 바꾸지 않는다
+		// GpuCuller 의 깊이 피라미드 유닛(15) 과 겹치지 않게 한다
+		static const int UPLOAD_TEXTURE_UNIT = 14;
+
+		std::vector<Entry> entries;
+		// 앞쪽일수록 최근에 사용된 텍스처
+		std::list<TextureHandle> lru;
+		size_t budget;
+		size_t totalResidentBytes;
+		// 1 부터 시작, lastUsedFrame 이 0 이면 한 번도 사용되지 않은 텍스처
+		uint64_t frame;
+		bool overBudget;
+
+		// 시작한 순서대로의 스트리밍 작업, 끝난 작업은 앞에서부터 업로드한다 (GL 스레드만 접근)
+		std::list<StreamJob> jobs;
+		// 업로드가 끝나서 다시 쓸 수 있는 PBO
+		std::vector<unsigned int> freeBuffers;
+		std::thread streamThread;
+		std::mutex streamMutex;
+		std::condition_variable streamCondition;
+		std::deque<StreamJob *> streamQueue;
+		bool streamStopping;
+
+		// 업로드 유닛을 활성화하고 텍스처를 바인딩한다, 끝나면 endUpload 로 바인딩을 풀고 GL_TEXTURE0 으로 되돌린다
+		void beginUpload(unsigned int id) const;
+		void endUpload() const;
+		void makeResident(Entry &entry, int baseLevel);
+		// 바로 위 밉 레벨 하나를 올린다, pixels 는 uploadTextureLevel 과 같다
+		void refine(Entry &entry, const void *pixels);
+		// 밉 레벨 하나의 스트리밍 작업을 시작한다, PBO 를 매핑할 수 없으면 바로 올린다
+		void queueLevel(TextureHandle handle, int level);
+		// 워커 스레드가 끝낸 작업을 시작한 순서대로 업로드한다, 끝나지 않은 작업은 기다리지 않는다
+		void finishJobs();
+		void streamWorker();
+		// 남은 작업을 모두 끝내고 워커 스레드를 멈춘다
+		void stopStreamThread();
+		void evict(Entry &entry);
+		int lowestDroppableLevel(const Entry &entry) const;
+		void enforceBudget();
+
+	public:
+		TextureManager(size_t budgetBytes = DEFAULT_TEXTURE_BUDGET);
+		~TextureManager();
+
+		TextureManager(const TextureManager &) = delete;
+		TextureManager &operator=(const TextureManager &) = delete;
+
+		// 처음에는 작은 밉만 올리고, 큰 밉은 streamPending 에서 요청된 만큼만 올린다
+		TextureHandle add(TextureData &&data);
+		// 텍스처를 지정한 텍스처 유닛에 바인딩, 내려가 있던 텍스처라면 작은 밉부터 다시 올린다
+		void bind(TextureHandle handle, unsigned int unit);
+		// 화면에 필요한 가장 큰 밉 레벨을 지정한다 (TextureStreamer 가 매 프레임 계산)
+		void requestBaseLevel(TextureHandle handle, int level);
+		// 요청된 밉 레벨까지 uploadBudgetBytes 안에서 한 레벨씩 스트리밍을 시작하고, 필요 이상으로 올라가 있는 밉은 내린다
+		// 워커 스레드가 읽기를 끝낸 레벨은 다음 호출에서 업로드되므로, 요청한 밉은 한 프레임 이상 늦게 올라온다
+		void streamPending(size_t uploadBudgetBytes = DEFAULT_STREAM_UPLOAD_BUDGET);
+		// 프레임이 끝날 때 호출, 이번 프레임에 사용하지 않은 텍스처 중에서 예산을 넘는 만큼 내린다
+		void endFrame();
+		// 스트리밍 작업을 끝내고 모든 GL 텍스처와 PBO 를 삭제한다. GL 컨텍스트가 파괴되기 전에 호출해야 한다
+		void clear();
+
+		void setBudget(size_t budgetBytes);
+		size_t getBudget() const;
+		size_t getResidentBytes() const;
+		int getResidentBaseLevel(TextureHandle handle) const;
+		const TextureData &getData(TextureHandle handle) const;
+};
+
+#endif
@@ -0,0 +1,65 @@
+#include "TextureStreamer.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+TextureStreamer::TextureStreamer(TextureManager &textures, size_t uploadBytesPerFrame) : textures(textures), textureCount(0), uploadBudget(uploadBytesPerFrame)
+{
+}
+
+void TextureStreamer::addInstance(TextureHandle texture, int textureWidth, const glm::dvec3 &center, float radius, float worldSize)
+{
+	instances.push_back({texture, center, radius, textureWidth / worldSize});
+	textureCount = std::max(textureCount, (size_t)texture + 1);
+}
+
+void TextureStreamer::clearInstances()
+{
+	instances.clear();
+	textureCount = 0;
+}
+
+int TextureStreamer::requiredMipLevel(float texelsPerUnit, float distance, float fovY, int viewportHeight)
+{
+	// 거리 distance 에서 월드 단위 길이 1 이 화면에서 차지하는 픽셀 수
+	float pixelsPerUnit = viewportHeight / (2.0f * distance * std::tan(fovY * 0.5f));
+	// 화면 픽셀 하나에 들어가는 텍셀 수가 2^n 이면 밉 레벨 n 이 필요하다
+	float texelsPerPixel = texelsPerUnit / pixelsPerUnit;
+	if (texelsPerPixel <= 1.0f)
+	{
+		return (0);
+	}
+	return ((int)std::floor(std::log2(texelsPerPixel)));
+}
+
+void TextureStreamer::selectLevels(const Camera &camera, int viewportHeight, int *levels) const
+{
+	std::fill(levels, levels + textureCount, INT_MAX);
+	float fovY = glm::radians(camera.Zoom);
+	// 화면 가장자리 오브젝트까지 고려해서 대략적인 시야 원뿔의 반각을 넉넉하게 잡는다
+	float cosHalfFov = std::cos(std::min(fovY * 1.2f, glm::radians(89.0f)));
+
+	for (const Instance &instance : instances)
+	{
+		glm::vec3 toObject = camera.ToCameraRelative(instance.center);
+		float centerDistance = glm::length(toObject);
+		float distance = std::max(centerDistance - instance.radius, 0.1f);
+		// 바운딩 구가 시야 원뿔 밖에 있으면 선명한 밉이 필요 없다
+		if (centerDistance > instance.radius && glm::dot(toObject, camera.Front) < centerDistance * cosHalfFov - instance.radius)
+		{
+			continue;
+		}
+		int level = requiredMipLevel(instance.texelsPerUnit, distance, fovY, viewportHeight);
+		levels[instance.texture] = std::min(levels[instance.texture], level);
+	}
+}
+
+void TextureStreamer::stream(const int *levels, size_t count)
+{
+	for (size_t handle = 0; handle < count; ++handle)
+	{
+		textures.requestBaseLevel((TextureHandle)handle, levels[handle]);
+	}
+	textures.streamPending(uploadBudget);
+}
@@ -0,0 +1,53 @@
+#ifndef TEXTURE_STREAMER_H
+#define TEXTURE_STREAMER_H
+
+#include "Camera.h"
+#include "TextureManager.h"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+// 카메라로부터의 거리와 화면에 투영된 크기로 텍스처마다 필요한 밉 레벨을 추정하고,
+// TextureManager 에 요청해서 필요한 밉만 점진적으로 올린다
+// 레벨 계산(selectLevels) 은 GL 을 쓰지 않으므로 메인 스레드가 프레임 패킷을 만들 때 하고, 렌더 스레드는 그 결과로 stream 만 한다
+class TextureStreamer
+{
+	private:
+		// 텍스처를 사용하는 오브젝트 하나, 바운딩 구와 월드 단위 길이 1 에 들어가는 레벨 0 의 텍셀 수를 가진다
+		struct Instance
+		{
+			TextureHandle texture;
+			glm::dvec3 center;
+			float radius;
+			float texelsPerUnit;
+		};
+
+		TextureManager &textures;
+		std::vector<Instance> instances;
+		// 가장 큰 핸들 + 1, selectLevels 가 채우는 배열의 크기
+		size_t textureCount;
+		size_t uploadBudget;
+
+	public:
+		TextureStreamer(TextureManager &textures, size_t uploadBytesPerFrame = DEFAULT_STREAM_UPLOAD_BUDGET);
+
+		// textureWidth 는 레벨 0 의 너비, worldSize 는 텍스처 좌표 0~1 이 월드 공간에서 차지하는 길이 (큐브라면 한 변의 길이)
+		void addInstance(TextureHandle texture, int textureWidth, const glm::dvec3 &center, float radius, float worldSize);
+		void clearInstances();
+		// 텍스처마다 필요한 밉 레벨을 levels[handle] 에 쓴다, levels 는 getTextureCount() 개
+		// 보이는 오브젝트가 없는 텍스처는 INT_MAX 이고, TextureManager 가 가장 작은 상주 레벨로 제한한다
+		void selectLevels(const Camera &camera, int viewportHeight, int *levels) const;
+		// 매 프레임 그리기 전에 렌더 스레드에서 호출, selectLevels 의 결과를 요청하고 업로드 예산 안에서 스트리밍한다
+		void stream(const int *levels, size_t count);
+
+		size_t getTextureCount() const
+		{
+			return (textureCount);
+		}
+
+		// texelsPerUnit 밀도의 텍스처가 distance 만큼 떨어져 있을 때 화면 픽셀 하나에 텍셀 하나가 대응되는 밉 레벨
+		static int requiredMipLevel(float texelsPerUnit, float distance, float fovY, int viewportHeight);
+};
+
+#endif
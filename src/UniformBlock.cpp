@@ -0,0 +1,293 @@
+#include "UniformBlock.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+
+namespace
+{
+	// GLSL 타입에 대응하는 C++ 타입, 행렬은 열(column) 하나의 타입과 열 개수로 표현한다
+	struct TypeInfo
+	{
+		GLenum type;
+		const char *cppType;
+		int size;
+		// std140 에서 배열 원소/행렬 열이 16바이트로 늘어날 때 사용할 타입
+		const char *paddedType;
+		int columns;
+	};
+
+	const TypeInfo TYPE_TABLE[] = {
+		{GL_FLOAT, "float", 4, "glm::vec4", 0},
+		{GL_FLOAT_VEC2, "glm::vec2", 8, "glm::vec4", 0},
+		{GL_FLOAT_VEC3, "glm::vec3", 12, "glm::vec4", 0},
+		{GL_FLOAT_VEC4, "glm::vec4", 16, "glm::vec4", 0},
+		{GL_INT, "int", 4, "glm::ivec4", 0},
+		{GL_INT_VEC2, "glm::ivec2", 8, "glm::ivec4", 0},
+		{GL_INT_VEC3, "glm::ivec3", 12, "glm::ivec4", 0},
+		{GL_INT_VEC4, "glm::ivec4", 16, "glm::ivec4", 0},
+		{GL_UNSIGNED_INT, "unsigned int", 4, "glm::uvec4", 0},
+		{GL_UNSIGNED_INT_VEC2, "glm::uvec2", 8, "glm::uvec4", 0},
+		{GL_UNSIGNED_INT_VEC3, "glm::uvec3", 12, "glm::uvec4", 0},
+		{GL_UNSIGNED_INT_VEC4, "glm::uvec4", 16, "glm::uvec4", 0},
+		// std140 의 bool 은 4바이트 정수
+		{GL_BOOL, "int", 4, "glm::ivec4", 0},
+		{GL_BOOL_VEC2, "glm::ivec2", 8, "glm::ivec4", 0},
+		{GL_BOOL_VEC3, "glm::ivec3", 12, "glm::ivec4", 0},
+		{GL_BOOL_VEC4, "glm::ivec4", 16, "glm::ivec4", 0},
+		{GL_FLOAT_MAT2, "glm::mat2", 16, "glm::vec4", 2},
+		{GL_FLOAT_MAT3, "glm::mat3", 36, "glm::vec4", 3},
+		{GL_FLOAT_MAT4, "glm::mat4", 64, "glm::vec4", 4},
+		{GL_FLOAT_MAT2x3, "glm::mat2x3", 24, "glm::vec4", 2},
+		{GL_FLOAT_MAT2x4, "glm::mat2x4", 32, "glm::vec4", 2},
+		{GL_FLOAT_MAT3x2, "glm::mat3x2", 24, "glm::vec4", 3},
+		{GL_FLOAT_MAT3x4, "glm::mat3x4", 48, "glm::vec4", 3},
+		{GL_FLOAT_MAT4x2, "glm::mat4x2", 32, "glm::vec4", 4},
+		{GL_FLOAT_MAT4x3, "glm::mat4x3", 48, "glm::vec4", 4},
+	};
+
+	const TypeInfo *findType(GLenum type)
+	{
+		for (const TypeInfo &info : TYPE_TABLE)
+		{
+			if (info.type == type)
+			{
+				return (&info);
+			}
+		}
+		return (NULL);
+	}
+
+	// "Block.lights[0].color" 같은 이름을 C++ 식별자로 바꾼다, 배열의 "[0]" 접미사는 배열 선언으로 처리하므로 뗀다
+	std::string memberIdentifier(const std::string &blockName, std::string name)
+	{
+		if (name.compare(0, blockName.size() + 1, blockName + ".") == 0)
+		{
+			name = name.substr(blockName.size() + 1);
+		}
+		if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0)
+		{
+			name = name.substr(0, name.size() - 3);
+		}
+		for (char &c : name)
+		{
+			if (c == '.' || c == '[' || c == ']')
+			{
+				c = '_';
+			}
+		}
+		return (name);
+	}
+
+	// 멤버 하나의 선언을 만든다, C++ 에서 차지하는 크기를 반환하고 지원하지 않는 타입이면 0
+	int declareMember(std::ostringstream &out, const std::string &identifier, const UniformMemberInfo &member)
+	{
+		const TypeInfo *info = findType(member.type);
+		if (info == NULL)
+		{
+			return (0);
+		}
+		int count = std::max(member.arraySize, 1);
+		if (info->columns > 0)
+		{
+			// glm::mat4 만 std140(열 간격 16바이트) 과 배치가 같고, 나머지 행렬은 열마다 vec4 를 사용한다
+			if (member.type == GL_FLOAT_MAT4 && member.matrixStride == 16 && (count == 1 || member.arrayStride == 64))
+			{
+				out << "\t" << info->cppType << " " << identifier;
+				if (member.arraySize > 1)
+				{
+					out << "[" << count << "]";
+				}
+				out << ";\n";
+				return (64 * count);
+			}
+			int columns = info->columns * count;
+			out << "\t" << info->paddedType << " " << identifier << "[" << columns << "]; // " << info->cppType << ", 열마다 " << member.matrixStride << "바이트\n";
+			return (16 * columns);
+		}
+		if (member.arraySize > 1 && member.arrayStride != info->size)
+		{
+			// std140 배열은 원소마다 16바이트를 차지하므로 vec4 로 늘려서 저장한다
+			out << "\t" << info->paddedType << " " << identifier << "[" << count << "]; // " << info->cppType << ", 원소마다 " << member.arrayStride << "바이트\n";
+			return (member.arrayStride * count);
+		}
+		out << "\t" << info->cppType << " " << identifier;
+		if (member.arraySize > 1)
+		{
+			out << "[" << count << "]";
+		}
+		out << ";\n";
+		return (info->size * count);
+	}
+}
+
+std::vector<UniformBlockInfo> reflectUniformBlocks(unsigned int program)
+{
+	std::vector<UniformBlockInfo> blocks;
+	GLint blockCount = 0;
+	glGetProgramiv(program, GL_ACTIVE_UNIFORM_BLOCKS, &blockCount);
+	for (GLint i = 0; i < blockCount; i++)
+	{
+		UniformBlockInfo block;
+		block.index = (unsigned int)i;
+
+		GLint nameLength = 0;
+		glGetActiveUniformBlockiv(program, i, GL_UNIFORM_BLOCK_NAME_LENGTH, &nameLength);
+		std::vector<char> name(std::max(nameLength, 1));
+		glGetActiveUniformBlockName(program, i, (GLsizei)name.size(), NULL, name.data());
+		block.name = name.data();
+		glGetActiveUniformBlockiv(program, i, GL_UNIFORM_BLOCK_DATA_SIZE, &block.dataSize);
+
+		GLint memberCount = 0;
+		glGetActiveUniformBlockiv(program, i, GL_UNIFORM_BLOCK_ACTIVE_UNIFORMS, &memberCount);
+		if (memberCount > 0)
+		{
+			std::vector<GLint> indices(memberCount);
+			glGetActiveUniformBlockiv(program, i, GL_UNIFORM_BLOCK_ACTIVE_UNIFORM_INDICES, indices.data());
+			std::vector<GLuint> uniforms(indices.begin(), indices.end());
+			std::vector<GLint> types(memberCount), sizes(memberCount), offsets(memberCount), arrayStrides(memberCount), matrixStrides(memberCount);
+			glGetActiveUniformsiv(program, memberCount, uniforms.data(), GL_UNIFORM_TYPE, types.data());
+			glGetActiveUniformsiv(program, memberCount, uniforms.data(), GL_UNIFORM_SIZE, sizes.data());
+			glGetActiveUniformsiv(program, memberCount, uniforms.data(), GL_UNIFORM_OFFSET, offsets.data());
+			glGetActiveUniformsiv(program, memberCount, uniforms.data(), GL_UNIFORM_ARRAY_STRIDE, arrayStrides.data());
+			glGetActiveUniformsiv(program, memberCount, uniforms.data(), GL_UNIFORM_MATRIX_STRIDE, matrixStrides.data());
+			for (GLint m = 0; m < memberCount; m++)
+			{
+				GLint memberNameLength = 0;
+				glGetActiveUniformsiv(program, 1, &uniforms[m], GL_UNIFORM_NAME_LENGTH, &memberNameLength);
+				std::vector<char> memberName(std::max(memberNameLength, 1));
+				glGetActiveUniformName(program, uniforms[m], (GLsizei)memberName.size(), NULL, memberName.data());
+
+				UniformMemberInfo member;
+				member.name = memberName.data();
+				member.type = (GLenum)types[m];
+				member.arraySize = sizes[m];
+				member.offset = offsets[m];
+				member.arrayStride = arrayStrides[m];
+				member.matrixStride = matrixStrides[m];
+				block.members.push_back(member);
+			}
+			std::sort(block.members.begin(), block.members.end(), [](const UniformMemberInfo &a, const UniformMemberInfo &b)
+			{
+				return (a.offset < b.offset);
+			});
+		}
+		blocks.push_back(block);
+	}
+	return (blocks);
+}
+
+std::string generateUniformBlockStruct(const UniformBlockInfo &block)
+{
+	std::ostringstream fields;
+	std::ostringstream members;
+	std::ostringstream asserts;
+	int position = 0;
+	int padCount = 0;
+	for (const UniformMemberInfo &member : block.members)
+	{
+		if (member.offset < position)
+		{
+			// 같은 위치에 겹치는 멤버는 C++ 구조체로 표현할 수 없다
+			std::cout << "WARNING::UNIFORM_BLOCK: overlapping member " << block.name << "." << member.name << std::endl;
+			continue;
+		}
+		std::string identifier = memberIdentifier(block.name, member.name);
+		std::ostringstream declaration;
+		int size = declareMember(declaration, identifier, member);
+		if (size == 0)
+		{
+			// 지원하지 않는 타입은 다음 멤버 앞의 패딩으로 채워진다
+			std::cout << "WARNING::UNIFORM_BLOCK: unsupported type 0x" << std::hex << member.type << std::dec << " for " << block.name << "." << member.name << std::endl;
+			continue;
+		}
+		if (member.offset > position)
+		{
+			fields << "\tunsigned char pad" << padCount++ << "[" << (member.offset - position) << "];\n";
+		}
+		fields << declaration.str();
+		position = member.offset + size;
+		members << "\t\t{\"" << member.name << "\", " << member.offset << "},\n";
+		asserts << "static_assert(offsetof(" << block.name << ", " << identifier << ") == " << member.offset << ", \"" << block.name << "::" << identifier << " offset does not match std140\");\n";
+	}
+	if (block.dataSize > position)
+	{
+		fields << "\tunsigned char pad" << padCount++ << "[" << (block.dataSize - position) << "];\n";
+	}
+
+	std::ostringstream out;
+	out << "// uniform block " << block.name << " (" << block.dataSize << " bytes)\n";
+	out << "struct " << block.name << "\n{\n" << fields.str();
+	out << "\n\tstatic constexpr const char *NAME = \"" << block.name << "\";\n";
+	out << "\tstatic constexpr UniformMemberOffset MEMBERS[] = {\n" << members.str() << "\t};\n";
+	out << "};\n";
+	out << asserts.str();
+	out << "static_assert(sizeof(" << block.name << ") == " << block.dataSize << ", \"" << block.name << " size does not match std140\");\n";
+	return (out.str());
+}
+
+bool writeUniformBlockHeader(const std::string &path, const std::vector<UniformBlockInfo> &blocks)
+{
+	std::ostringstream out;
+	out << "// 이 파일은 셰이더의 uniform block 을 조회해서 자동으로 만든 파일이다, 직접 고치지 말고 --generate-uniform-blocks 로 다시 만든다\n";
+	out << "#ifndef UNIFORMBLOCKS_H\n#define UNIFORMBLOCKS_H\n\n";
+	out << "#include \"UniformBlock.h\"\n\n#include <glm/glm.hpp>\n\n#include <cstddef>\n";
+	for (const UniformBlockInfo &block : blocks)
+	{
+		out << "\n" << generateUniformBlockStruct(block);
+	}
+	out << "\n#endif\n";
+
+	std::string content = out.str();
+	std::ifstream existing(path, std::ios::binary);
+	if (existing)
+	{
+		std::string previous((std::istreambuf_iterator<char>(existing)), std::istreambuf_iterator<char>());
+		if (previous == content)
+		{
+			return (true);
+		}
+	}
+	existing.close();
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file)
+	{
+		std::cout << "ERROR::UNIFORM_BLOCK: failed to write " << path << std::endl;
+		return (false);
+	}
+	file << content;
+	return ((bool)file);
+}
+
+bool validateUniformBlock(unsigned int program, const char *blockName, int dataSize, const UniformMemberOffset *members, size_t memberCount)
+{
+	std::vector<UniformBlockInfo> blocks = reflectUniformBlocks(program);
+	for (const UniformBlockInfo &block : blocks)
+	{
+		if (block.name != blockName)
+		{
+			continue;
+		}
+		bool valid = block.dataSize == dataSize;
+		for (const UniformMemberInfo &member : block.members)
+		{
+			const UniformMemberOffset *expected = std::find_if(members, members + memberCount, [&](const UniformMemberOffset &m)
+			{
+				return (member.name == m.name);
+			});
+			if (expected == members + memberCount || (int)expected->offset != member.offset)
+			{
+				valid = false;
+			}
+		}
+		if (!valid)
+		{
+			std::cout << "ERROR::UNIFORM_BLOCK: " << blockName << " layout differs from src/UniformBlocks.h, regenerate it with --generate-uniform-blocks src/UniformBlocks.h and rebuild" << std::endl;
+		}
+		return (valid);
+	}
+	// 셰이더에서 사용하지 않는 블록은 컴파일러가 제거할 수 있으므로 실패로 보지 않는다
+	return (true);
+}
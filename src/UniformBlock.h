@@ -0,0 +1,209 @@
+#ifndef UNIFORMBLOCK_H
+#define UNIFORMBLOCK_H
+
+#include <glad/glad.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+// 블록 멤버 하나의 이름과 std140 오프셋, 생성된 C++ 구조체에 함께 기록되어 실행 중 검증에 사용된다
+struct UniformMemberOffset
+{
+	const char *name;
+	unsigned int offset;
+};
+
+// glGetActiveUniformsiv 로 얻은 블록 멤버 정보
+struct UniformMemberInfo
+{
+	std::string name;
+	GLenum type;
+	int arraySize;
+	int offset;
+	int arrayStride;
+	int matrixStride;
+};
+
+// 활성화된 uniform block 하나의 정보, 멤버는 오프셋 순서로 정렬되어 있다
+struct UniformBlockInfo
+{
+	std::string name;
+	unsigned int index;
+	int dataSize;
+	std::vector<UniformMemberInfo> members;
+};
+
+// 링크된 프로그램의 모든 활성 uniform block 을 조회한다
+std::vector<UniformBlockInfo> reflectUniformBlocks(unsigned int program);
+// 조회한 블록과 같은 메모리 배치를 가지는 C++ 구조체 선언을 만든다
+// 모든 멤버의 오프셋과 전체 크기를 static_assert 로 고정하므로, 구조체를 잘못 고치면 컴파일 에러가 된다
+std::string generateUniformBlockStruct(const UniformBlockInfo &block);
+// 여러 블록의 구조체를 헤더 파일 하나로 저장한다, 내용이 같으면 파일을 건드리지 않는다
+bool writeUniformBlockHeader(const std::string &path, const std::vector<UniformBlockInfo> &blocks);
+// 프로그램의 블록 배치가 생성된 구조체(members)와 같은지 확인한다, 셰이더만 고치고 헤더를 다시 만들지 않은 경우를 잡는다
+// 다르면 잘못된 오프셋에 값을 쓰게 되므로 호출하는 쪽은 false 를 치명적인 에러로 처리한다
+bool validateUniformBlock(unsigned int program, const char *blockName, int dataSize, const UniformMemberOffset *members, size_t memberCount);
+
+template <typename Block>
+bool validateUniformBlock(unsigned int program)
+{
+	return (validateUniformBlock(program, Block::NAME, (int)sizeof(Block), Block::MEMBERS, sizeof(Block::MEMBERS) / sizeof(Block::MEMBERS[0])));
+}
+
+// 생성된 구조체 하나를 담는 uniform buffer, 갱신은 매핑한 버퍼에 직접 쓰거나 memcpy 한 번으로 끝난다
+// persistentMapping 을 켜고 GL 4.4 / ARB_buffer_storage 를 지원하면 버퍼를 한 번만 매핑해두고 RING_SIZE 개 영역을 돌아가며 쓴다
+// 매 프레임 매핑하는 비용이 없으므로 그리기 직전에 값을 써넣는(late latch) 용도에 적합하다
+template <typename Block>
+class UniformBuffer
+{
+	private:
+		// GPU 가 아직 읽고 있는 영역을 덮어쓰지 않도록 나눠 쓰는 영역 수
+		static const int RING_SIZE = 3;
+
+		unsigned int ID;
+		unsigned int binding;
+		// 영구 매핑된 버퍼의 시작 주소, NULL 이면 갱신할 때마다 매핑한다
+		unsigned char *persistent;
+		GLsizeiptr slotStride;
+		int slot;
+		GLsync fences[RING_SIZE];
+		// 매핑에 실패했을 때 beginWrite 가 대신 돌려주는 저장소
+		Block staging;
+		Block *writing;
+
+		void createPersistent()
+		{
+			GLint alignment = 256;
+			glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+			slotStride = (GLsizeiptr)((sizeof(Block) + alignment - 1) / alignment * alignment);
+			GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+			glBufferStorage(GL_UNIFORM_BUFFER, slotStride * RING_SIZE, NULL, flags);
+			persistent = (unsigned char *)glMapBufferRange(GL_UNIFORM_BUFFER, 0, slotStride * RING_SIZE, flags);
+			if (persistent == NULL)
+			{
+				// glBufferStorage 로 만든 버퍼는 크기를 바꿀 수 없으므로 새로 만든다
+				glDeleteBuffers(1, &ID);
+				glGenBuffers(1, &ID);
+				glBindBuffer(GL_UNIFORM_BUFFER, ID);
+			}
+		}
+
+	public:
+		UniformBuffer(unsigned int binding, bool persistentMapping = false) : ID(0), binding(binding), persistent(NULL), slotStride(sizeof(Block)), slot(0), fences(), writing(NULL)
+		{
+			glGenBuffers(1, &ID);
+			glBindBuffer(GL_UNIFORM_BUFFER, ID);
+			if (persistentMapping && (GLAD_GL_VERSION_4_4 || GLAD_GL_ARB_buffer_storage))
+			{
+				createPersistent();
+			}
+			if (persistent == NULL)
+			{
+				slotStride = sizeof(Block);
+				glBufferData(GL_UNIFORM_BUFFER, sizeof(Block), NULL, GL_DYNAMIC_DRAW);
+			}
+			glBindBufferRange(GL_UNIFORM_BUFFER, binding, ID, 0, sizeof(Block));
+		}
+
+		~UniformBuffer()
+		{
+			clear();
+		}
+
+		UniformBuffer(const UniformBuffer &) = delete;
+		UniformBuffer &operator=(const UniformBuffer &) = delete;
+
+		// 버퍼를 삭제한다, GL 컨텍스트가 사라지기 전에 호출
+		void clear()
+		{
+			for (GLsync &fence : fences)
+			{
+				if (fence != NULL)
+				{
+					glDeleteSync(fence);
+					fence = NULL;
+				}
+			}
+			if (ID != 0)
+			{
+				// 매핑된 버퍼는 삭제할 때 함께 해제된다
+				glDeleteBuffers(1, &ID);
+				ID = 0;
+				persistent = NULL;
+			}
+		}
+
+		unsigned int getBinding() const
+		{
+			return (binding);
+		}
+
+		bool isPersistent() const
+		{
+			return (persistent != NULL);
+		}
+
+		// 다음에 쓸 영역을 돌려준다. 영구 매핑이 아니면 쓰기 전용으로 매핑된 메모리이므로 읽으면 안 된다
+		// 영구 매핑이면 그 영역을 읽던 GPU 명령이 끝날 때까지(fence) 기다린다
+		Block *beginWrite()
+		{
+			if (persistent != NULL)
+			{
+				slot = (slot + 1) % RING_SIZE;
+				if (fences[slot] != NULL)
+				{
+					while (glClientWaitSync(fences[slot], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED)
+					{
+					}
+					glDeleteSync(fences[slot]);
+					fences[slot] = NULL;
+				}
+				writing = (Block *)(persistent + slot * slotStride);
+				return (writing);
+			}
+			glBindBuffer(GL_UNIFORM_BUFFER, ID);
+			// 버퍼 전체를 무효화(invalidate)하고 매핑하므로, 이전 프레임이 아직 읽고 있어도 기다리지 않는다
+			writing = (Block *)glMapBufferRange(GL_UNIFORM_BUFFER, 0, sizeof(Block), GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+			if (writing == NULL)
+			{
+				writing = &staging;
+			}
+			return (writing);
+		}
+
+		// beginWrite 로 쓴 영역을 binding 에 연결한다
+		void endWrite()
+		{
+			if (persistent != NULL)
+			{
+				glBindBufferRange(GL_UNIFORM_BUFFER, binding, ID, slot * slotStride, sizeof(Block));
+			}
+			else if (writing == &staging)
+			{
+				glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(Block), &staging);
+			}
+			else
+			{
+				glUnmapBuffer(GL_UNIFORM_BUFFER);
+			}
+			writing = NULL;
+		}
+
+		// 현재 영역을 읽는 그리기 명령을 모두 제출한 뒤 호출한다, 영구 매핑에서 영역을 다시 쓰기 전에 기다릴 fence 를 남긴다
+		void fence()
+		{
+			if (persistent != NULL)
+			{
+				fences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+			}
+		}
+
+		void update(const Block &data)
+		{
+			std::memcpy(beginWrite(), &data, sizeof(Block));
+			endWrite();
+		}
+};
+
+#endif
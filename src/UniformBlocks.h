@@ -0,0 +1,27 @@
+// 이 파일은 셰이더의 uniform block 을 조회해서 자동으로 만든 파일이다, 직접 고치지 말고 --generate-uniform-blocks 로 다시 만든다
+#ifndef UNIFORMBLOCKS_H
+#define UNIFORMBLOCKS_H
+
+#include "UniformBlock.h"
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+
+// uniform block CameraBlock (128 bytes)
+struct CameraBlock
+{
+	glm::mat4 view;
+	glm::mat4 projection;
+
+	static constexpr const char *NAME = "CameraBlock";
+	static constexpr UniformMemberOffset MEMBERS[] = {
+		{"view", 0},
+		{"projection", 64},
+	};
+};
+static_assert(offsetof(CameraBlock, view) == 0, "CameraBlock::view offset does not match std140");
+static_assert(offsetof(CameraBlock, projection) == 64, "CameraBlock::projection offset does not match std140");
+static_assert(sizeof(CameraBlock) == 128, "CameraBlock size does not match std140");
+
+#endif
@@ -0,0 +1,234 @@
+#ifndef VERTEXLAYOUT_H
+#define VERTEXLAYOUT_H
+
+#include <glad/glad.h>
+
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <type_traits>
+#include <utility>
+
+// 정점 속성 하나의 형식, GL 타입 / 성분 수 / 정규화 여부 / 바이트 크기를 컴파일 타임 상수로 가진다
+// normalized 는 정수를 [0,1] 또는 [-1,1] 로 바꿔서 float 로 읽고, integer 는 셰이더에서 ivec/uvec 로 그대로 읽는다
+template <GLenum Type, GLint Components, GLboolean Normalized, std::size_t Size, bool Integer = false>
+struct VertexAttribute
+{
+	static constexpr GLenum type = Type;
+	static constexpr GLint components = Components;
+	static constexpr GLboolean normalized = Normalized;
+	static constexpr std::size_t size = Size;
+	static constexpr bool integer = Integer;
+};
+
+// 실행 중에 비교 / 저장할 수 있는 속성 하나의 형식, 메쉬 캐시 파일이 만들어질 때의 정점 형식을 기록하는 데 쓴다
+struct VertexAttributeFormat
+{
+	unsigned int type;
+	unsigned int components;
+	unsigned int normalized;
+	unsigned int integer;
+	unsigned int offset;
+};
+
+// 정점 구조체 멤버 하나의 offset / 바이트 크기 / 성분 타입 / 성분 수, VERTEX_MEMBER 로 만들어서 VertexLayout::matches 에 넘긴다
+struct VertexMember
+{
+	std::size_t offset;
+	std::size_t size;
+	GLenum type;
+	std::size_t components;
+};
+
+namespace vertex_layout_detail
+{
+	// 멤버의 성분 타입, 배열과 operator[] 가 있는 벡터 타입(glm::vec3 등)은 원소 타입이다
+	template <typename T, typename = void>
+	struct Element
+	{
+		using type = T;
+	};
+
+	template <typename T, std::size_t N>
+	struct Element<T[N], void>
+	{
+		using type = T;
+	};
+
+	template <typename T>
+	struct Element<T, std::enable_if_t<std::is_class<T>::value>>
+	{
+		using type = std::remove_cv_t<std::remove_reference_t<decltype(std::declval<const T &>()[0])>>;
+	};
+
+	template <typename T>
+	constexpr GLenum glType()
+	{
+		return (std::is_same<T, float>::value ? GL_FLOAT
+			: std::is_same<T, signed char>::value ? GL_BYTE
+			: std::is_same<T, unsigned char>::value ? GL_UNSIGNED_BYTE
+			: std::is_same<T, short>::value ? GL_SHORT
+			: std::is_same<T, unsigned short>::value ? GL_UNSIGNED_SHORT
+			: std::is_same<T, int>::value ? GL_INT
+			: std::is_same<T, unsigned int>::value ? GL_UNSIGNED_INT
+			: 0);
+	}
+}
+
+template <typename Member>
+constexpr VertexMember vertexMember(std::size_t offset)
+{
+	using Element = typename vertex_layout_detail::Element<Member>::type;
+	return (VertexMember{offset, sizeof(Member), vertex_layout_detail::glType<Element>(), sizeof(Member) / sizeof(Element)});
+}
+
+// offsetof 는 표준 레이아웃 구조체에서 상수식이므로 static_assert 안에서 쓸 수 있다
+#define VERTEX_MEMBER(Vertex, member) vertexMember<decltype(Vertex::member)>(offsetof(Vertex, member))
+
+// 자주 쓰는 속성 형식, 16비트 / 패킹 형식을 쓰면 정점 크기를 줄여서 대역폭을 아낄 수 있다
+using Position3f = VertexAttribute<GL_FLOAT, 3, GL_FALSE, 3 * sizeof(float)>;
+using Position3h = VertexAttribute<GL_HALF_FLOAT, 3, GL_FALSE, 3 * sizeof(unsigned short)>;
+using Normal3f = VertexAttribute<GL_FLOAT, 3, GL_FALSE, 3 * sizeof(float)>;
+// x, y, z 를 각각 10비트 부호있는 정규화 값으로 32비트 하나에 담는다 (w 는 2비트)
+using Normal10 = VertexAttribute<GL_INT_2_10_10_10_REV, 4, GL_TRUE, sizeof(unsigned int)>;
+using TexCoord2f = VertexAttribute<GL_FLOAT, 2, GL_FALSE, 2 * sizeof(float)>;
+using TexCoord2h = VertexAttribute<GL_HALF_FLOAT, 2, GL_FALSE, 2 * sizeof(unsigned short)>;
+// [0,1] 범위의 텍스처 좌표를 16비트 정규화 정수로 저장한다
+using TexCoord2us = VertexAttribute<GL_UNSIGNED_SHORT, 2, GL_TRUE, 2 * sizeof(unsigned short)>;
+using Color4ub = VertexAttribute<GL_UNSIGNED_BYTE, 4, GL_TRUE, 4 * sizeof(unsigned char)>;
+using BoneIndex4ub = VertexAttribute<GL_UNSIGNED_BYTE, 4, GL_FALSE, 4 * sizeof(unsigned char), true>;
+
+// 템플릿 인자 순서대로 정점 속성이 빈틈없이(interleaved) 배치된 정점 형식
+// 속성 i 는 셰이더의 layout (location = i) 에 연결된다
+// stride 와 각 속성의 offset 은 컴파일 타임에 계산되므로 손으로 계산한 값이 어긋날 일이 없다
+template <typename... Attributes>
+class VertexLayout
+{
+	static_assert(sizeof...(Attributes) > 0, "VertexLayout needs at least one attribute");
+
+	private:
+		static constexpr std::array<std::size_t, sizeof...(Attributes)> computeOffsets()
+		{
+			std::array<std::size_t, sizeof...(Attributes)> result = {};
+			std::size_t sizes[] = {Attributes::size...};
+			std::size_t offset = 0;
+			for (std::size_t i = 0; i < sizeof...(Attributes); i++)
+			{
+				result[i] = offset;
+				offset += sizes[i];
+			}
+			return (result);
+		}
+
+		template <typename Attribute>
+		static void pointer(GLuint location, std::size_t offset)
+		{
+			if (Attribute::integer)
+			{
+				glVertexAttribIPointer(location, Attribute::components, Attribute::type, (GLsizei)stride, (void *)offset);
+			}
+			else
+			{
+				glVertexAttribPointer(location, Attribute::components, Attribute::type, Attribute::normalized, (GLsizei)stride, (void *)offset);
+			}
+			glEnableVertexAttribArray(location);
+		}
+
+		template <typename Attribute>
+		static void format(GLuint location, std::size_t offset, GLuint binding)
+		{
+			if (Attribute::integer)
+			{
+				glVertexAttribIFormat(location, Attribute::components, Attribute::type, (GLuint)offset);
+			}
+			else
+			{
+				glVertexAttribFormat(location, Attribute::components, Attribute::type, Attribute::normalized, (GLuint)offset);
+			}
+			glVertexAttribBinding(location, binding);
+			glEnableVertexAttribArray(location);
+		}
+
+		// 속성과 멤버의 메모리 표현이 같은지 검사한다, half float 는 unsigned short 멤버에, 10_10_10_2 패킹 형식은 32비트 정수 하나에 담는다
+		template <typename Attribute>
+		static constexpr bool sameMember(const VertexMember &member, std::size_t offset)
+		{
+			if (member.offset != offset || member.size != Attribute::size)
+			{
+				return (false);
+			}
+			if (Attribute::type == GL_HALF_FLOAT)
+			{
+				return (member.type == GL_UNSIGNED_SHORT && member.components == (std::size_t)Attribute::components);
+			}
+			if (Attribute::type == GL_INT_2_10_10_10_REV || Attribute::type == GL_UNSIGNED_INT_2_10_10_10_REV)
+			{
+				return ((member.type == GL_INT || member.type == GL_UNSIGNED_INT) && member.components == 1);
+			}
+			return (member.type == Attribute::type && member.components == (std::size_t)Attribute::components);
+		}
+
+		template <std::size_t... I>
+		static constexpr bool sameMembers(const VertexMember *members, std::index_sequence<I...>)
+		{
+			return ((sameMember<Attributes>(members[I], offsets[I]) && ...));
+		}
+
+		template <std::size_t... I>
+		static constexpr std::array<VertexAttributeFormat, sizeof...(Attributes)> describeAll(std::index_sequence<I...>)
+		{
+			return {{VertexAttributeFormat{Attributes::type, (unsigned int)Attributes::components, Attributes::normalized, Attributes::integer, (unsigned int)offsets[I]}...}};
+		}
+
+		template <std::size_t... I>
+		static void applyPointers(GLuint firstLocation, std::index_sequence<I...>)
+		{
+			(pointer<Attributes>(firstLocation + (GLuint)I, offsets[I]), ...);
+		}
+
+		template <std::size_t... I>
+		static void applyFormats(GLuint firstLocation, GLuint binding, std::index_sequence<I...>)
+		{
+			(format<Attributes>(firstLocation + (GLuint)I, offsets[I], binding), ...);
+		}
+
+	public:
+		static constexpr std::size_t attributeCount = sizeof...(Attributes);
+		static constexpr std::size_t stride = (Attributes::size + ...);
+		static constexpr std::array<std::size_t, sizeof...(Attributes)> offsets = computeOffsets();
+
+		// 정점 구조체가 레이아웃과 같은지 검사, static_assert 와 함께 쓰면 어긋난 레이아웃이 컴파일 에러가 된다
+		// members 는 속성 순서대로 VERTEX_MEMBER(Vertex, 멤버) 를 나열한 것이고, 구조체 크기와 속성마다 offset / 타입 / 성분 수를 비교한다
+		template <typename Vertex>
+		static constexpr bool matches(std::initializer_list<VertexMember> members)
+		{
+			return (sizeof(Vertex) == stride && members.size() == attributeCount && sameMembers(members.begin(), std::index_sequence_for<Attributes...>()));
+		}
+
+		// 속성마다 형식과 offset, 캐시 파일에 저장된 형식과 비교할 때 쓴다
+		static constexpr std::array<VertexAttributeFormat, sizeof...(Attributes)> describe()
+		{
+			return (describeAll(std::index_sequence_for<Attributes...>()));
+		}
+
+		// 현재 바인딩된 VAO 와 GL_ARRAY_BUFFER 에 glVertexAttribPointer 로 속성을 설정한다 (GL 3.3)
+		static void apply(GLuint firstLocation = 0)
+		{
+			applyPointers(firstLocation, std::index_sequence_for<Attributes...>());
+		}
+
+		// 현재 바인딩된 VAO 에 glVertexAttribFormat 으로 속성 형식만 설정한다 (GL 4.3 / ARB_vertex_attrib_binding)
+		// 버퍼는 glBindVertexBuffer(binding, buffer, 0, stride) 로 따로 연결하므로 형식을 바꾸지 않고 버퍼만 교체할 수 있다
+		// 지원하지 않으면 아무것도 하지 않고 false 를 반환한다
+		static bool applyFormat(GLuint binding, GLuint firstLocation = 0)
+		{
+			if (!GLAD_GL_VERSION_4_3 && !GLAD_GL_ARB_vertex_attrib_binding)
+			{
+				return (false);
+			}
+			applyFormats(firstLocation, binding, std::index_sequence_for<Attributes...>());
+			return (true);
+		}
+};
+
+#endif
@@ -1,9 +1,36 @@
 #include "Shader.h"
-
-// 이미지 파일을 로드하기 위한 라이브러리
-#include "stb_image.h"
+#include "ShaderLibrary.h"
+#include "Camera.h"
+#include "TextureStreamer.h"
+#include "ImageDecoder.h"
+#include "EmbeddedResources.h"
+#include "VertexLayout.h"
+#include "UniformBlocks.h"
+#include "FixedTimestep.h"
+#include "RenderThread.h"
+#include "InputEvents.h"
+#include "FramePacer.h"
+#include "Bvh.h"
+#include "SpatialBenchmark.h"
+#include "FrameBuilder.h"
+#include "GpuCuller.h"
+#include "StaticBatch.h"
+#include "MeshArena.h"
+#include "Meshlet.h"
+#include "ModelLoader.h"
+#include "MeshCache.h"
+#include "LoaderBenchmark.h"
+#include "DecodeBenchmark.h"
+#include "AllocationCounter.h"
 
 #include <iostream>
+#include <future>
+#include <memory>
+#include <cstdlib>
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include <algorithm>
 // OpenGL 함수들을 로드하는 라이브러리, OpenGL 함수의 포인터를 가져온다
 #include <glad/glad.h>
 // 창 생성 및 입력 처리를 위한 라이브러리
@@ -13,129 +40,319 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
-// 카메라의 위치, 방향, 위쪽 벡터를 정의
-glm::vec3 cameraPos = glm::vec3(0.0f, 0.0f, 3.0f);
-glm::vec3 cameraFront = glm::vec3(0.0f, 0.0f, -1.0f);
-glm::vec3 cameraUp = glm::vec3(0.0f, 1.0f, 0.0f);
+// 카메라의 위치, 방향 벡터, 회전 각도(yaw, pitch), 시야각(Zoom) 은 Camera 클래스가 관리한다
+Camera camera(glm::dvec3(0.0, 0.0, 3.0));
+
+// GLFW 콜백은 시간과 함께 이벤트를 큐에 넣기만 하고, 시뮬레이션 스텝이 시작될 때 그 스텝까지의 이벤트를 꺼내서 처리한다
+InputQueue inputQueue;
+// 시뮬레이션이 본 키 상태, 이벤트를 처리하면서 갱신된다 (glfwGetKey 로 매 프레임 읽지 않는다)
+bool keysDown[GLFW_KEY_LAST + 1];
 
 // 첫 마우스 입력을 처리하기 위한 플래그
 bool firstMouse = true;
-// 카메라의 좌우 회전 각도, 초기값 -90도는 카메라가 오른쪽을 바라본다
-float yaw = -90.0f;
-// 카메라의 상하 회전 각도, 초기값 0도는 카메라가 수평을 바라본다
-float pitch = 0.0f;
 // 마우스의 마지막 위치, 초기값은 당연히 마우스의 초기 위치(화면의 중앙)
 float lastX = WINDOW_WIDTH / 2.0f;
 float lastY = WINDOW_HEIGHT / 2.0f;
 
-float fov = 45.0f;
-
-float deltaTime = 0.0f;
-float lastFrame = 0.0f;
-
-// 창 크기 조정될 때 호출되는 함수, OpenGL 의 뷰포트를 새 창 크기에 맞게 조정
+// 한 변이 1 인 큐브를 감싸는 구의 반지름(대각선의 절반), 회전해도 바운딩 박스가 바뀌지 않는다
+const float CUBE_BOUNDING_RADIUS = 0.87f;
+// 투영 행렬의 근평면 / 원평면, 렌더링과 컬링이 같은 값을 써야 한다
+const float NEAR_PLANE = 0.1f;
+const float FAR_PLANE = 100.0f;
+// late latch 로 그리기 직전에 바뀔 수 있는 카메라 방향의 최대 각도(도)
+// 메인 스레드는 컬링 프러스텀을 이만큼 넓히고, 렌더 스레드는 최신 방향을 패킷 방향에서 이 각도 안으로 제한한다
+const float LATE_LATCH_MAX_ANGLE = 10.0f;
+// 정적 배칭에서 물체를 묶는 격자 한 칸의 크기, 덩어리가 클수록 그리기 호출은 줄고 컬링은 거칠어진다
+const float STATIC_CHUNK_SIZE = 8.0f;
+// --static-batching 일 때 바닥에 까는 움직이지 않는 큐브 수(한 변), 간격
+const int STATIC_FIELD_SIZE = 32;
+const float STATIC_FIELD_SPACING = 1.5f;
+// --lod / --meshlets 일 때 까는 구의 수(한 변) 와 간격, 구 하나는 약 3만 6천 삼각형
+const int SPHERE_FIELD_SIZE = 16;
+const float SPHERE_FIELD_SPACING = 4.0f;
+const float SPHERE_FIELD_RADIUS = 1.0f;
+// --model 로 읽은 모델을 놓는 위치
+const glm::dvec3 MODEL_POSITION(0.0, 0.0, -5.0);
+// 힙 할당 횟수를 셀 때(COUNT_ALLOCATIONS) 제외하는 처음 프레임 수, 배열과 프레임 할당기가 필요한 크기까지 자라는 구간이다
+const unsigned long long ALLOCATION_WARMUP_FRAMES = 120;
+// 왼쪽 마우스 버튼이 눌리면 다음 프레임에서 화면 중앙의 물체를 고른다
+bool pickRequested = false;
+
+// 큐브 정점 형식, 셰이더의 aPos(location 0), aTexCoord(location 1) 와 순서가 같아야 한다
+using CubeLayout = VertexLayout<Position3f, TexCoord2f>;
+// 정점 배열과 모델 로더가 만드는 정점 한 개의 메모리 배치
+struct CubeVertex
+{
+	glm::vec3 position;
+	glm::vec2 texCoord;
+};
+static_assert(CubeLayout::matches<CubeVertex>({VERTEX_MEMBER(CubeVertex, position), VERTEX_MEMBER(CubeVertex, texCoord)}), "CubeVertex does not match CubeLayout");
+// 큐브 한 개의 정점 수, 면 6개 x 삼각형 2개 x 정점 3개
+const size_t CUBE_VERTEX_COUNT = 36;
+// CameraBlock uniform buffer 를 연결할 binding 번호
+const unsigned int CAMERA_BLOCK_BINDING = 0;
+
+// 프레임버퍼 크기, 메인 스레드에는 GL 컨텍스트가 없으므로 크기만 기록하고 뷰포트는 렌더 스레드에서 바꾼다
+int framebufferWidth = WINDOW_WIDTH;
+int framebufferHeight = WINDOW_HEIGHT;
+
+// 창 크기 조정될 때 호출되는 함수, 새 창 크기는 다음 프레임 패킷과 함께 렌더 스레드로 전달된다
 void framebuffer_size_callback(GLFWwindow *window, int width, int height)
 {
-	glViewport(0, 0, width, height);
+	framebufferWidth = width;
+	framebufferHeight = height;
 }
 
-// 키보드 입력을 처리하는 함수. 'ESC' 가 눌리면 창을 닫도록 설정, 'W' 'A' 'S' 'D' 키로 카메라 이동
+// 키보드 입력을 처리하는 함수. 'ESC' 가 눌리면 창을 닫도록 설정, 매 프레임 호출
 void processInput(GLFWwindow *window)
 {
 	if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
 	{
 		glfwSetWindowShouldClose(window, true);
 	}
-	// 프레임 간의 시간 차이에 비례하여 카메라의 이동 속도를 결정
-	float cameraSpeed = static_cast<float>(2.5 * deltaTime);
-	if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+}
+
+// 키 입력을 큐에 넣는다
+void key_callback(GLFWwindow *window, int key, int scancode, int action, int mods)
+{
+	// 큐는 한 프레임 동안 들어오는 이벤트보다 훨씬 크므로, 가득 차서 버려지는 경우는 시뮬레이션이 멈췄을 때뿐이다
+	inputQueue.push({glfwGetTime(), InputEventType::KEY, key, action, 0.0, 0.0});
+}
+
+// 마우스 커서 위치를 큐에 넣는다, 이동 거리 계산은 이벤트를 처리할 때 한다
+void mouse_callback(GLFWwindow *window, double xposin, double yposin)
+{
+	inputQueue.push({glfwGetTime(), InputEventType::MOUSE_MOVE, 0, 0, xposin, yposin});
+}
+
+// 마우스 스크롤을 큐에 넣는다
+void scroll_callback(GLFWwindow *window, double xoffset, double yoffset)
+{
+	inputQueue.push({glfwGetTime(), InputEventType::SCROLL, 0, 0, xoffset, yoffset});
+}
+
+// 마우스 버튼 입력을 큐에 넣는다
+void mouse_button_callback(GLFWwindow *window, int button, int action, int mods)
+{
+	inputQueue.push({glfwGetTime(), InputEventType::MOUSE_BUTTON, button, action, 0.0, 0.0});
+}
+
+// 입력 이벤트 하나를 시뮬레이션 상태에 반영한다, 실시간 입력과 재생 입력 모두 여기를 거친다
+void applyInputEvent(const InputEvent &event)
+{
+	if (event.type == InputEventType::KEY)
 	{
-		// cameraFront(카메라가 바라보는 방향) 에 카메라 속도를 곱한 만큼 앞으로 이동
-		cameraPos += cameraSpeed * cameraFront;
+		if (event.key >= 0 && event.key <= GLFW_KEY_LAST)
+		{
+			keysDown[event.key] = event.action != GLFW_RELEASE;
+		}
 	}
-    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+	else if (event.type == InputEventType::MOUSE_MOVE)
 	{
-		// cameraFront(카메라 바라보는 방향) 에 카메라 속도를 곱한 만큼 뒤로 이동
-        cameraPos -= cameraSpeed * cameraFront;
+		// 처음 마우스 움직임이 감지되면 firstMouse 를 false 로 설정하고, 이후 마우스 움직임을 기반으로 카메라 방향을 조정
+		float xpos = static_cast<float>(event.x);
+		float ypos = static_cast<float>(event.y);
+
+		if (firstMouse)
+		{
+			lastX = xpos;
+			lastY = ypos;
+			firstMouse = false;
+		}
+
+		// 마우스의 x 축 이동거리를 계산
+		float xoffset = xpos - lastX;
+		// 일반적인 좌표에서는 Y축이 아래에서 위로 증가하지만 3D 그래픽스에서는 위에서 아래로 증가하기에 반대로 계산
+		float yoffset = lastY - ypos;
+		lastX = xpos;
+		lastY = ypos;
+
+		// 민감도 적용과 회전, 방향 벡터 계산은 Camera 에서 처리
+		camera.ProcessMouseMovement(xoffset, yoffset);
 	}
-    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+	else if (event.type == InputEventType::SCROLL)
 	{
-		// 카메라가 바라보는 방향과 카메라의 업 방향을 cross product 를 한 뒤, 정규화 해서 카메라의 오른쪽 방향을 구한다
-		// 카메라의 오른쪽 방향에 카메라의 속도를 곱한 만큼 왼쪽으로 이동
-        cameraPos -= glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+		// 마우스 스크롤로 카메라의 시야각(FOV)을 조절
+		camera.ProcessMouseScroll(static_cast<float>(event.y));
 	}
-    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+	else if (event.type == InputEventType::MOUSE_BUTTON)
 	{
-		// 카메라가 바라보는 방향과 카메라의 업 방향을 cross product 를 한 뒤, 정규화 해서 카메라의 오른쪽 방향을 구한다
-		// 카메라의 오른쪽 방향에 카메라의 속도를 곱한 만큼 오른쪽으로 이동
-        cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+		if (event.key == GLFW_MOUSE_BUTTON_LEFT && event.action == GLFW_PRESS)
+		{
+			pickRequested = true;
+		}
 	}
 }
 
-// 마우스 움직임을 처리하여 카메라의 시점을 변경
-// 처음 마우스 움직임이 감지되면 firstMouse 를 false 로 설정하고, 이후 마우스 움직임을 기반으로 'yaw' 와 'pitch' 를 업데이트하여 카메라 방향을 조정
-void mouse_callback(GLFWwindow *window, double xposin, double yposin)
+// 모든 면을 바깥쪽으로 margin(라디안) 만큼 넓힌 투영 행렬, 카메라가 margin 이하로 회전해도 보이는 물체가 모두 안에 들어온다
+// 방향이 margin 이하로 바뀌면 시선 방향도 margin 이하로 움직이므로, 각 면을 눈을 지나는 축으로 margin 만큼 돌리면 충분하다
+glm::mat4 widenedPerspective(float fovY, float aspect, float margin, float zNear, float zFar)
 {
-	float xpos = static_cast<float>(xposin);
-	float ypos = static_cast<float>(yposin);
+	float halfY = fovY * 0.5f;
+	float halfX = std::atan(std::tan(halfY) * aspect);
+	float widenedY = std::min(halfY + margin, glm::radians(89.0f));
+	float widenedX = std::min(halfX + margin, glm::radians(89.0f));
+	return (glm::perspective(2.0f * widenedY, std::tan(widenedX) / std::tan(widenedY), zNear, zFar));
+}
 
-	if (firstMouse)
+// latched 를 reference 에서 최대 maxAngle(라디안) 만큼만 회전한 방향으로 제한한다
+glm::quat limitRotation(const glm::quat &reference, const glm::quat &latched, float maxAngle)
+{
+	// q 와 -q 는 같은 회전이므로 가까운 쪽으로 비교한다
+	float cosHalf = std::min(std::abs(glm::dot(reference, latched)), 1.0f);
+	float angle = 2.0f * std::acos(cosHalf);
+	if (angle <= maxAngle)
 	{
-		lastX = xpos;
-		lastY = ypos;
-		firstMouse = false;
+		return (latched);
 	}
+	return (glm::slerp(reference, latched, maxAngle / angle));
+}
 
-	// 마우스의 x 축 이동거리를 계산
-	float xoffset = xpos - lastX;
-	// 일반적인 좌표에서는 Y축이 아래에서 위로 증가하지만 3D 그래픽스에서는 위에서 아래로 증가하기에 반대로 계산
-	float yoffset = lastY - ypos;
-	lastX = xpos;
-	lastY = ypos;
-
-	// 민감도 설정. 이동거리와 민감도를 곱해서 실제 계산에 쓰일 이동거리로  바꾼다
-	float sensitivity = 0.1f;
-	xoffset *= sensitivity;
-	yoffset *= sensitivity;
-
-	// yaw 와 pitch 를 마우스 이동 거리에 비례하여 업데이트
-	// yaw 는 좌우회전이므로 xoffset, pitch 는 상하회전이므로 yoffset
-	yaw += xoffset;
-	pitch += yoffset;
+// 장면 큐브 index 의 고정된 방향, 물체마다 그리는 경로와 정적 배치가 같은 값을 쓴다
+glm::quat sceneCubeRotation(unsigned int index)
+{
+	return (glm::angleAxis(glm::radians(20.0f * index), glm::normalize(glm::vec3(1.0f, 0.3f, 0.5f))));
+}
 
-	if (pitch > 89.0f)
+// 고정 스텝 하나만큼 시뮬레이션을 진행한다. 'W' 'A' 'S' 'D' 키로 카메라 이동
+// 프레임 레이트와 관계없이 항상 같은 step 으로 호출되므로 결과가 렌더링 속도에 영향을 받지 않는다
+void simulate(float step)
+{
+	// 이동 방향 계산은 Camera::ProcessKeyboard 에서 한다
+	if (keysDown[GLFW_KEY_W])
 	{
-		pitch = 89.0f;
+		camera.ProcessKeyboard(Camera_Movement::FORWARD, step);
 	}
-	if (pitch < -89.0f)
+	if (keysDown[GLFW_KEY_S])
 	{
-		pitch = -89.0f;
+		camera.ProcessKeyboard(Camera_Movement::BACKWARD, step);
 	}
-
-	// 카메라의 새로운 방향을 계산하여 카메라가 바라보는 방향을 업데이트
-	glm::vec3 front;
-	front.x = cos(glm::radians(yaw)) * cos(glm::radians(pitch));
-	front.y = sin(glm::radians(pitch));
-	front.z = sin(glm::radians(yaw)) * cos(glm::radians(pitch)) ;
-	cameraFront = glm::normalize(front);
-}
-
-// 마우스 스크롤을 처리하여 카메라의 시야각(FOV)을 조절
-void scroll_callback(GLFWwindow *window, double xoffset, double yoffset)
-{
-	fov -= (float)yoffset;
-	if (fov < 1.0f)
+	if (keysDown[GLFW_KEY_A])
 	{
-		fov = 1.0f;
+		camera.ProcessKeyboard(Camera_Movement::LEFT, step);
 	}
-	if (fov > 45.0f)
+	if (keysDown[GLFW_KEY_D])
 	{
-		fov = 45.0f;
+		camera.ProcessKeyboard(Camera_Movement::RIGHT, step);
 	}
 }
 
-int main(void)
+int main(int argc, char **argv)
 {
+	// --record <file> : 입력을 시뮬레이션 스텝과 함께 저장한다
+	// --replay <file> : 저장된 입력으로 같은 카메라 경로를 재생하고, 끝나면 종료한다 (벤치마크용)
+	// --late-latch : 카메라 방향을 프레임 패킷이 아니라 그리기 직전에 가장 최신 값으로 가져와서 uniform buffer 에 쓴다
+	const char *recordPath = NULL;
+	const char *replayPath = NULL;
+	bool lateLatch = false;
+	// --no-occlusion-culling : CPU 오클루전 컬링을 끄고 프러스텀 컬링만 한다 (비교용)
+	bool occlusionCulling = true;
+	// --gpu-culling : GL 4.3 이상이면 컴퓨트 셰이더로 프러스텀 / Hi-Z 컬링을 하고 간접 그리기 한 번으로 모든 큐브를 그린다
+	bool gpuCulling = false;
+	// --compare-gpu-culling : --gpu-culling 에 더해 매 프레임 CPU 프러스텀 / 오클루전 컬링도 돌려서, 가끔 GPU 가 남긴 인스턴스 수와 비교해 출력한다 (검증용)
+	bool compareGpuCulling = false;
+	// --static-batching : 움직이지 않는 큐브를 바닥에 깔고, 장면의 큐브와 함께 변환을 정점에 미리 적용해서 덩어리마다 그리기 한 번으로 그린다
+	bool staticBatching = false;
+	// --lod : 삼각형이 많은 구를 깊이 방향으로 늘어놓고, 거리에 따라 단순화된 LOD 단계로 그린다
+	bool lodEnabled = false;
+	// --meshlets : 같은 구를 최고 상세도로 그리되, meshlet 단위로 프러스텀 / 뒷면 컬링해서 보이는 부분만 제출한다
+	bool meshletCulling = false;
+	// --model <file> : OBJ / glTF 바이너리(.glb) 모델을 읽어서 LOD 를 만들고 카메라 앞에 놓는다
+	// 처음 읽은 결과는 mesh_cache/ 에 저장해두고, 원본이 바뀌지 않았으면 다음 실행부터 캐시를 매핑해서 바로 올린다
+	const char *modelPath = NULL;
+	// --generate-uniform-blocks <path> : 셰이더의 uniform block 을 조회해서 std140 C++ 구조체 헤더를 만들고 종료한다
+	// 빌드할 때 UniformBlockLayout.cmake 가 셰이더 소스로 계산한 배치와 헤더를 비교하므로, 블록을 고치면 이것으로 헤더를 다시 만든다
+	const char *uniformBlockHeaderPath = NULL;
+	// --benchmark-bvh : 창을 만들지 않고 BVH 빌드 / 컬링 / picking 시간을 측정한 뒤 종료한다
+	// --benchmark-grid : 창을 만들지 않고 움직이는 물체에서 격자와 BVH 의 갱신 + 질의 시간을 비교한 뒤 종료한다
+	// --benchmark-occlusion : 창을 만들지 않고 빽빽한 장면에서 CPU 오클루전 컬링이 줄이는 그리기 수와 비용을 측정한 뒤 종료한다
+	// --benchmark-loader : 창을 만들지 않고 큰 OBJ / GLB 파일을 만들어서 모델 로더의 처리량을 측정한 뒤 종료한다
+	// --benchmark-decode : 창을 만들지 않고 JPEG / PNG 이미지를 만들어서 이미지 디코더의 처리량을 측정한 뒤 종료한다
+	// --fps <rate> : 프레임 레이트 제한(0 이면 제한 없음), --swap-interval <n> : 수직 동기화 간격
+	double frameRateLimit = FRAME_RATE_LIMIT;
+	int swapInterval = SWAP_INTERVAL;
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+		{
+			recordPath = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+		{
+			replayPath = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--late-latch") == 0)
+		{
+			lateLatch = true;
+		}
+		else if (std::strcmp(argv[i], "--no-occlusion-culling") == 0)
+		{
+			occlusionCulling = false;
+		}
+		else if (std::strcmp(argv[i], "--gpu-culling") == 0)
+		{
+			gpuCulling = true;
+		}
+		else if (std::strcmp(argv[i], "--compare-gpu-culling") == 0)
+		{
+			gpuCulling = true;
+			compareGpuCulling = true;
+		}
+		else if (std::strcmp(argv[i], "--static-batching") == 0)
+		{
+			staticBatching = true;
+		}
+		else if (std::strcmp(argv[i], "--lod") == 0)
+		{
+			lodEnabled = true;
+		}
+		else if (std::strcmp(argv[i], "--meshlets") == 0)
+		{
+			meshletCulling = true;
+		}
+		else if (std::strcmp(argv[i], "--model") == 0 && i + 1 < argc)
+		{
+			modelPath = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--generate-uniform-blocks") == 0 && i + 1 < argc)
+		{
+			uniformBlockHeaderPath = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--fps") == 0 && i + 1 < argc)
+		{
+			frameRateLimit = std::atof(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--swap-interval") == 0 && i + 1 < argc)
+		{
+			swapInterval = std::atoi(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--benchmark-bvh") == 0)
+		{
+			runBvhBenchmark();
+			return (0);
+		}
+		else if (std::strcmp(argv[i], "--benchmark-grid") == 0)
+		{
+			runGridBenchmark();
+			return (0);
+		}
+		else if (std::strcmp(argv[i], "--benchmark-occlusion") == 0)
+		{
+			runOcclusionBenchmark();
+			return (0);
+		}
+		else if (std::strcmp(argv[i], "--benchmark-loader") == 0)
+		{
+			runLoaderBenchmark();
+			return (0);
+		}
+		else if (std::strcmp(argv[i], "--benchmark-decode") == 0)
+		{
+			runDecodeBenchmark();
+			return (0);
+		}
+	}
+
 	// GLFW 라이브러리 초기화
 	glfwInit();
 	// OpenGL 버전 및 프로파일 설정
@@ -163,6 +380,10 @@ int main(void)
 	glfwSetCursorPosCallback(window, mouse_callback);
 	// 마우스 휠 콜백을 설정
 	glfwSetScrollCallback(window, scroll_callback);
+	// 키 입력 콜백을 설정
+	glfwSetKeyCallback(window, key_callback);
+	// 마우스 버튼 콜백을 설정
+	glfwSetMouseButtonCallback(window, mouse_button_callback);
 	// 마우스 커서를 비활성화(숨김), 'GLFW_CURSOR_DISABLE' 모드는 커서를 중앙에 고정시키고 이동 거리를 추적한다
 	glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
 
@@ -173,12 +394,46 @@ int main(void)
 		return (-1);
 	}
 
+	if (gpuCulling && !GpuCuller::isSupported())
+	{
+		std::cout << "GPU culling needs OpenGL 4.3, using CPU culling" << std::endl;
+		gpuCulling = false;
+		compareGpuCulling = false;
+	}
+
 	// 깊이 테스트 활성화
 	// 깊이 테스트는 렌더링할 떄 깊이 버퍼를 사용하여 각 픽셀의 깊이 값을 비교, 더 가까운 픽셀만 렌더링하도록 한다
 	glEnable(GL_DEPTH_TEST);
 
-	// Shader 클래스 인스턴스 생성 및 셰이더 프로그램 로드하고 컴파일
-	Shader ourShader("./shader/shader.vs", "./shader/shader.fs");
+	// 셰이더 파일이 바뀌면 백그라운드 스레드에서 다시 컴파일한다, 실행 중에 셰이더를 고치면 재시작 없이 바로 반영된다
+	ShaderWatcher shaderWatcher(window);
+	// 셰이더 permutation 은 ShaderLibrary 가 처음 요청될 때 전처리(#include, #define)와 컴파일을 하고, 메모리와 디스크에 캐시한다
+	ShaderLibrary shaders(&shaderWatcher);
+	Shader &ourShader = shaders.get("./shader/shader.vs", "./shader/shader.fs");
+	if (uniformBlockHeaderPath != NULL)
+	{
+		bool written = writeUniformBlockHeader(uniformBlockHeaderPath, reflectUniformBlocks(ourShader.ID));
+		shaders.clear();
+		glfwTerminate();
+		return (written ? 0 : -1);
+	}
+	// 셰이더의 블록 배치가 생성된 구조체와 다르면 카메라 행렬이 잘못된 위치에 쓰이므로 실행하지 않는다
+	if (!validateUniformBlock<CameraBlock>(ourShader.ID))
+	{
+		shaders.clear();
+		glfwTerminate();
+		return (-1);
+	}
+	// 지원하면 영구 매핑해서, 매 프레임 매핑하지 않고 그리기 직전에 바로 써넣는다
+	UniformBuffer<CameraBlock> cameraBuffer(CAMERA_BLOCK_BINDING, true);
+	ourShader.bindUniformBlock(CameraBlock::NAME, cameraBuffer.getBinding());
+
+	// 셰이더는 실행 파일에 포함되어 있으므로 기본적으로 파일을 읽지 않는다
+	// LEARNOPENGL_RESOURCE_DIR 로 소스 디렉터리를 지정하면 디스크에서 읽고, 파일이 바뀔 때 다시 컴파일한다
+	if (isResourceDiskOverride())
+	{
+		shaderWatcher.start();
+	}
 
 	// 정점 위치, 텍스처 좌표 설정
 	float vertices[] = {
@@ -225,6 +480,8 @@ int main(void)
 		-0.5f,  0.5f, -0.5f,  0.0f, 1.0f
 	};
 
+	static_assert(sizeof(vertices) == CUBE_VERTEX_COUNT * sizeof(CubeVertex), "vertices does not hold CUBE_VERTEX_COUNT CubeVertex elements");
+
 	// 여러 큐브의 위치(중심좌표)를 정의
 	glm::vec3 cubePositions[] = {
 		glm::vec3( 0.0f,  0.0f,  0.0f),
@@ -249,125 +506,478 @@ int main(void)
 	glBindBuffer(GL_ARRAY_BUFFER, VBO);
 	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
 
-	// 각 정점 속성(위치, 색상, 텍스처 좌표)을 설정
-	// 위치 속성(0번 속성)은 3개의 float 값을 사용하며, vertices 배열의 처음부터 시작한다.
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void *)0);
-	glEnableVertexAttribArray(0);
-
-	// 위치 속성(1번 속성)은 3개의 float 값을 사용하며, vertices 배열의 3번째 값부터 시작한다.
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void *)(3 * sizeof(float)));
-	glEnableVertexAttribArray(1);
-
-	// 텍스처 객체를 생성하고 바인딩
-	unsigned int texture1;
-	unsigned int texture2;
-	glGenTextures(1, &texture1);
-	glBindTexture(GL_TEXTURE_2D, texture1);
+	// 각 정점 속성(위치, 텍스처 좌표)을 설정, stride 와 offset 은 CubeLayout 에서 컴파일 타임에 계산된다
+	CubeLayout::apply();
+
+	// 두 텍스처의 디코딩과 밉맵 생성을 워커 스레드에서 동시에 진행
+	// glGenerateMipmap 대신 CPU 에서 sRGB 를 고려해 만든 밉 체인을 그대로 업로드하므로 드라이버에 따라 품질이 달라지지 않는다
+	std::future<TextureData> containerImport = importTextureAsync("./resources/textures/container.jpg");
+	MipOptions faceOptions;
+	// awesomeface.png 는 투명한 배경을 가지므로 밉 레벨이 내려가도 알파 커버리지를 유지한다
+	faceOptions.preserveAlphaCoverage = true;
+	std::future<TextureData> faceImport = importTextureAsync("./resources/textures/awesomeface.png", faceOptions);
+
+	// 텍스처 객체 생성과 업로드는 GL 컨텍스트가 있는 메인 스레드에서 한다
+	// 텍스처 래핑(GL_REPEAT)과 필터링(트라이리니어) 설정은 uploadTexture 에서 처리
+	// TextureManager 는 GPU 메모리 예산을 넘으면 오래 사용하지 않은 텍스처의 큰 밉부터 내리고, 다시 바인딩될 때 올린다
+	TextureManager textures(DEFAULT_TEXTURE_BUDGET);
+	TextureHandle texture1 = textures.add(containerImport.get());
+	TextureHandle texture2 = textures.add(faceImport.get());
+	// 처음에는 작은 밉만 올라가 있고, 큐브까지의 거리와 화면에 투영된 크기에 맞춰 필요한 밉만 점진적으로 올린다
+	// 큐브는 한 변이 1 이고 각 면에 텍스처 전체가 입혀지므로 worldSize 는 1, 바운딩 구의 반지름은 대각선의 절반
+	TextureStreamer streamer(textures);
+	for (unsigned int i = 0; i < 10; ++i)
+	{
+		streamer.addInstance(texture1, textures.getData(texture1).width, glm::dvec3(cubePositions[i]), CUBE_BOUNDING_RADIUS, 1.0f);
+		streamer.addInstance(texture2, textures.getData(texture2).width, glm::dvec3(cubePositions[i]), CUBE_BOUNDING_RADIUS, 1.0f);
+	}
+	ImageDecoderRegistry::instance().printStats();
 
-	// 텍스처 래핑, S 축과 T 축을 반복한다
-	// 텍스처 래핑은 텍스처 좌표가 0.0 에서 1.0 범위를 벗어날 때 텍스처를 어떻게 적용할지를 정의한다
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-	// 텍스처 필터링, 축소 및 확대 필터를 선형으로 설정한다 (선형필터를 사용하면 픽셀 색상을 계산할 때 주변의 텍셀들의 가중 평균값을 사용하여(선형보간) 텍스처가 부드럽게 보인다)
-	// 텍스처 필터링은 텍스처가 확대 또는 축소될 때 픽셀을 어떻게 보간할지 정의한다
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	ourShader.use();
 
-	int width;
-	int height;
-	int nrChannels;
+	// texture1 샘플러를 텍스처 유닛 0에 연결
+	ourShader.setInt("texture1", 0);
+	// texture2 샘플러를 텍스처 유닛 1에 연결
+	ourShader.setInt("texture2", 1);
 
-	stbi_set_flip_vertically_on_load(true);
-	// stbi_load 함수를 사용하여 이미지 로드, 이미지 파일을 읽어서 메모리에 로드하고 이미지 데이터의 포인터를 반환
-	unsigned char *data = stbi_load("./resources/textures/container.jpg", &width, &height, &nrChannels, 0);
-	if (data)
+	// GPU 컬링 경로: 모델 행렬을 uniform 대신 인스턴스 정점 속성으로 읽는 permutation 과, 큐브 정점 + 인스턴스 버퍼를 묶은 VAO
+	std::unique_ptr<GpuCuller> gpuCuller;
+	Shader *instancedShader = NULL;
+	unsigned int instancedVAO = 0;
+	if (gpuCulling)
 	{
-		// 이미지를 텍스처로 전송
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-		// mipmap(밉맵) 생성
-		glGenerateMipmap(GL_TEXTURE_2D);
+		gpuCuller.reset(new GpuCuller());
+		glGenVertexArrays(1, &instancedVAO);
+		glBindVertexArray(instancedVAO);
+		glBindBuffer(GL_ARRAY_BUFFER, VBO);
+		CubeLayout::apply();
+		gpuCuller->bindInstanceAttributes((GLuint)CubeLayout::attributeCount);
+		glBindVertexArray(0);
+		instancedShader = &shaders.get("./shader/shader.vs", "./shader/shader.fs", {"INSTANCED_MODEL"});
+		instancedShader->use();
+		instancedShader->setInt("texture1", 0);
+		instancedShader->setInt("texture2", 1);
+		instancedShader->bindUniformBlock(CameraBlock::NAME, cameraBuffer.getBinding());
 	}
-	else
+	// 정적 큐브는 큐브 정점을 그대로 복사해서 월드 위치를 적용하고, 머티리얼(텍스처 조합) 이 하나이므로 머티리얼 0 으로 묶는다
+	StaticBatch staticBatch(CubeLayout::stride / sizeof(float), STATIC_CHUNK_SIZE);
+	if (staticBatching)
 	{
-		std::cout << "Failed to load texture" << std::endl;
+		StaticMesh cubeMesh = {vertices, sizeof(vertices) / CubeLayout::stride};
+		for (int z = 0; z < STATIC_FIELD_SIZE; z++)
+		{
+			for (int x = 0; x < STATIC_FIELD_SIZE; x++)
+			{
+				glm::dvec3 position((x - STATIC_FIELD_SIZE / 2) * STATIC_FIELD_SPACING, -5.0, (z - STATIC_FIELD_SIZE / 2) * STATIC_FIELD_SPACING);
+				staticBatch.add(cubeMesh, 0, position, glm::angleAxis(glm::radians(15.0f * (x + z)), glm::vec3(0.0f, 1.0f, 0.0f)));
+			}
+		}
+		// 장면의 큐브 10개도 움직이지 않으므로 같은 배치로 그리고, 물체마다 그리는 경로(BVH / 오클루전 / GPU 컬링) 에는 넣지 않는다
+		for (unsigned int i = 0; i < 10; ++i)
+		{
+			staticBatch.add(cubeMesh, 0, glm::dvec3(cubePositions[i]), sceneCubeRotation(i));
+		}
+		staticBatch.build();
+		staticBatch.upload<CubeLayout>();
+		staticBatch.printStats();
 	}
-	// 이미지 데이터를 메모리에 로드 완료했으므로 해제하여 메모리 누수 방지
-	stbi_image_free(data);
-
-	glGenTextures(1, &texture2);
-	glBindTexture(GL_TEXTURE_2D, texture2);
-
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-	stbi_set_flip_vertically_on_load(true);
-	data = stbi_load("./resources/textures/awesomeface.png", &width, &height, &nrChannels, 0);
-	if (data)
+	// LOD 단계는 메쉬를 추가할 때 만들어서 원본 인덱스 뒤에 이어서 저장한다
+	MeshArena meshArena(CubeLayout::stride / sizeof(float));
+	// 메쉬 아레나의 메쉬로 그리는 물체, --lod 의 구와 --model 로 읽은 모델
+	std::vector<MeshInstance> meshInstances;
+	std::vector<glm::dvec3> sphereField;
+	MeshletMesh sphereMeshlets(CubeLayout::stride / sizeof(float));
+	if (lodEnabled || meshletCulling)
+	{
+		MeshData sphere = generateSphereMesh(SPHERE_FIELD_RADIUS, 96, 192);
+		for (int z = 0; z < SPHERE_FIELD_SIZE; z++)
+		{
+			for (int x = 0; x < SPHERE_FIELD_SIZE; x++)
+			{
+				sphereField.push_back(glm::dvec3((x - SPHERE_FIELD_SIZE / 2) * SPHERE_FIELD_SPACING, 0.0, -5.0 - z * SPHERE_FIELD_SPACING));
+			}
+		}
+		if (meshletCulling)
+		{
+			sphereMeshlets.build(sphere);
+			sphereMeshlets.upload<CubeLayout>();
+			sphereMeshlets.printStats();
+		}
+		else
+		{
+			unsigned int sphereMesh = meshArena.add(sphere);
+			for (const glm::dvec3 &position : sphereField)
+			{
+				meshInstances.push_back({sphereMesh, position, 0});
+			}
+		}
+	}
+	// 캐시에서 읽은 모델은 매핑한 메모리를 그대로 올리므로 upload 가 끝날 때까지 유지한다
+	CachedMesh cachedModel;
+	if (modelPath != NULL)
 	{
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-		glGenerateMipmap(GL_TEXTURE_2D);
+		MeshCache meshCache;
+		double loadStart = glfwGetTime();
+		if (meshCache.load<CubeLayout>(modelPath, cachedModel))
+		{
+			std::cout << "Loaded " << modelPath << " from mesh cache: " << cachedModel.view.lods[0].indexCount / 3 << " triangles in " << (glfwGetTime() - loadStart) * 1000.0 << " ms" << std::endl;
+			meshInstances.push_back({meshArena.add(cachedModel.view), MODEL_POSITION, 0});
+		}
+		else
+		{
+			// 파일을 매핑해서 바로 정점 / 인덱스 배열로 읽는다, OBJ 는 코어 수만큼의 스레드로 나눠서 파싱한다
+			MeshData model;
+			if (loadModel(modelPath, model))
+			{
+				std::cout << "Loaded " << modelPath << ": " << model.indices.size() / 3 << " triangles in " << (glfwGetTime() - loadStart) * 1000.0 << " ms" << std::endl;
+				unsigned int modelMesh = meshArena.add(model);
+				meshInstances.push_back({modelMesh, MODEL_POSITION, 0});
+				meshCache.store<CubeLayout>(modelPath, meshArena.getView(modelMesh));
+			}
+		}
 	}
-	else
+	if (!meshInstances.empty())
 	{
-		std::cout << "Failed to load texture" << std::endl;
+		meshArena.upload<CubeLayout>();
+		meshArena.printStats();
+	}
+	// GPU 가 남긴 인스턴스 수를 CPU 컬링 결과와 비교한다, 읽어올 때 GPU 를 기다리므로 가끔만 확인한다
+	const unsigned long long GPU_CULLING_SAMPLE_INTERVAL = 120;
+	unsigned long long gpuVisibleSum = 0;
+	unsigned long long cpuVisibleSum = 0;
+	unsigned long long gpuCullingSamples = 0;
+
+	// 시뮬레이션 상태는 이전/현재 두 벌을 유지하고, 렌더링할 때 남은 시간 비율로 보간한다
+	// 정적 배칭을 켜면 장면의 큐브는 배치가 그리므로 물체마다 그리는 큐브는 없다
+	std::vector<Transform> currentCubes(staticBatching ? 0 : 10);
+	for (unsigned int i = 0; i < currentCubes.size(); ++i)
+	{
+		currentCubes[i].position = glm::dvec3(cubePositions[i]);
+		currentCubes[i].rotation = sceneCubeRotation(i);
+	}
+	std::vector<Transform> previousCubes = currentCubes;
+	// 큐브는 움직이지 않으므로 BVH 는 한 번만 만든다, 물체가 움직이면 매 프레임 refit 한다
+	// picking 은 배치로 그리는 큐브도 고를 수 있게 항상 장면의 큐브 10개로 만들고, 컬링은 currentCubes 가 있을 때만 한다
+	std::vector<Aabb> cubeBounds(10);
+	for (size_t i = 0; i < cubeBounds.size(); ++i)
+	{
+		cubeBounds[i] = sphereBounds(cubePositions[i], CUBE_BOUNDING_RADIUS);
+	}
+	Bvh sceneBvh;
+	sceneBvh.build(cubeBounds);
+
+	// 패킷을 채우는 데 필요한 장면, 프러스텀을 통과한 큐브 중 가까운 것을 가리개로 그리고 가려진 큐브는 패킷에 넣지 않는다
+	// 가리개 모양은 큐브 정점 위치 그대로 사용한다
+	FrameScene scene;
+	scene.previousCubes = &previousCubes;
+	scene.currentCubes = &currentCubes;
+	scene.cubeBvh = &sceneBvh;
+	scene.cubeRadius = CUBE_BOUNDING_RADIUS;
+	for (size_t i = 0; i < sizeof(vertices) / sizeof(float); i += CubeLayout::stride / sizeof(float))
+	{
+		scene.cubeOccluder.push_back(glm::vec3(vertices[i], vertices[i + 1], vertices[i + 2]));
+	}
+	scene.staticBatch = &staticBatch;
+	scene.meshArena = &meshArena;
+	scene.meshInstances = &meshInstances;
+	if (meshletCulling)
+	{
+		scene.meshlets = &sphereMeshlets;
+		scene.meshletPositions = &sphereField;
+		scene.meshletRadius = SPHERE_FIELD_RADIUS;
+	}
+	scene.streamer = &streamer;
+	scene.screenHeight = WINDOW_HEIGHT;
+	scene.occlusionCulling = occlusionCulling;
+	scene.gpuCulling = gpuCulling;
+	scene.compareGpuCulling = compareGpuCulling;
+	FrameBuilder frameBuilder(scene);
+	glm::dvec3 previousCameraPosition = camera.Position;
+	FixedTimestep timestep(SIMULATION_HZ);
+	uint64_t simulationStep = 0;
+
+	InputRecorder recorder;
+	InputReplay replay;
+	if (recordPath != NULL)
+	{
+		recorder.open(recordPath, timestep.getStep());
+	}
+	if (replayPath != NULL)
+	{
+		replay.load(replayPath, timestep.getStep());
 	}
-	stbi_image_free(data);
-
-	ourShader.use();
-
-	// texture1 샘플러를 텍스처 유닛 0에 연결
-	ourShader.setInt("texture1", 0);
-	// texture2 샘플러를 텍스처 유닛 1에 연결
-	ourShader.setInt("texture2", 1);
 
-	while (!glfwWindowShouldClose(window))
+	// 여기부터 GL 호출은 렌더 스레드에서만 한다
+	// 메인 스레드는 이벤트 처리와 시뮬레이션을 하고 프레임 패킷을 만들어 넘긴다
+	RenderThread renderThread(window);
+	renderThread.setSwapInterval(swapInterval);
+	CameraLatch cameraLatch;
+	int viewportWidth = WINDOW_WIDTH;
+	int viewportHeight = WINDOW_HEIGHT;
+	// 준비 구간이 지난 프레임에서 스레드별로 센 힙 할당 횟수
+	unsigned long long mainAllocations = 0;
+	unsigned long long renderAllocations = 0;
+	unsigned long long countedFrames = 0;
+	renderThread.start([&](const FramePacket &frame)
 	{
-		float currentFrame = static_cast<float>(glfwGetTime());
-		deltaTime = currentFrame - lastFrame;
-		lastFrame = currentFrame;
+		unsigned long long allocationStart = getThreadAllocationCount();
+		if (frame.viewportWidth != viewportWidth || frame.viewportHeight != viewportHeight)
+		{
+			viewportWidth = frame.viewportWidth;
+			viewportHeight = frame.viewportHeight;
+			glViewport(0, 0, viewportWidth, viewportHeight);
+		}
 
-		processInput(window);
+		// 다시 컴파일된 셰이더가 있으면 프레임 사이에 교체, 새 프로그램은 uniform 이 초기화되어 있으므로 샘플러를 다시 연결한다
+		// GPU 컬링을 해도 정적 배칭 / 메쉬 / meshlet 은 ourShader 로 그리므로, 이 프레임이 쓰는 프로그램을 모두 교체한다
+		Shader *drawShaders[] = {&ourShader, instancedShader};
+		for (Shader *drawShader : drawShaders)
+		{
+			if (drawShader == NULL || !drawShader->applyPendingReload())
+			{
+				continue;
+			}
+			drawShader->use();
+			drawShader->setInt("texture1", 0);
+			drawShader->setInt("texture2", 1);
+			drawShader->bindUniformBlock(CameraBlock::NAME, cameraBuffer.getBinding());
+			// 다시 컴파일한 셰이더의 블록 배치가 바뀌었으면 헤더를 다시 만들어서 빌드해야 하므로 종료한다
+			if (!validateUniformBlock<CameraBlock>(drawShader->ID))
+			{
+				glfwSetWindowShouldClose(window, true);
+			}
+		}
+
+		streamer.stream(frame.textureLevels.data(), frame.textureLevels.size());
 
 		glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
 		// 텍스처 유닛 0(TEXTURE0) 활성화, TEXTURE0 에 texture1 바인딩 
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, texture1);
+		textures.bind(texture1, 0);
 		// 텍스처 유닛 1(TEXTURE1) 활성화, TEXTURE1 에 texture2 바인딩
-		glActiveTexture(GL_TEXTURE1);
-		glBindTexture(GL_TEXTURE_2D, texture2);
+		textures.bind(texture2, 1);
 		// 텍스처 유닛(TEXTURE0 1 2 ...)은 GPU 에서 텍스처를 처리하기 위한 슬롯이다, 셰이더에서는 텍스처 샘플러 변수(sampler2D) 를 통해 텍스처 유닛을 참조한다
 
-		ourShader.use();
+		// 카메라 행렬은 그리기 직전에 매핑된 uniform buffer 에 직접 쓴다
+		// late latch 모드에서는 이 시점에 메인 스레드가 올려둔 가장 최신 방향을 사용한다
+		// 패킷의 물체는 LATE_LATCH_MAX_ANGLE 만큼 넓힌 프러스텀으로 컬링되었으므로, 그 안에서만 방향을 바꿔서 컬링된 물체가 화면에 들어오지 않게 한다
+		Camera view = frame.camera;
+		double inputTime = frame.inputTime;
+		glm::quat latched;
+		if (lateLatch && cameraLatch.consume(latched, inputTime))
+		{
+			view.Orientation = limitRotation(frame.camera.Orientation, latched, glm::radians(LATE_LATCH_MAX_ANGLE));
+		}
+		glm::mat4 viewMatrix = view.GetViewMatix();
+		glm::mat4 projection = glm::perspective(glm::radians(view.Zoom), (float)WINDOW_WIDTH / (float)WINDOW_HEIGHT, NEAR_PLANE, FAR_PLANE);
+		CameraBlock *cameraBlock = cameraBuffer.beginWrite();
+		cameraBlock->view = viewMatrix;
+		cameraBlock->projection = projection;
+		cameraBuffer.endWrite();
+
+		if (gpuCulling)
+		{
+			// 컬링과 그리기 명령 생성은 GPU 에서 하고, CPU 는 큐브 수와 관계없이 그리기를 한 번만 호출한다
+			gpuCuller->cull(frame.models.data(), frame.models.size(), CUBE_BOUNDING_RADIUS, projection, viewMatrix, frame.camera.Position, (GLuint)CUBE_VERTEX_COUNT);
+			instancedShader->use();
+			glBindVertexArray(instancedVAO);
+			gpuCuller->draw();
+			if (compareGpuCulling && frame.frameIndex % GPU_CULLING_SAMPLE_INTERVAL == 0)
+			{
+				gpuVisibleSum += gpuCuller->readVisibleCount();
+				cpuVisibleSum += frame.cpuVisibleCount;
+				gpuCullingSamples++;
+			}
+		}
+		else
+		{
+			ourShader.use();
+			glBindVertexArray(VAO);
+			for (const glm::mat4 &model : frame.models)
+			{
+				ourShader.setMat4("model", model);
+				glDrawArrays(GL_TRIANGLES, 0, (GLsizei)CUBE_VERTEX_COUNT);
+			}
+		}
+		if (!frame.staticDraws.empty())
+		{
+			// 정적 덩어리의 모델 행렬은 카메라 기준 이동뿐이다
+			ourShader.use();
+			staticBatch.bind();
+			for (const StaticBatchDraw &batch : frame.staticDraws)
+			{
+				ourShader.setMat4("model", batch.model);
+				staticBatch.draw(batch);
+			}
+		}
+		if (!frame.meshDraws.empty())
+		{
+			ourShader.use();
+			meshArena.bind();
+			for (const MeshDraw &draw : frame.meshDraws)
+			{
+				ourShader.setMat4("model", draw.model);
+				meshArena.draw(draw);
+			}
+		}
+		if (!frame.meshletDraws.empty())
+		{
+			ourShader.use();
+			sphereMeshlets.bind();
+			for (const MeshletDraw &draw : frame.meshletDraws)
+			{
+				ourShader.setMat4("model", draw.model);
+				sphereMeshlets.draw(&frame.meshletRanges[draw.firstRange], draw.rangeCount);
+			}
+		}
+		cameraBuffer.fence();
+		if (gpuCulling)
+		{
+			// 다음 프레임의 오클루전 검사에 쓸 깊이 피라미드를 이번 프레임의 깊이로 만든다
+			gpuCuller->buildDepthPyramid(viewportWidth, viewportHeight, projection * viewMatrix, frame.camera.Position);
+		}
+
+		textures.endFrame();
+		if (frame.frameIndex >= ALLOCATION_WARMUP_FRAMES)
+		{
+			renderAllocations += getThreadAllocationCount() - allocationStart;
+		}
+		return (inputTime);
+	});
+
+	double lastFrame = glfwGetTime();
+	unsigned long long frameIndex = 0;
+	// 아직 어느 프레임에도 넘기지 않은 입력 중 가장 오래된 것의 시간, 지연 시간 측정에 사용한다
+	double pendingInputTime = 0.0;
+	// 프레임 시작 간격을 일정하게 맞춘다, 기다리는 동안 잠들어 있으므로 GPU 가 한가할 때 CPU 를 태우지 않는다
+	// 입력을 읽기 전에 기다려야 기다린 시간만큼 입력 지연이 늘어나지 않는다
+	FramePacer pacer(frameRateLimit);
+	while (!glfwWindowShouldClose(window))
+	{
+		unsigned long long allocationStart = getThreadAllocationCount();
+		pacer.wait();
+		glfwPollEvents();
+
+		double currentFrame = glfwGetTime();
+		double frameTime = currentFrame - lastFrame;
+		lastFrame = currentFrame;
 
-		glm::mat4 projection = glm::perspective(glm::radians(fov), (float)WINDOW_WIDTH / (float)WINDOW_HEIGHT, 0.1f, 100.0f);
-		ourShader.setMat4("projection", projection);
+		processInput(window);
 
-		glm::mat4 view = glm::lookAt(cameraPos, cameraPos + cameraFront, cameraUp);
-		ourShader.setMat4("view", view);
+		int steps = timestep.advance(frameTime);
+		for (int step = 0; step < steps; step++)
+		{
+			// 이 스텝이 끝나는 실제 시간, 그 전에 들어온 이벤트만 이 스텝에서 처리한다
+			double stepEnd = currentFrame - (timestep.getAlpha() + (steps - 1 - step)) * timestep.getStep();
+			const InputEvent *event;
+			while ((event = inputQueue.front()) != NULL && (replay.isLoaded() || event->time <= stepEnd))
+			{
+				// 재생 중에는 실시간 입력을 버린다
+				if (!replay.isLoaded())
+				{
+					recorder.record(simulationStep, *event);
+					applyInputEvent(*event);
+					if (pendingInputTime == 0.0)
+					{
+						pendingInputTime = event->time;
+					}
+				}
+				inputQueue.pop();
+			}
+			InputEvent replayed;
+			while (replay.poll(simulationStep, replayed))
+			{
+				applyInputEvent(replayed);
+			}
+
+			previousCubes = currentCubes;
+			previousCameraPosition = camera.Position;
+			simulate((float)timestep.getStep());
+			simulationStep++;
+		}
+		if (replay.isLoaded() && replay.finished(simulationStep))
+		{
+			glfwSetWindowShouldClose(window, true);
+		}
+		// late latch 모드에서는 패킷을 기다리기 전에 최신 방향을 올려두어, 지금 그리고 있는 이전 프레임이 가져갈 수 있게 한다
+		if (lateLatch)
+		{
+			cameraLatch.publish(camera.Orientation, pendingInputTime);
+			pendingInputTime = 0.0;
+		}
 
-		glBindVertexArray(VAO);
-		for (unsigned int i = 0; i < 10; ++i)
+		// 렌더 스레드가 두 프레임 전의 패킷을 다 읽을 때까지 기다렸다가 채운다
+		// 패킷의 배열과 이 프레임의 임시 배열은 패킷의 프레임 할당기에 잡으므로 정상 상태에서는 malloc 이 없다
+		FramePacket &frame = renderThread.beginFrame();
+		frame.frameIndex = frameIndex++;
+		frame.inputTime = pendingInputTime;
+		pendingInputTime = 0.0;
+		frame.viewportWidth = framebufferWidth;
+		frame.viewportHeight = framebufferHeight;
+		// 위치는 보간하고, 마우스로 바꾸는 방향은 입력이 들어올 때 바로 반영되므로 보간하지 않는다
+		float alpha = timestep.getAlpha();
+		frame.camera = camera;
+		frame.camera.Position = previousCameraPosition + (camera.Position - previousCameraPosition) * (double)alpha;
+
+		// 화면 중앙(카메라 정면) 으로 광선을 쏘아 가장 가까운 큐브를 고른다
+		if (pickRequested)
 		{
-			glm::mat4 model = glm::mat4(1.0f);
-			model = glm::translate(model, cubePositions[i]);
-			float angle = 20.0f * i;
-			model = glm::rotate(model, glm::radians(angle), glm::vec3(1.0f, 0.3f, 0.5f));
-			ourShader.setMat4("model", model);
+			pickRequested = false;
+			uint32_t picked;
+			float distance;
+			if (sceneBvh.raycast(Ray(glm::vec3(frame.camera.Position), frame.camera.Front), FAR_PLANE, picked, distance))
+			{
+				std::cout << "Picked cube " << picked << " at distance " << distance << std::endl;
+			}
+		}
 
-			glDrawArrays(GL_TRIANGLES, 0, 36);
+		// 보이는 물체만 패킷에 넣는다
+		// late latch 모드에서는 렌더 스레드가 그릴 때 방향이 바뀔 수 있으므로 바뀔 수 있는 최대 각도만큼 넓힌 프러스텀으로 컬링한다
+		float aspect = (float)WINDOW_WIDTH / (float)WINDOW_HEIGHT;
+		glm::mat4 projection = lateLatch ? widenedPerspective(glm::radians(frame.camera.Zoom), aspect, glm::radians(LATE_LATCH_MAX_ANGLE), NEAR_PLANE, FAR_PLANE)
+			: glm::perspective(glm::radians(frame.camera.Zoom), aspect, NEAR_PLANE, FAR_PLANE);
+		frameBuilder.build(frame, projection, alpha);
+		renderThread.submit();
+		if (frameIndex > ALLOCATION_WARMUP_FRAMES)
+		{
+			mainAllocations += getThreadAllocationCount() - allocationStart;
+			countedFrames++;
 		}
+	}
 
-		glfwSwapBuffers(window);
-		glfwPollEvents();
+	// 렌더 스레드를 멈추면 GL 컨텍스트가 메인 스레드로 돌아오므로 이후 정리는 메인 스레드에서 한다
+	renderThread.stop();
+	renderThread.printStats();
+	pacer.printStats();
+	if (isAllocationCountingEnabled() && countedFrames > 0)
+	{
+		std::cout << "Heap allocations after " << ALLOCATION_WARMUP_FRAMES << " warmup frames: main thread " << (double)mainAllocations / countedFrames << " per frame, render thread " << (double)renderAllocations / countedFrames << " per frame" << std::endl;
 	}
+	frameBuilder.printStats();
+	if (gpuCullingSamples > 0)
+	{
+		std::cout << "GPU culling: " << (double)gpuVisibleSum / gpuCullingSamples << " instances drawn on average, CPU culling would draw " << (double)cpuVisibleSum / gpuCullingSamples << std::endl;
+	}
+	recorder.close(simulationStep);
 
 	glDeleteVertexArrays(1, &VAO);
+	if (instancedVAO != 0)
+	{
+		glDeleteVertexArrays(1, &instancedVAO);
+	}
+	if (gpuCuller)
+	{
+		gpuCuller->clear();
+	}
 	glDeleteBuffers(1, &VBO);
+	staticBatch.clear();
+	meshArena.clear();
+	sphereMeshlets.clear();
+	textures.clear();
+	cameraBuffer.clear();
+	shaderWatcher.stop();
+	shaders.clear();
 
 	glfwTerminate();
 
@@ -0,0 +1,209 @@
+#include "AllocationCounter.h"
+#include "EmbeddedResources.h"
+#include "FrameBuilder.h"
+#include "FramePacket.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+// main.cpp 의 프레임 루프가 패킷을 채우는 경로(FrameBuilder::build) 가 정상 상태에서 힙을 쓰지 않는지 확인한다 (COUNT_ALLOCATIONS 로 빌드)
+// 창 없이 main 과 같은 종류의 장면(큐브 BVH + 오클루전, 정적 배치, LOD 메쉬, meshlet, 텍스처 스트리밍) 을 만들고,
+// 카메라가 장면 앞에서 같은 경로를 되풀이하는 동안 두 패킷을 번갈아 채운다. 준비 구간에서 경로를 두 바퀴 돈 뒤에는 operator new 와 malloc 이 한 번도 불리지 않아야 한다
+// GL 함수는 부르지 않는다 (버퍼를 upload 하지 않고, 텍스처도 추가하지 않는다)
+
+// 리소스는 읽지 않는다
+const EmbeddedResource EMBEDDED_RESOURCES[1] = {};
+const size_t EMBEDDED_RESOURCE_COUNT = 0;
+
+namespace
+{
+	// RenderThread 와 같은 구성
+	const unsigned int PACKET_COUNT = 2;
+	const size_t FRAME_ARENA_SIZE = 256 * 1024;
+	// 카메라가 경로를 한 바퀴 도는 프레임 수, 준비 구간은 두 바퀴라서 두 패킷이 모두 경로의 모든 프레임을 한 번씩 지나간다
+	const unsigned long long ORBIT_FRAMES = 60;
+	const unsigned long long WARMUP_FRAMES = ORBIT_FRAMES * PACKET_COUNT;
+	const unsigned long long MEASURED_FRAMES = 1000;
+	// main.cpp 와 같은 투영과 큐브 크기
+	const int SCREEN_WIDTH = 1600;
+	const int SCREEN_HEIGHT = 900;
+	const float CUBE_BOUNDING_RADIUS = 0.87f;
+	// 큐브 격자(한 변), 정적 배치 바닥(한 변), 구 격자(한 변)
+	const int CUBE_GRID_SIZE = 12;
+	const int STATIC_FIELD_SIZE = 32;
+	const int SPHERE_FIELD_SIZE = 4;
+	const float SPHERE_RADIUS = 1.0f;
+	const size_t FLOATS_PER_VERTEX = 5;
+
+	// 컴파일러가 할당과 해제를 함께 없애지 못하게 결과를 남겨둔다
+	void *volatile sink;
+
+	// 위치 3개 + 텍스처 좌표 2개인 큐브 정점, 삼각형 12개
+	void makeCube(std::vector<float> &vertices)
+	{
+		const float corners[8][3] = {{-0.5f, -0.5f, -0.5f}, {0.5f, -0.5f, -0.5f}, {0.5f, 0.5f, -0.5f}, {-0.5f, 0.5f, -0.5f}, {-0.5f, -0.5f, 0.5f}, {0.5f, -0.5f, 0.5f}, {0.5f, 0.5f, 0.5f}, {-0.5f, 0.5f, 0.5f}};
+		const int faces[6][4] = {{0, 1, 2, 3}, {4, 5, 6, 7}, {0, 4, 7, 3}, {1, 5, 6, 2}, {0, 1, 5, 4}, {3, 2, 6, 7}};
+		const int order[6] = {0, 1, 2, 2, 3, 0};
+		const float uv[4][2] = {{0.0f, 0.0f}, {1.0f, 0.0f}, {1.0f, 1.0f}, {0.0f, 1.0f}};
+		for (const int *face : faces)
+		{
+			for (int corner : order)
+			{
+				vertices.insert(vertices.end(), corners[face[corner]], corners[face[corner]] + 3);
+				vertices.insert(vertices.end(), uv[corner], uv[corner] + 2);
+			}
+		}
+	}
+
+	// frameIndex 번째 프레임의 카메라, -Z 를 바라본 채로 ORBIT_FRAMES 마다 장면 앞을 옆으로, 앞뒤로 한 바퀴 돈다
+	// 물체가 화면 가장자리로 들어오고 나가며, 구까지의 거리가 바뀌어서 LOD 단계도 바뀐다
+	Camera orbitCamera(unsigned long long frameIndex)
+	{
+		float angle = glm::radians(360.0f * (float)(frameIndex % ORBIT_FRAMES) / ORBIT_FRAMES);
+		glm::dvec3 position(std::sin(angle) * 20.0, 4.0, 25.0 + std::cos(angle) * 15.0);
+		return (Camera(position, glm::vec3(0.0f, 1.0f, 0.0f), -90.0f, -5.0f));
+	}
+}
+
+int main()
+{
+	if (!isAllocationCountingEnabled())
+	{
+		std::cout << "FAIL allocation counting is not enabled, build with COUNT_ALLOCATIONS" << std::endl;
+		return (1);
+	}
+	// 카운터가 operator new 와 malloc 을 모두 보고 있는지 먼저 확인한다
+	unsigned long long before = getThreadAllocationCount();
+	sink = new int(1);
+	delete (int *)sink;
+	bool newCounted = getThreadAllocationCount() > before;
+	before = getThreadAllocationCount();
+	sink = std::malloc(64);
+	std::free(sink);
+	bool mallocCounted = getThreadAllocationCount() > before;
+	std::cout << (newCounted ? "PASS " : "FAIL ") << "operator new is counted" << std::endl;
+	std::cout << (mallocCounted ? "PASS " : "FAIL ") << "malloc is counted" << std::endl;
+#if defined(__GLIBC__)
+	if (!mallocCounted)
+	{
+		return (1);
+	}
+#endif
+	if (!newCounted)
+	{
+		return (1);
+	}
+
+	// 장면, main.cpp 처럼 CPU 데이터만 만들고 GL 버퍼는 올리지 않는다
+	std::vector<float> cubeVertices;
+	makeCube(cubeVertices);
+	std::vector<Transform> currentCubes;
+	std::vector<Aabb> cubeBounds;
+	for (int z = 0; z < CUBE_GRID_SIZE; z++)
+	{
+		for (int y = 0; y < CUBE_GRID_SIZE / 4; y++)
+		{
+			for (int x = 0; x < CUBE_GRID_SIZE; x++)
+			{
+				Transform cube;
+				cube.position = glm::dvec3((x - CUBE_GRID_SIZE / 2) * 2.0, y * 2.0, (z - CUBE_GRID_SIZE / 2) * 2.0);
+				cube.rotation = glm::angleAxis(glm::radians(10.0f * (x + y + z)), glm::vec3(0.0f, 1.0f, 0.0f));
+				currentCubes.push_back(cube);
+				cubeBounds.push_back(sphereBounds(glm::vec3(cube.position), CUBE_BOUNDING_RADIUS));
+			}
+		}
+	}
+	std::vector<Transform> previousCubes = currentCubes;
+	Bvh cubeBvh;
+	cubeBvh.build(cubeBounds);
+
+	StaticBatch staticBatch(FLOATS_PER_VERTEX, 8.0f);
+	StaticMesh cubeMesh = {cubeVertices.data(), cubeVertices.size() / FLOATS_PER_VERTEX};
+	for (int z = 0; z < STATIC_FIELD_SIZE; z++)
+	{
+		for (int x = 0; x < STATIC_FIELD_SIZE; x++)
+		{
+			staticBatch.add(cubeMesh, 0, glm::dvec3((x - STATIC_FIELD_SIZE / 2) * 1.5, -5.0, (z - STATIC_FIELD_SIZE / 2) * 1.5), glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+		}
+	}
+	staticBatch.build();
+
+	MeshData sphere = generateSphereMesh(SPHERE_RADIUS, 24, 48);
+	MeshArena meshArena(FLOATS_PER_VERTEX);
+	unsigned int sphereMesh = meshArena.add(sphere);
+	MeshletMesh sphereMeshlets(FLOATS_PER_VERTEX);
+	sphereMeshlets.build(sphere);
+	std::vector<MeshInstance> meshInstances;
+	std::vector<glm::dvec3> sphereField;
+	for (int z = 0; z < SPHERE_FIELD_SIZE; z++)
+	{
+		for (int x = 0; x < SPHERE_FIELD_SIZE; x++)
+		{
+			glm::dvec3 position((x - SPHERE_FIELD_SIZE / 2) * 8.0, 8.0, (z - SPHERE_FIELD_SIZE / 2) * 8.0);
+			sphereField.push_back(position);
+			meshInstances.push_back({sphereMesh, position + glm::dvec3(4.0, 0.0, 4.0), 0});
+		}
+	}
+
+	// 텍스처는 추가하지 않으므로 TextureManager 는 GL 을 쓰지 않는다, 밉 레벨 선택만 한다
+	TextureManager textures;
+	TextureStreamer streamer(textures);
+	for (const Transform &cube : currentCubes)
+	{
+		streamer.addInstance(0, 512, cube.position, CUBE_BOUNDING_RADIUS, 1.0f);
+		streamer.addInstance(1, 512, cube.position, CUBE_BOUNDING_RADIUS, 1.0f);
+	}
+
+	FrameScene scene;
+	scene.previousCubes = &previousCubes;
+	scene.currentCubes = &currentCubes;
+	scene.cubeBvh = &cubeBvh;
+	scene.cubeRadius = CUBE_BOUNDING_RADIUS;
+	for (size_t i = 0; i < cubeVertices.size(); i += FLOATS_PER_VERTEX)
+	{
+		scene.cubeOccluder.push_back(glm::vec3(cubeVertices[i], cubeVertices[i + 1], cubeVertices[i + 2]));
+	}
+	scene.staticBatch = &staticBatch;
+	scene.meshArena = &meshArena;
+	scene.meshInstances = &meshInstances;
+	scene.meshlets = &sphereMeshlets;
+	scene.meshletPositions = &sphereField;
+	scene.meshletRadius = SPHERE_RADIUS;
+	scene.streamer = &streamer;
+	scene.screenHeight = SCREEN_HEIGHT;
+	FrameBuilder builder(scene);
+
+	FrameArena arena(PACKET_COUNT, FRAME_ARENA_SIZE);
+	FramePacket packets[PACKET_COUNT] = {FramePacket(arena.getFrame(0)), FramePacket(arena.getFrame(1))};
+	unsigned long long allocations = 0;
+	size_t maxModels = 0;
+	size_t minModels = currentCubes.size();
+	for (unsigned long long frameIndex = 0; frameIndex < WARMUP_FRAMES + MEASURED_FRAMES; ++frameIndex)
+	{
+		unsigned long long start = getThreadAllocationCount();
+		// RenderThread::beginFrame 처럼 다음 패킷을 비우고 채운다
+		FramePacket &frame = packets[frameIndex % PACKET_COUNT];
+		frame.reset();
+		frame.frameIndex = frameIndex;
+		frame.camera = orbitCamera(frameIndex);
+		glm::mat4 projection = glm::perspective(glm::radians(frame.camera.Zoom), (float)SCREEN_WIDTH / SCREEN_HEIGHT, 0.1f, 100.0f);
+		builder.build(frame, projection, 0.5f);
+		if (frameIndex >= WARMUP_FRAMES)
+		{
+			allocations += getThreadAllocationCount() - start;
+		}
+		maxModels = std::max(maxModels, frame.models.size());
+		minModels = std::min(minModels, frame.models.size());
+	}
+	// 경로가 실제로 물체 수가 바뀌는 프레임을 지나가는지(컬링이 일을 하는지) 확인한다
+	bool varied = minModels < maxModels;
+	std::cout << (varied ? "PASS " : "FAIL ") << "visible cubes vary between " << minModels << " and " << maxModels << " of " << currentCubes.size() << std::endl;
+	bool passed = allocations == 0;
+	std::cout << (passed ? "PASS " : "FAIL ") << allocations << " heap allocations in " << MEASURED_FRAMES << " steady-state frames after " << WARMUP_FRAMES << " warmup frames" << std::endl;
+	arena.printStats();
+	builder.printStats();
+	return (passed && varied ? 0 : 1);
+}
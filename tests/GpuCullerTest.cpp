@@ -0,0 +1,152 @@
+#include "EmbeddedResources.h"
+#include "GpuCuller.h"
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <iostream>
+#include <vector>
+
+// GpuCuller 의 Hi-Z 검사 테스트, 보이지 않는 창의 기본 프레임버퍼에 가리개를 그리고 피라미드를 만든 뒤 인스턴스 하나씩 컬링한다
+// 높이가 2의 거듭제곱이 아니면(기본 창 900) 피라미드 레벨 크기가 floor(H / 2^L) 이므로, 홀수 레벨의 텍셀 경계에 걸친 틈으로만 보이는 물체가 남아야 한다
+// GL 4.3 컨텍스트를 만들 수 없으면(디스플레이가 없는 환경 포함) 77 을 반환하고 건너뛴다
+
+// 셰이더는 내장하지 않고 LEARNOPENGL_RESOURCE_DIR (tests/CMakeLists.txt) 의 소스 디렉터리에서 읽는다
+const EmbeddedResource EMBEDDED_RESOURCES[1] = {};
+const size_t EMBEDDED_RESOURCE_COUNT = 0;
+
+namespace
+{
+	const int WINDOW_WIDTH = 1600;
+	const int WINDOW_HEIGHT = 900;
+	const int SKIP_RETURN_CODE = 77;
+	// 가리개가 덮지 않는 행, 900 픽셀에서 레벨 3 (112 텍셀) 의 텍셀 100 은 픽셀 800 ~ 807 만 담고 있다
+	const int GAP_FIRST_ROW = 808;
+	const int GAP_LAST_ROW = 810;
+
+	int failures = 0;
+
+	void check(bool condition, const char *name)
+	{
+		std::cout << (condition ? "PASS " : "FAIL ") << name << std::endl;
+		if (!condition)
+		{
+			failures++;
+		}
+	}
+
+	// 가리개를 깊이 버퍼에 그리는 셰이더, 정점은 이미 NDC 이다
+	unsigned int createOccluderProgram()
+	{
+		const char *vertexCode = "#version 330 core\nlayout (location = 0) in vec3 aPos;\nvoid main()\n{\n\tgl_Position = vec4(aPos, 1.0);\n}\n";
+		const char *fragmentCode = "#version 330 core\nout vec4 FragColor;\nvoid main()\n{\n\tFragColor = vec4(1.0);\n}\n";
+		unsigned int vertex = glCreateShader(GL_VERTEX_SHADER);
+		glShaderSource(vertex, 1, &vertexCode, NULL);
+		glCompileShader(vertex);
+		unsigned int fragment = glCreateShader(GL_FRAGMENT_SHADER);
+		glShaderSource(fragment, 1, &fragmentCode, NULL);
+		glCompileShader(fragment);
+		unsigned int program = glCreateProgram();
+		glAttachShader(program, vertex);
+		glAttachShader(program, fragment);
+		glLinkProgram(program);
+		glDeleteShader(vertex);
+		glDeleteShader(fragment);
+		return (program);
+	}
+
+	void addQuad(std::vector<glm::vec3> &vertices, float left, float bottom, float right, float top, float z)
+	{
+		glm::vec3 corners[] = {glm::vec3(left, bottom, z), glm::vec3(right, bottom, z), glm::vec3(right, top, z), glm::vec3(left, top, z)};
+		int order[] = {0, 1, 2, 0, 2, 3};
+		for (int index : order)
+		{
+			vertices.push_back(corners[index]);
+		}
+	}
+
+	// 중심이 (pixelX, pixelY) 픽셀, 반지름이 radiusPixels 픽셀인 인스턴스 하나를 컬링하고 남았는지 반환한다
+	// 투영은 가로를 height / width 배로 줄이기만 해서, 카메라 기준 좌표의 길이가 가로 세로 같은 픽셀 수가 되게 한다
+	// 그래야 화면 사각형의 크기가 세로 반지름으로 정해지고, 고른 피라미드 레벨에서 틈이 텍셀 경계에 걸린다
+	bool cullsVisible(GpuCuller &culler, const glm::mat4 &projection, int width, int height, float pixelX, float pixelY, float radiusPixels)
+	{
+		glm::vec3 center((pixelX / width * 2.0f - 1.0f) * width / height, pixelY / height * 2.0f - 1.0f, 0.5f);
+		glm::mat4 model = glm::translate(glm::mat4(1.0f), center);
+		culler.cull(&model, 1, radiusPixels / height * 2.0f, projection, glm::mat4(1.0f), glm::dvec3(0.0), 36);
+		return (culler.readVisibleCount() == 1);
+	}
+}
+
+int main()
+{
+	if (!glfwInit())
+	{
+		std::cout << "GLFW could not be initialized, skipping" << std::endl;
+		return (SKIP_RETURN_CODE);
+	}
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+	GLFWwindow *window = glfwCreateWindow(WINDOW_WIDTH, WINDOW_HEIGHT, "GpuCullerTest", NULL, NULL);
+	if (window == NULL)
+	{
+		std::cout << "OpenGL 4.3 context is not available, skipping" << std::endl;
+		glfwTerminate();
+		return (SKIP_RETURN_CODE);
+	}
+	glfwMakeContextCurrent(window);
+	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress) || !GpuCuller::isSupported())
+	{
+		std::cout << "OpenGL 4.3 is not supported, skipping" << std::endl;
+		glfwTerminate();
+		return (SKIP_RETURN_CODE);
+	}
+	int width = 0;
+	int height = 0;
+	glfwGetFramebufferSize(window, &width, &height);
+	std::cout << "Framebuffer " << width << "x" << height << std::endl;
+
+	{
+		GpuCuller culler;
+		// 깊이 0.5 의 가리개가 틈 행을 빼고 화면 전체를 덮는다
+		std::vector<glm::vec3> occluder;
+		auto ndcY = [height](float pixel)
+		{
+			return (pixel / height * 2.0f - 1.0f);
+		};
+		addQuad(occluder, -1.0f, -1.0f, 1.0f, ndcY((float)GAP_FIRST_ROW), 0.0f);
+		addQuad(occluder, -1.0f, ndcY((float)(GAP_LAST_ROW + 1)), 1.0f, 1.0f, 0.0f);
+		unsigned int program = createOccluderProgram();
+		unsigned int VAO = 0;
+		unsigned int VBO = 0;
+		glGenVertexArrays(1, &VAO);
+		glBindVertexArray(VAO);
+		glGenBuffers(1, &VBO);
+		glBindBuffer(GL_ARRAY_BUFFER, VBO);
+		glBufferData(GL_ARRAY_BUFFER, occluder.size() * sizeof(glm::vec3), occluder.data(), GL_STATIC_DRAW);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void *)0);
+		glEnableVertexAttribArray(0);
+
+		glViewport(0, 0, width, height);
+		glEnable(GL_DEPTH_TEST);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		glUseProgram(program);
+		glDrawArrays(GL_TRIANGLES, 0, (GLsizei)occluder.size());
+		glm::mat4 projection = glm::scale(glm::mat4(1.0f), glm::vec3((float)height / width, 1.0f, 1.0f));
+		culler.buildDepthPyramid(width, height, projection, glm::dvec3(0.0));
+
+		// 픽셀 803.5 ~ 810.5 를 덮는 물체는 틈(808 ~ 810) 으로만 보인다
+		check(cullsVisible(culler, projection, width, height, width * 0.5f, 807.0f, 3.5f), "object visible only through a gap on an odd pyramid level edge is kept");
+		check(!cullsVisible(culler, projection, width, height, width * 0.5f, 400.0f, 3.5f), "object fully behind the occluder is culled");
+		check(!cullsVisible(culler, projection, width, height, width * 0.5f, 600.0f, 40.0f), "large object fully behind the occluder is culled");
+
+		glDeleteBuffers(1, &VBO);
+		glDeleteVertexArrays(1, &VAO);
+		glDeleteProgram(program);
+		culler.clear();
+	}
+	glfwTerminate();
+	return (failures == 0 ? 0 : 1);
+}
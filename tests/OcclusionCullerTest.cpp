@@ -0,0 +1,112 @@
+#include "OcclusionCuller.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <iostream>
+#include <vector>
+
+// OcclusionCuller 의 동작 테스트, 같은 소스를 스칼라 / SSE2 / AVX2 경로로 따로 빌드해서 돌린다 (tests/CMakeLists.txt)
+// 실패한 검사를 모두 출력하고 하나라도 실패하면 1 을 반환한다
+
+namespace
+{
+	const int BUFFER_WIDTH = 128;
+	const int BUFFER_HEIGHT = 64;
+	// CPU 가 AVX2 를 지원하지 않으면 건너뛴다, CTest 의 SKIP_RETURN_CODE 와 같아야 한다
+	const int SKIP_RETURN_CODE = 77;
+
+	int failures = 0;
+
+	void check(bool condition, const char *name)
+	{
+		std::cout << (condition ? "PASS " : "FAIL ") << name << std::endl;
+		if (!condition)
+		{
+			failures++;
+		}
+	}
+
+	// z 평면 위의 사각형 하나를 삼각형 두 개로 만든다
+	std::vector<glm::vec3> quad(const glm::vec3 &a, const glm::vec3 &b, const glm::vec3 &c, const glm::vec3 &d)
+	{
+		return (std::vector<glm::vec3>{a, b, c, a, c, d});
+	}
+
+	Aabb box(const glm::vec3 &min, const glm::vec3 &max)
+	{
+		Aabb result;
+		result.min = min;
+		result.max = max;
+		return (result);
+	}
+
+	// 원점에서 -z 방향을 보는 카메라, 화면 비율은 버퍼와 같다
+	glm::mat4 cameraProjection()
+	{
+		return (glm::perspective(glm::radians(60.0f), (float)BUFFER_WIDTH / (float)BUFFER_HEIGHT, 0.1f, 100.0f));
+	}
+
+	void testHiddenBehindOccluder()
+	{
+		OcclusionCuller culler(BUFFER_WIDTH, BUFFER_HEIGHT);
+		glm::mat4 viewProjection = cameraProjection();
+		std::vector<glm::vec3> wall = quad(glm::vec3(-2.0f, -2.0f, -5.0f), glm::vec3(2.0f, -2.0f, -5.0f), glm::vec3(2.0f, 2.0f, -5.0f), glm::vec3(-2.0f, 2.0f, -5.0f));
+		culler.addOccluder(viewProjection, wall.data(), wall.size());
+		check(!culler.isVisible(viewProjection, box(glm::vec3(-0.5f, -0.5f, -11.0f), glm::vec3(0.5f, 0.5f, -10.0f))), "box fully behind the occluder is hidden");
+		check(culler.isVisible(viewProjection, box(glm::vec3(-0.5f, -0.5f, -4.0f), glm::vec3(0.5f, 0.5f, -3.0f))), "box in front of the occluder is visible");
+	}
+
+	void testPartiallyVisible()
+	{
+		OcclusionCuller culler(BUFFER_WIDTH, BUFFER_HEIGHT);
+		glm::mat4 viewProjection = cameraProjection();
+		std::vector<glm::vec3> wall = quad(glm::vec3(-2.0f, -2.0f, -5.0f), glm::vec3(2.0f, -2.0f, -5.0f), glm::vec3(2.0f, 2.0f, -5.0f), glm::vec3(-2.0f, 2.0f, -5.0f));
+		culler.addOccluder(viewProjection, wall.data(), wall.size());
+		// 벽의 오른쪽 가장자리(z = -10 에서 x = 4) 에 걸친 박스
+		check(culler.isVisible(viewProjection, box(glm::vec3(3.0f, -0.5f, -10.5f), glm::vec3(5.0f, 0.5f, -10.0f))), "box sticking out past the occluder edge is visible");
+	}
+
+	void testNearPlane()
+	{
+		OcclusionCuller culler(BUFFER_WIDTH, BUFFER_HEIGHT);
+		glm::mat4 viewProjection = cameraProjection();
+		// 카메라 뒤(z = 1) 에서 앞(z = -8) 으로 기울어진 벽, 근평면에서 잘린 뒤에도 화면 중앙을 덮어야 한다
+		std::vector<glm::vec3> wall = quad(glm::vec3(-40.0f, -20.0f, 1.0f), glm::vec3(40.0f, -20.0f, 1.0f), glm::vec3(40.0f, 20.0f, -8.0f), glm::vec3(-40.0f, 20.0f, -8.0f));
+		culler.addOccluder(viewProjection, wall.data(), wall.size());
+		check(!culler.isVisible(viewProjection, box(glm::vec3(-0.5f, -0.5f, -21.0f), glm::vec3(0.5f, 0.5f, -20.0f))), "occluder clipped by the near plane still hides a box behind it");
+		// 근평면에 걸친 박스는 화면 사각형을 구할 수 없으므로 보인다고 판단해야 한다
+		check(culler.isVisible(viewProjection, box(glm::vec3(-0.5f, -0.5f, -0.5f), glm::vec3(0.5f, 0.5f, 0.5f))), "box crossing the near plane is visible");
+	}
+
+	void testPixelCenterEdge()
+	{
+		// 단위 행렬이면 NDC 가 그대로 화면이 되므로 픽셀 단위로 가장자리를 정할 수 있다
+		OcclusionCuller culler(BUFFER_WIDTH, BUFFER_HEIGHT);
+		glm::mat4 identity(1.0f);
+		auto ndcX = [](float pixel)
+		{
+			return (pixel / BUFFER_WIDTH * 2.0f - 1.0f);
+		};
+		// 가리개 오른쪽 가장자리가 x = 10.6 픽셀, 픽셀 10 의 중심(10.5) 은 덮이지만 픽셀의 오른쪽 부분은 비어 있다
+		std::vector<glm::vec3> wall = quad(glm::vec3(-1.0f, -1.0f, 0.0f), glm::vec3(ndcX(10.6f), -1.0f, 0.0f), glm::vec3(ndcX(10.6f), 1.0f, 0.0f), glm::vec3(-1.0f, 1.0f, 0.0f));
+		culler.addOccluder(identity, wall.data(), wall.size());
+		check(!culler.isVisible(identity, box(glm::vec3(ndcX(2.0f), -0.5f, 0.5f), glm::vec3(ndcX(9.0f), 0.5f, 0.6f))), "box well inside the occluder is hidden");
+		check(culler.isVisible(identity, box(glm::vec3(ndcX(10.7f), -0.5f, 0.5f), glm::vec3(ndcX(10.9f), 0.5f, 0.6f))), "box in the uncovered part of an edge pixel is visible");
+	}
+}
+
+int main()
+{
+#if defined(__AVX2__) && defined(__GNUC__)
+	if (!__builtin_cpu_supports("avx2"))
+	{
+		std::cout << "AVX2 is not supported on this CPU, skipping" << std::endl;
+		return (SKIP_RETURN_CODE);
+	}
+#endif
+	testHiddenBehindOccluder();
+	testPartiallyVisible();
+	testNearPlane();
+	testPixelCenterEdge();
+	return (failures == 0 ? 0 : 1);
+}